@@ -0,0 +1,59 @@
+#include "Allocations.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Number of allocations from the heap
+static std::atomic<uint64_t> allocations{0};
+
+void * operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void * p = std::malloc(size == 0 ? 1 : size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void * p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void * operator new(size_t size, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    void * p     = std::aligned_alloc(align, (size + align - 1) / align * align);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void * p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void * p, size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+uint64_t allocationCount()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void reportAllocations(benchmark::State & state, uint64_t start)
+{
+    double count                = static_cast<double>(allocationCount() - start);
+    state.counters["allocs/op"] = benchmark::Counter(count, benchmark::Counter::kAvgIterations);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+// Counts the allocations made with the global operator new, so that benchmarks can report allocations per operation alongside
+// time. Allocations served by class-specific allocators (such as NimState's pool) are not counted unless they fall back to the
+// global operator new.
+
+// Returns the number of allocations made so far.
+uint64_t allocationCount();
+
+// Sets the "allocs/op" counter of a benchmark, given the allocation count before the benchmark loop started.
+void reportAllocations(benchmark::State & state, uint64_t start);
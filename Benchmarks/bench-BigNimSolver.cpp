@@ -0,0 +1,63 @@
+#include "Allocations.h"
+
+#include <benchmark/benchmark.h>
+
+#include "Components/BigBoard.h"
+#include "Components/Rules.h"
+#include "ComputerPlayer/BigNimSolver.h"
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Returns a board with the given number of heaps of random sizes.
+static BigBoard randomBoard(int64_t heaps)
+{
+    std::mt19937_64       rng(heaps);
+    std::vector<uint64_t> sizes(static_cast<size_t>(heaps));
+    for (uint64_t & n : sizes)
+    {
+        n = rng();
+    }
+    return BigBoard(std::move(sizes));
+}
+
+static void BM_BigNimSolver_WinningMove(benchmark::State & state, Rules::Variation variation)
+{
+    BigNimSolver solver(Rules(variation, 4));
+    BigBoard     board = randomBoard(state.range(0));
+    uint64_t     start = allocationCount();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(solver.winningMove(board));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    reportAllocations(state, start);
+}
+
+static void BM_BigBoard_Read(benchmark::State & state)
+{
+    BigBoard           board = randomBoard(state.range(0));
+    std::ostringstream out;
+    for (uint64_t n : board)
+    {
+        out << n << '\n';
+    }
+    std::string text  = out.str();
+    uint64_t    start = allocationCount();
+    for (auto _ : state)
+    {
+        std::istringstream in(text);
+        benchmark::DoNotOptimize(BigBoard::read(in));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+    reportAllocations(state, start);
+}
+
+BENCHMARK_CAPTURE(BM_BigNimSolver_WinningMove, normal, Rules::Variation::NORMAL)->Arg(10000)->Arg(1000000);
+BENCHMARK_CAPTURE(BM_BigNimSolver_WinningMove, misere, Rules::Variation::MISERE)->Arg(10000)->Arg(1000000);
+BENCHMARK_CAPTURE(BM_BigNimSolver_WinningMove, subtract, Rules::Variation::SUBTRACT)->Arg(10000)->Arg(1000000);
+BENCHMARK(BM_BigBoard_Read)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,51 @@
+#include "Allocations.h"
+
+#include <benchmark/benchmark.h>
+
+#include "Components/Board.h"
+
+#include <cstdint>
+#include <vector>
+
+static void BM_Board_NimSum(benchmark::State & state, std::vector<int8_t> heaps)
+{
+    Board    board(heaps);
+    uint64_t start = allocationCount();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(board);
+        benchmark::DoNotOptimize(board.nimSum());
+    }
+    reportAllocations(state, start);
+}
+
+static void BM_Board_Count(benchmark::State & state, std::vector<int8_t> heaps)
+{
+    Board    board(heaps);
+    uint64_t start = allocationCount();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(board);
+        benchmark::DoNotOptimize(board.count());
+    }
+    reportAllocations(state, start);
+}
+
+static void BM_Board_Empty(benchmark::State & state, std::vector<int8_t> heaps)
+{
+    Board    board(heaps);
+    uint64_t start = allocationCount();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(board);
+        benchmark::DoNotOptimize(board.empty());
+    }
+    reportAllocations(state, start);
+}
+
+BENCHMARK_CAPTURE(BM_Board_NimSum, 1_3_5_7_9, {1, 3, 5, 7, 9});
+BENCHMARK_CAPTURE(BM_Board_NimSum, 26x99, std::vector<int8_t>(26, 99));
+BENCHMARK_CAPTURE(BM_Board_Count, 1_3_5_7_9, {1, 3, 5, 7, 9});
+BENCHMARK_CAPTURE(BM_Board_Count, 26x99, std::vector<int8_t>(26, 99));
+BENCHMARK_CAPTURE(BM_Board_Empty, 1_3_5_7_9, {1, 3, 5, 7, 9});
+BENCHMARK_CAPTURE(BM_Board_Empty, 26x99, std::vector<int8_t>(26, 99));
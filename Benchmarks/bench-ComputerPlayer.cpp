@@ -0,0 +1,117 @@
+#include "Allocations.h"
+
+#include <benchmark/benchmark.h>
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "ComputerPlayer/ComputerPlayer.h"
+#include "ComputerPlayer/NimEvaluator.h"
+#include "ComputerPlayer/NimSearch.h"
+#include "NimState/NimState.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// A representative position
+struct Position
+{
+    std::vector<int8_t> heaps;        // Heap sizes
+    Rules::Variation    variation;    // Variation of the game
+    int                 removalLimit; // Maximum number of objects removed in the subtraction variation
+};
+
+static Position const START{{1, 3, 5, 7, 9}, Rules::Variation::MISERE, 0};
+static Position const WIDE{std::vector<int8_t>(26, 99), Rules::Variation::NORMAL, 0};
+static Position const SUBTRACT{{99}, Rules::Variation::SUBTRACT, 10};
+static Position const SUBTRACT_HEAPS{{99, 87, 64, 50, 33, 21}, Rules::Variation::SUBTRACT, 10};
+
+static Rules makeRules(Position const & position)
+{
+    return (position.variation == Rules::Variation::SUBTRACT) ? Rules(position.variation, position.removalLimit)
+                                                              : Rules(position.variation);
+}
+
+static void BM_ComputerPlayer_ResponseGenerator(benchmark::State & state, Position position)
+{
+    Rules          rules = makeRules(position);
+    ComputerPlayer player(NimState::PlayerId::FIRST, rules);
+    NimState       nimState(Board(position.heaps), rules);
+    uint64_t       start = allocationCount();
+    for (auto _ : state)
+    {
+        std::vector<GamePlayer::GameState *> responses = player.responseGenerator(nimState, 0);
+        benchmark::DoNotOptimize(responses.data());
+        for (auto * response : responses)
+        {
+            delete response;
+        }
+    }
+    reportAllocations(state, start);
+}
+
+static void BM_NimEvaluator_Evaluate(benchmark::State & state, Position position)
+{
+    Rules        rules = makeRules(position);
+    NimEvaluator evaluator(rules);
+    NimState     nimState(Board(position.heaps), rules);
+    nimState.move(0, 1);
+    uint64_t start = allocationCount();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(evaluator.evaluate(nimState));
+    }
+    reportAllocations(state, start);
+}
+
+// Measures a complete move by a new computer player. The player is created outside of the timing, so that its transposition
+// table starts out empty but the time to allocate it is not included. Its allocations are still counted.
+static void BM_ComputerPlayer_Move(benchmark::State & state, Position position, ComputerPlayer::Engine engine, int depth)
+{
+    Rules               rules = makeRules(position);
+    NimState            root(Board(position.heaps), rules);
+    NimSearch::Settings settings;
+    settings.maxDepth = depth;
+    uint64_t start    = allocationCount();
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto     player = std::make_unique<ComputerPlayer>(NimState::PlayerId::FIRST, rules, engine, settings);
+        NimState nimState(root);
+        state.ResumeTiming();
+        player->move(&nimState);
+        benchmark::DoNotOptimize(nimState);
+        state.PauseTiming();
+        player.reset();
+        state.ResumeTiming();
+    }
+    reportAllocations(state, start);
+}
+
+BENCHMARK_CAPTURE(BM_ComputerPlayer_ResponseGenerator, 1_3_5_7_9, START);
+BENCHMARK_CAPTURE(BM_ComputerPlayer_ResponseGenerator, 26x99, WIDE);
+BENCHMARK_CAPTURE(BM_ComputerPlayer_ResponseGenerator, subtract_99_10, SUBTRACT);
+
+BENCHMARK_CAPTURE(BM_NimEvaluator_Evaluate, 1_3_5_7_9, START);
+BENCHMARK_CAPTURE(BM_NimEvaluator_Evaluate, 26x99, WIDE);
+BENCHMARK_CAPTURE(BM_NimEvaluator_Evaluate, subtract_99_10, SUBTRACT);
+BENCHMARK_CAPTURE(BM_NimEvaluator_Evaluate, subtract_6_heaps_10, SUBTRACT_HEAPS);
+
+BENCHMARK_CAPTURE(BM_ComputerPlayer_Move, 1_3_5_7_9_search, START, ComputerPlayer::Engine::SEARCH, 10)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ComputerPlayer_Move, 1_3_5_7_9_in_place, START, ComputerPlayer::Engine::IN_PLACE, 10)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ComputerPlayer_Move, 1_3_5_7_9_solver, START, ComputerPlayer::Engine::SOLVER, 10)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ComputerPlayer_Move, 26x99_search, WIDE, ComputerPlayer::Engine::SEARCH, 2)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ComputerPlayer_Move, 26x99_in_place, WIDE, ComputerPlayer::Engine::IN_PLACE, 3)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ComputerPlayer_Move, 26x99_solver, WIDE, ComputerPlayer::Engine::SOLVER, 10)
+    ->Unit(benchmark::kMicrosecond);
+
+// The subtraction variation is always played by the solver
+BENCHMARK_CAPTURE(BM_ComputerPlayer_Move, subtract_99_10_solver, SUBTRACT, ComputerPlayer::Engine::SOLVER, 10)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ComputerPlayer_Move, subtract_6_heaps_10_solver, SUBTRACT_HEAPS, ComputerPlayer::Engine::SOLVER, 10)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,56 @@
+#include "Allocations.h"
+
+#include <benchmark/benchmark.h>
+
+#include "Components/GrundyTable.h"
+
+#include <cstdint>
+#include <vector>
+
+// Subtraction sets of different sizes and periods
+static std::vector<int> const RANGE{1, 2, 3, 4};
+static std::vector<int> const SMALL{1, 3, 4};
+static std::vector<int> const SPREAD{2, 5, 7};
+static std::vector<int> const SQUARES{1, 4, 9, 16, 25, 36, 49, 64, 81, 100, 121};
+static std::vector<int> const WIDE{3, 17, 64, 65, 130, 200, 255};
+
+// Computes the table, until the period is found
+static void BM_GrundyTable_Build(benchmark::State & state, std::vector<int> const & set)
+{
+    uint64_t start  = allocationCount();
+    int      length = 0;
+    for (auto _ : state)
+    {
+        GrundyTable table(set);
+        length = table.preperiod() + table.period();
+        benchmark::DoNotOptimize(length);
+    }
+    state.counters["values"] = static_cast<double>(length);
+    reportAllocations(state, start);
+}
+
+// Looks up the values of a million consecutive heap sizes, most of them past the end of the table
+static void BM_GrundyTable_Value(benchmark::State & state, std::vector<int> const & set)
+{
+    GrundyTable table(set);
+    uint64_t    start = allocationCount();
+    for (auto _ : state)
+    {
+        int sum = 0;
+        for (uint64_t n = 0; n < 1000000; ++n)
+        {
+            sum ^= table.value(n);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 1000000);
+    reportAllocations(state, start);
+}
+
+BENCHMARK_CAPTURE(BM_GrundyTable_Build, range, RANGE);
+BENCHMARK_CAPTURE(BM_GrundyTable_Build, small, SMALL);
+BENCHMARK_CAPTURE(BM_GrundyTable_Build, spread, SPREAD);
+BENCHMARK_CAPTURE(BM_GrundyTable_Build, squares, SQUARES);
+BENCHMARK_CAPTURE(BM_GrundyTable_Build, wide, WIDE);
+BENCHMARK_CAPTURE(BM_GrundyTable_Value, small, SMALL);
+BENCHMARK_CAPTURE(BM_GrundyTable_Value, wide, WIDE);
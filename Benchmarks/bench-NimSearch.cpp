@@ -0,0 +1,81 @@
+#include "Allocations.h"
+
+#include <benchmark/benchmark.h>
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "ComputerPlayer/NimSearch.h"
+#include "NimState/NimState.h"
+
+#include <vector>
+
+// Measures how a search scales with the number of threads. Each iteration uses a new search so that the transposition tables
+// start out empty.
+static void BM_NimSearch_Threads(benchmark::State & state, std::vector<int8_t> heaps, Rules::Variation variation, int depth)
+{
+    Rules    rules(variation);
+    NimState root(Board(heaps), rules);
+    int      threads = static_cast<int>(state.range(0));
+    uint64_t nodes   = 0;
+    uint64_t start   = allocationCount();
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        NimSearch search(rules, NimSearch::Settings{depth, 16, threads});
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(search.findBestMove(root));
+        nodes += search.nodesSearched();
+    }
+    state.counters["nodes"]   = benchmark::Counter(double(nodes), benchmark::Counter::kAvgIterations);
+    state.counters["nodes/s"] = benchmark::Counter(double(nodes), benchmark::Counter::kIsRate);
+    reportAllocations(state, start);
+}
+
+BENCHMARK_CAPTURE(BM_NimSearch_Threads, 1_3_5_7_9, {1, 3, 5, 7, 9}, Rules::Variation::MISERE, 10)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_NimSearch_Threads, 8_heaps, {11, 12, 13, 14, 15, 16, 17, 18}, Rules::Variation::NORMAL, 5)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Measures the number of nodes searched with and without the winning-reply and killer stages of move ordering
+static void BM_NimSearch_Ordering(benchmark::State & state, std::vector<int8_t> heaps, Rules::Variation variation, int depth)
+{
+    Rules               rules(variation);
+    NimState            root(Board(heaps), rules);
+    NimSearch::Settings settings{depth, 16, 1};
+    settings.moveOrdering = state.range(0) != 0;
+    uint64_t nodes        = 0;
+    uint64_t start        = allocationCount();
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        NimSearch search(rules, settings);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(search.findBestMove(root));
+        nodes += search.nodesSearched();
+    }
+    state.counters["nodes"] = benchmark::Counter(double(nodes), benchmark::Counter::kAvgIterations);
+    reportAllocations(state, start);
+}
+
+BENCHMARK_CAPTURE(BM_NimSearch_Ordering, 1_3_5_7_9_misere, {1, 3, 5, 7, 9}, Rules::Variation::MISERE, 10)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_NimSearch_Ordering, 1_3_5_7_9_normal, {1, 3, 5, 7, 9}, Rules::Variation::NORMAL, 10)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_NimSearch_Ordering, 8_heaps, {11, 12, 13, 14, 15, 16, 17, 18}, Rules::Variation::NORMAL, 5)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_NimSearch_Ordering, subtract, {99}, Rules::Variation::SUBTRACT, 20)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
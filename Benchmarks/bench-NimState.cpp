@@ -0,0 +1,61 @@
+#include "Allocations.h"
+
+#include <benchmark/benchmark.h>
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "NimState/NimState.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Measures a move followed by its undo, which is how the in-place search walks the tree
+static void BM_NimState_Move(benchmark::State & state, std::vector<int8_t> heaps, Rules::Variation variation)
+{
+    Rules    rules(variation);
+    NimState nimState(Board(heaps), rules);
+    uint64_t start = allocationCount();
+    for (auto _ : state)
+    {
+        NimState::Undo undo = nimState.move(0, 1);
+        benchmark::DoNotOptimize(nimState);
+        nimState.undo(undo);
+    }
+    reportAllocations(state, start);
+}
+
+// Measures a copy on the stack
+static void BM_NimState_Copy(benchmark::State & state, std::vector<int8_t> heaps, Rules::Variation variation)
+{
+    Rules    rules(variation);
+    NimState nimState(Board(heaps), rules);
+    uint64_t start = allocationCount();
+    for (auto _ : state)
+    {
+        NimState copy(nimState);
+        benchmark::DoNotOptimize(copy);
+    }
+    reportAllocations(state, start);
+}
+
+// Measures a copy on the heap, which is how the game tree creates its responses
+static void BM_NimState_New(benchmark::State & state, std::vector<int8_t> heaps, Rules::Variation variation)
+{
+    Rules    rules(variation);
+    NimState nimState(Board(heaps), rules);
+    uint64_t start = allocationCount();
+    for (auto _ : state)
+    {
+        std::unique_ptr<NimState> copy(new NimState(nimState));
+        benchmark::DoNotOptimize(copy);
+    }
+    reportAllocations(state, start);
+}
+
+BENCHMARK_CAPTURE(BM_NimState_Move, 1_3_5_7_9, {1, 3, 5, 7, 9}, Rules::Variation::MISERE);
+BENCHMARK_CAPTURE(BM_NimState_Move, 26x99, std::vector<int8_t>(26, 99), Rules::Variation::MISERE);
+BENCHMARK_CAPTURE(BM_NimState_Copy, 1_3_5_7_9, {1, 3, 5, 7, 9}, Rules::Variation::MISERE);
+BENCHMARK_CAPTURE(BM_NimState_Copy, 26x99, std::vector<int8_t>(26, 99), Rules::Variation::MISERE);
+BENCHMARK_CAPTURE(BM_NimState_New, 1_3_5_7_9, {1, 3, 5, 7, 9}, Rules::Variation::MISERE);
+BENCHMARK_CAPTURE(BM_NimState_New, 26x99, std::vector<int8_t>(26, 99), Rules::Variation::MISERE);
@@ -0,0 +1,101 @@
+#include "Allocations.h"
+
+#include <benchmark/benchmark.h>
+
+#include "Components/OctalGame.h"
+
+#include <cstdint>
+#include <vector>
+
+// Kayles and Dawson's chess are periodic after a few hundred values, and 0.16 is not periodic for over 250000 values
+static char const KAYLES[] = "0.77";
+static char const DAWSON[] = "0.137";
+static char const LONG[]   = "0.16";
+
+// Number of values computed when the sequence is not proven to be periodic sooner
+static uint64_t const LIMIT = 100000;
+
+// Computes the values, until the period is found or LIMIT values are known
+static void BM_OctalGame_Build(benchmark::State & state, char const * code)
+{
+    uint64_t start  = allocationCount();
+    uint64_t length = 0;
+    for (auto _ : state)
+    {
+        OctalGame game(code, LIMIT);
+        length = game.isPeriodic() ? game.preperiod() + game.period() : LIMIT;
+        benchmark::DoNotOptimize(length);
+    }
+    state.counters["values"] = static_cast<double>(length);
+    reportAllocations(state, start);
+}
+
+// Computes the first state.range(0) values one split at a time, as the baseline for the build
+static void BM_OctalGame_Naive(benchmark::State & state, char const * code)
+{
+    std::vector<int> digits{0};
+    for (char const * c = code + 2; *c != '\0'; ++c)
+    {
+        digits.push_back(*c - '0');
+    }
+    int const count = static_cast<int>(state.range(0));
+    int const t     = static_cast<int>(digits.size()) - 1;
+
+    for (auto _ : state)
+    {
+        std::vector<int>  values{0};
+        std::vector<bool> reachable;
+        for (int n = 1; n < count; ++n)
+        {
+            reachable.assign(2 * n + 2, false);
+            for (int k = 1; k <= t && k <= n; ++k)
+            {
+                int rest = n - k;
+                if ((digits[k] & 1) && rest == 0)
+                    reachable[0] = true;
+                if ((digits[k] & 2) && rest > 0)
+                    reachable[values[rest]] = true;
+                if (digits[k] & 4)
+                {
+                    for (int a = 1; 2 * a <= rest; ++a)
+                    {
+                        reachable[values[a] ^ values[rest - a]] = true;
+                    }
+                }
+            }
+            int g = 0;
+            while (reachable[g])
+            {
+                ++g;
+            }
+            values.push_back(g);
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.counters["values"] = static_cast<double>(count);
+}
+
+// Looks up the values of a million consecutive heap sizes, most of them past the end of the table
+static void BM_OctalGame_Value(benchmark::State & state, char const * code)
+{
+    OctalGame game(code);
+    uint64_t  start = allocationCount();
+    for (auto _ : state)
+    {
+        int sum = 0;
+        for (uint64_t n = 0; n < 1000000; ++n)
+        {
+            sum ^= game.value(n);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 1000000);
+    reportAllocations(state, start);
+}
+
+BENCHMARK_CAPTURE(BM_OctalGame_Build, kayles, KAYLES);
+BENCHMARK_CAPTURE(BM_OctalGame_Build, dawson, DAWSON);
+BENCHMARK_CAPTURE(BM_OctalGame_Build, long, LONG)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_OctalGame_Naive, long, LONG)->Arg(10000)->Arg(20000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_OctalGame_Value, kayles, KAYLES);
+BENCHMARK_CAPTURE(BM_OctalGame_Value, dawson, DAWSON);
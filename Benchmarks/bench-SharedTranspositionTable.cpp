@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "ComputerPlayer/NimSearch.h"
+#include "ComputerPlayer/NimTranspositionTable.h"
+#include "ComputerPlayer/SharedTranspositionTable.h"
+#include "NimState/NimState.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Memory budget of each thread's table. The shared table is as large as all of them together.
+static size_t const TABLE_BYTES = 4 * 1024 * 1024;
+
+// The table shared by the threads of a benchmark, which starts out empty like the tables of their own
+static std::shared_ptr<SharedTranspositionTable> sharedTable;
+
+// Creates the shared table before a benchmark's threads start.
+static void createSharedTable(benchmark::State const & state)
+{
+    sharedTable = std::make_shared<SharedTranspositionTable>(TABLE_BYTES * state.threads());
+}
+
+// Destroys the shared table after a benchmark's threads finish.
+static void destroySharedTable(benchmark::State const &)
+{
+    sharedTable.reset();
+}
+
+// Probes and stores a state picked at random from a working set, the way a search does: a probe, and then a store if it missed.
+template <typename Table>
+static void probeAndStore(benchmark::State & state, Table & table)
+{
+    uint64_t random = 0x9e3779b97f4a7c15ull * (state.thread_index() + 1);
+    uint64_t hits   = 0;
+    for (auto _ : state)
+    {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        uint64_t fingerprint = (random % 200000) * 0x100000001b3ull;
+        auto     entry       = table.probe(fingerprint);
+        if (entry)
+            ++hits;
+        else
+            table.store(fingerprint, 0.5f, 3, NimTranspositionTable::Bound::EXACT, 5, 2);
+    }
+    state.counters["hit rate"] = benchmark::Counter(double(hits) / double(state.iterations()), benchmark::Counter::kAvgThreads);
+    state.counters["ops/s"]    = benchmark::Counter(double(state.iterations()), benchmark::Counter::kIsRate);
+}
+
+// Each thread has a table of its own, as each player does
+static void BM_TranspositionTable_Own(benchmark::State & state)
+{
+    NimTranspositionTable table(TABLE_BYTES);
+    probeAndStore(state, table);
+}
+
+// Every thread uses the same table
+static void BM_TranspositionTable_Shared(benchmark::State & state)
+{
+    probeAndStore(state, *sharedTable);
+}
+
+BENCHMARK(BM_TranspositionTable_Own)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_TranspositionTable_Shared)
+    ->Setup(createSharedTable)
+    ->Teardown(destroySharedTable)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// Each thread is a player that searches the same positions over and over, as the players of many games do. The players use
+// tables of their own (range 0) or one shared table (range 1), with the same memory in total.
+static void BM_NimSearch_Players(benchmark::State & state)
+{
+    Rules               rules(Rules::Variation::MISERE);
+    NimSearch::Settings settings{8, TABLE_BYTES / (1024 * 1024), 1};
+    if (state.range(0) != 0)
+        settings.sharedTable = sharedTable;
+    NimSearch search(rules, settings);
+
+    std::vector<NimState> positions;
+    for (Board const & board : {Board({1, 3, 5, 7, 9}), Board({2, 4, 6, 8}), Board({3, 5, 7, 9}), Board({1, 2, 3, 4, 5, 6})})
+    {
+        positions.emplace_back(board, rules);
+    }
+
+    uint64_t nodes = 0;
+    size_t   next  = state.thread_index();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(search.findBestMove(positions[next++ % positions.size()]));
+        nodes += search.nodesSearched();
+    }
+    state.counters["nodes"]   = benchmark::Counter(double(nodes), benchmark::Counter::kAvgIterations);
+    state.counters["moves/s"] = benchmark::Counter(double(state.iterations()), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_NimSearch_Players)
+    ->Setup(createSharedTable)
+    ->Teardown(destroySharedTable)
+    ->ArgName("shared")
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
@@ -0,0 +1,118 @@
+#include "Allocations.h"
+
+#include <benchmark/benchmark.h>
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "NimState/NimState.h"
+#include "NimState/ZHash.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Statistics of a search with a transposition table
+struct SearchStats
+{
+    int64_t nodes  = 0; // Number of nodes expanded
+    int64_t probes = 0; // Number of transposition table probes
+    int64_t hits   = 0; // Number of transposition table hits
+};
+
+// Expands every node to the given depth, except nodes which are already in the (unbounded) transposition table with at least
+// the same depth. The search is exhaustive, so the number of nodes expanded depends only on how well the fingerprints identify
+// transpositions.
+static void search(NimState const & state, int depth, std::unordered_map<uint64_t, int> & table, SearchStats & stats)
+{
+    ++stats.probes;
+    auto [entry, inserted] = table.try_emplace(state.fingerprint(), depth);
+    if (!inserted)
+    {
+        if (entry->second >= depth)
+        {
+            ++stats.hits;
+            return;
+        }
+        entry->second = depth;
+    }
+    ++stats.nodes;
+    if (depth == 0 || state.isGameOver())
+        return;
+
+    Board const & board = state.board();
+    for (int i = 0; i < static_cast<int>(board.size()); ++i)
+    {
+        for (int n = 1; n <= board.heap(i); ++n)
+        {
+            NimState response(state);
+            response.move(i, n);
+            search(response, depth - 1, table, stats);
+        }
+    }
+}
+
+// Compares the hashing modes by searching the same tree with each.
+static void BM_TranspositionHits(benchmark::State & state, std::vector<int8_t> heaps, int depth, ZHash::Mode mode)
+{
+    Rules       rules(Rules::Variation::NORMAL);
+    NimState    root(Board(heaps), rules, NimState::PlayerId::FIRST, mode);
+    SearchStats stats;
+    uint64_t    start = allocationCount();
+    for (auto _ : state)
+    {
+        std::unordered_map<uint64_t, int> table;
+        stats = SearchStats();
+        search(root, depth, table, stats);
+        benchmark::DoNotOptimize(stats);
+    }
+    state.counters["nodes"]    = double(stats.nodes);
+    state.counters["probes"]   = double(stats.probes);
+    state.counters["hits"]     = double(stats.hits);
+    state.counters["hit_rate"] = double(stats.hits) / double(stats.probes);
+    reportAllocations(state, start);
+}
+
+BENCHMARK_CAPTURE(BM_TranspositionHits, 1_3_5_7_9_positional, {1, 3, 5, 7, 9}, 4, ZHash::Mode::POSITIONAL)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TranspositionHits, 1_3_5_7_9_canonical, {1, 3, 5, 7, 9}, 4, ZHash::Mode::CANONICAL)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TranspositionHits, 1_3_5_7_9_compact, {1, 3, 5, 7, 9}, 4, ZHash::Mode::COMPACT)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TranspositionHits, 12x4_positional, std::vector<int8_t>(12, 4), 3, ZHash::Mode::POSITIONAL)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TranspositionHits, 12x4_canonical, std::vector<int8_t>(12, 4), 3, ZHash::Mode::CANONICAL)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_ZHash_Construct(benchmark::State & state, std::vector<int8_t> heaps, ZHash::Mode mode)
+{
+    Board    board(heaps);
+    uint64_t start = allocationCount();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(board);
+        benchmark::DoNotOptimize(ZHash(board, NimState::PlayerId::FIRST, mode));
+    }
+    reportAllocations(state, start);
+}
+
+static void BM_ZHash_ChangeHeap(benchmark::State & state, ZHash::Mode mode)
+{
+    ZHash    hash(Board({1, 3, 5, 7, 9}), NimState::PlayerId::FIRST, mode);
+    uint64_t start = allocationCount();
+    for (auto _ : state)
+    {
+        hash.changeHeap(4, 9, 8);
+        hash.changeHeap(4, 8, 9);
+        benchmark::DoNotOptimize(hash);
+    }
+    reportAllocations(state, start);
+}
+
+BENCHMARK_CAPTURE(BM_ZHash_Construct, 1_3_5_7_9_positional, {1, 3, 5, 7, 9}, ZHash::Mode::POSITIONAL);
+BENCHMARK_CAPTURE(BM_ZHash_Construct, 1_3_5_7_9_canonical, {1, 3, 5, 7, 9}, ZHash::Mode::CANONICAL);
+BENCHMARK_CAPTURE(BM_ZHash_Construct, 26x99_positional, std::vector<int8_t>(26, 99), ZHash::Mode::POSITIONAL);
+BENCHMARK_CAPTURE(BM_ZHash_Construct, 26x99_canonical, std::vector<int8_t>(26, 99), ZHash::Mode::CANONICAL);
+BENCHMARK_CAPTURE(BM_ZHash_Construct, 26x99_compact, std::vector<int8_t>(26, 99), ZHash::Mode::COMPACT);
+BENCHMARK_CAPTURE(BM_ZHash_ChangeHeap, positional, ZHash::Mode::POSITIONAL);
+BENCHMARK_CAPTURE(BM_ZHash_ChangeHeap, canonical, ZHash::Mode::CANONICAL);
+BENCHMARK_CAPTURE(BM_ZHash_ChangeHeap, compact, ZHash::Mode::COMPACT);
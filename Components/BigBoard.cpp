@@ -0,0 +1,102 @@
+#include "BigBoard.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <utility>
+#include <vector>
+
+static size_t const READ_BLOCK_SIZE = 64 * 1024; // Number of bytes read from a stream at a time
+
+// Constructor
+BigBoard::BigBoard(std::vector<uint64_t> heaps)
+    : heaps_(std::move(heaps))
+{
+}
+
+std::optional<BigBoard> BigBoard::read(std::istream & in)
+{
+    std::vector<uint64_t> heaps;
+    std::vector<char>     block(READ_BLOCK_SIZE);
+    uint64_t              n       = 0;     // The number being read
+    bool                  reading = false; // True if a number is being read
+
+    // The numbers are parsed by hand rather than with operator>>, which is much slower and can't tell a number that is too large
+    // from the end of the stream. A number can span two blocks.
+    while (in)
+    {
+        in.read(block.data(), static_cast<std::streamsize>(block.size()));
+        std::streamsize count = in.gcount();
+        for (std::streamsize i = 0; i < count; ++i)
+        {
+            char c = block[i];
+            if (c >= '0' && c <= '9')
+            {
+                uint64_t digit = static_cast<uint64_t>(c - '0');
+                if (n > (UINT64_MAX - digit) / 10)
+                    return std::nullopt;
+                n       = n * 10 + digit;
+                reading = true;
+            }
+            else if (c == ' ' || c == '\n' || c == '\t' || c == '\r')
+            {
+                if (reading)
+                    heaps.push_back(n);
+                n       = 0;
+                reading = false;
+            }
+            else
+            {
+                return std::nullopt;
+            }
+        }
+    }
+    if (in.bad())
+        return std::nullopt;
+    if (reading)
+        heaps.push_back(n);
+
+    heaps.shrink_to_fit();
+    return BigBoard(std::move(heaps));
+}
+
+bool BigBoard::empty() const
+{
+    uint64_t any = 0;
+    for (uint64_t n : heaps_)
+    {
+        any |= n;
+    }
+    return any == 0;
+}
+
+uint64_t BigBoard::heap(size_t i) const
+{
+    assert(i < heaps_.size()); // Ensure the index is within bounds
+    return heaps_[i];
+}
+
+uint64_t BigBoard::nimSum() const
+{
+    uint64_t sum = 0;
+    for (uint64_t n : heaps_)
+    {
+        sum ^= n;
+    }
+    return sum;
+}
+
+uint64_t BigBoard::remove(size_t i, uint64_t n)
+{
+    assert(i < heaps_.size()); // Ensure the index is within bounds
+    assert(n > 0 && n <= heaps_[i]);
+    heaps_[i] -= n;
+    return heaps_[i];
+}
+
+bool operator==(BigBoard const & lhs, BigBoard const & rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
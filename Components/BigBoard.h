@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <vector>
+
+// The heaps of a game of Big Nim.
+//
+// Unlike a Board, a BigBoard has any number of heaps, and each heap can hold up to 2^64 - 1 objects. The heaps are stored
+// contiguously and nothing else is stored for each heap, so the memory used is proportional to the number of heaps. Boards this
+// large can't be searched, but they can be solved from the nim-sum (see BigNimSolver).
+class BigBoard
+{
+public:
+    // Constructor
+    explicit BigBoard(std::vector<uint64_t> heaps = {});
+
+    // Reads the sizes of the heaps from a stream, as decimal numbers separated by white space. The stream is read in blocks,
+    // so it can be arbitrarily long. Returns std::nullopt if the stream contains anything else or a number is too large.
+    static std::optional<BigBoard> read(std::istream & in);
+
+    // Returns an iterator to the first heap
+    uint64_t const * begin() const { return heaps_.data(); }
+
+    // Returns an iterator past the last heap
+    uint64_t const * end() const { return heaps_.data() + heaps_.size(); }
+
+    // Returns the number of heaps on the board
+    size_t size() const { return heaps_.size(); }
+
+    // Returns true if all the heaps are empty
+    bool empty() const;
+
+    // Returns the number of objects in the given heap
+    uint64_t heap(size_t i) const;
+
+    // Returns the nim-sum of the board
+    uint64_t nimSum() const;
+
+    // Removes `n` objects from heap `i`. 'n' must be > 0. Returns the new number of objects in the heap.
+    uint64_t remove(size_t i, uint64_t n);
+
+private:
+    std::vector<uint64_t> heaps_; // Number of objects in each heap
+};
+
+bool operator==(BigBoard const & lhs, BigBoard const & rhs);
@@ -2,46 +2,117 @@
 
 #include <algorithm>
 #include <cassert>
-#include <numeric>
+#include <cstring>
 #include <vector>
 
+// The number of objects in a heap is less than 128, so the high bit of every byte is 0. This allows the bytes in a word to be
+// processed in parallel without carries crossing from one byte into the next.
+static_assert(Board::MAX_OBJECTS < 128, "The high bit of each heap must be 0");
+
+static uint64_t const LOW_BITS  = 0x7f7f7f7f7f7f7f7full; // The low 7 bits of every byte
+static uint64_t const HIGH_BITS = 0x8080808080808080ull; // The high bit of every byte
+static uint64_t const ONES      = 0x0101010101010101ull; // The low bit of every byte
+
 // Constructor
 Board::Board(std::vector<int8_t> heaps)
-    : heaps_(std::move(heaps))
+    : heaps_{}
+    , size_(static_cast<int8_t>(heaps.size()))
 {
-    assert(0 < heaps_.size() && heaps_.size() <= MAX_HEAPS); // Ensure the number of heaps does not exceed the maximum allowed
-    for (int n : heaps_)
+    assert(0 < heaps.size() && heaps.size() <= MAX_HEAPS); // Ensure the number of heaps does not exceed the maximum allowed
+    for (int n : heaps)
     {
         assert(0 <= n && n <= MAX_OBJECTS); // Ensure each heap has a valid number of objects
     }
+    std::copy(heaps.begin(), heaps.end(), heaps_);
 }
 
 // Returns true if all the heaps are empty
 bool Board::empty() const
 {
-    return std::all_of(heaps_.begin(), heaps_.end(), [](int n) { return n == 0; });
+    uint64_t words[WORDS];
+    load(words);
+    uint64_t any = 0;
+    for (uint64_t w : words)
+    {
+        any |= w;
+    }
+    return any == 0;
 }
 
 int Board::heap(int i) const
 {
-    assert(0 <= i && i < heaps_.size()); // Ensure the index is within bounds
+    assert(0 <= i && i < size_); // Ensure the index is within bounds
     return heaps_[i];
 }
 
 int Board::nimSum() const
 {
-    return std::reduce(heaps_.begin(), heaps_.end(), 0, [](int sum, int heap) { return sum ^ heap; });
+    // XOR all the words together, and then XOR the bytes of the result together
+    uint64_t words[WORDS];
+    load(words);
+    uint64_t sum = 0;
+    for (uint64_t w : words)
+    {
+        sum ^= w;
+    }
+    sum ^= sum >> 32;
+    sum ^= sum >> 16;
+    sum ^= sum >> 8;
+    return static_cast<int>(sum & 0xff);
 }
 
 int Board::count() const
 {
-    return std::count_if(heaps_.begin(), heaps_.end(), [](int n) { return n > 0; });
+    // Adding 0x7f to a byte sets its high bit if and only if the byte is not 0. The high bits are then shifted down to the low
+    // bits and summed by multiplying.
+    uint64_t words[WORDS];
+    load(words);
+    int count = 0;
+    for (uint64_t w : words)
+    {
+        uint64_t nonZero = ((w + LOW_BITS) & HIGH_BITS) >> 7;
+        count += static_cast<int>((nonZero * ONES) >> 56);
+    }
+    return count;
 }
 
 int Board::remove(int i, int n)
 {
-    assert(0 <= i && i < heaps_.size()); // Ensure the index is within bounds
-    assert(0 < n && n <= heaps_[i]);     // Ensure the number of objects to remove is valid
+    assert(0 <= i && i < size_);      // Ensure the index is within bounds
+    assert(0 < n && n <= heaps_[i]); // Ensure the number of objects to remove is valid
     heaps_[i] -= n;
     return heaps_[i];
 }
+
+int Board::add(int i, int n)
+{
+    assert(0 <= i && i < size_);                    // Ensure the index is within bounds
+    assert(0 < n && n <= MAX_OBJECTS - heaps_[i]); // Ensure the number of objects to add is valid
+    heaps_[i] += n;
+    return heaps_[i];
+}
+
+int Board::append(int n)
+{
+    assert(size_ < MAX_HEAPS);          // Ensure there is room for another heap
+    assert(0 <= n && n <= MAX_OBJECTS); // Ensure the heap has a valid number of objects
+    heaps_[size_] = static_cast<int8_t>(n);
+    return size_++;
+}
+
+void Board::pop()
+{
+    assert(size_ > 1 && heaps_[size_ - 1] == 0); // Ensure the last heap is empty, and isn't the only heap
+    --size_;
+}
+
+void Board::load(uint64_t (&words)[WORDS]) const
+{
+    static_assert(sizeof(words) == sizeof(heaps_), "The words must cover the entire array");
+    std::memcpy(words, heaps_, sizeof(heaps_));
+}
+
+bool operator==(Board const & lhs, Board const & rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
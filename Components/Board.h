@@ -1,22 +1,35 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 
+// The heaps of a Nim game.
+//
+// The heaps are stored inline in a fixed-capacity array rather than in a std::vector, so a Board is trivially copyable and fits
+// in a single cache line. Unused entries are always 0, so the whole array can be processed a word at a time without regard for
+// the number of heaps.
 class Board
 {
 public:
-    static int const MAX_HEAPS   = 26; // Maximum number of heaps allowed
-    static int const MAX_OBJECTS = 99; // Maximum number of objects in a heap
+    static int constexpr MAX_HEAPS   = 26; // Maximum number of heaps allowed
+    static int constexpr MAX_OBJECTS = 99; // Maximum number of objects in a heap
 
     // Constructor
     Board(std::vector<int8_t> heaps);
 
     // Returns the contents of the board as a vector
-    std::vector<int8_t> const & heaps() const { return heaps_; }
+    std::vector<int8_t> heaps() const { return std::vector<int8_t>(begin(), end()); }
+
+    // Returns an iterator to the first heap
+    int8_t const * begin() const { return heaps_; }
+
+    // Returns an iterator past the last heap
+    int8_t const * end() const { return heaps_ + size_; }
 
     // Returns the number of heaps on the board
-    size_t size() const { return heaps_.size(); }
+    size_t size() const { return size_; }
 
     // Returns true if the board is empty
     bool empty() const;
@@ -33,11 +46,27 @@ public:
     // Removes `n` objects from heap `i`. 'n' must be > 0. Returns the new number of objects in the heap.
     int remove(int i, int n);
 
+    // Adds `n` objects to heap `i`. 'n' must be > 0. Returns the new number of objects in the heap.
+    int add(int i, int n);
+
+    // Adds a heap of `n` objects after the last heap. Returns the index of the new heap.
+    int append(int n);
+
+    // Removes the last heap, which must be empty.
+    void pop();
+
 private:
-    std::vector<int8_t> heaps_;
+    static int constexpr CAPACITY = 32; // Size of the array of heaps, a multiple of the size of a word
+    static int constexpr WORDS    = CAPACITY / sizeof(uint64_t);
+    static_assert(MAX_HEAPS <= CAPACITY, "The heaps must fit in the array");
+
+    // Loads the array of heaps as words.
+    void load(uint64_t (&words)[WORDS]) const;
+
+    alignas(CAPACITY) int8_t heaps_[CAPACITY]; // Number of objects in each heap. Unused entries are 0.
+    int8_t                   size_;            // Number of heaps
 };
 
-inline bool operator==(Board const & lhs, Board const & rhs)
-{
-    return lhs.heaps() == rhs.heaps();
-}
+static_assert(std::is_trivially_copyable<Board>::value, "A board must be copyable with memcpy");
+
+bool operator==(Board const & lhs, Board const & rhs);
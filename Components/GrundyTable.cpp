@@ -0,0 +1,141 @@
+#include "GrundyTable.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+// Multiplier of the rolling hash of a run of values
+static uint64_t const HASH_BASE = 0x100000001b3ull;
+
+// Returns the subtraction set {1, 2, ..., removalLimit}.
+static std::vector<int> upTo(int removalLimit)
+{
+    std::vector<int> set(std::max(removalLimit, 0));
+    std::iota(set.begin(), set.end(), 1);
+    return set;
+}
+
+GrundyTable::GrundyTable(int removalLimit)
+    : GrundyTable(upTo(removalLimit))
+{
+}
+
+GrundyTable::GrundyTable(std::vector<int> const & subtractionSet)
+    : preperiod_(0)
+    , period_(0)
+{
+    assert(!subtractionSet.empty());                                   // There must be at least one legal move
+    assert(subtractionSet.front() > 0 && subtractionSet.back() < 256); // The mex of at most 255 values fits in a byte
+
+    // The set is sorted and has no duplicates
+    assert(std::adjacent_find(subtractionSet.begin(), subtractionSet.end(), std::greater_equal<int>()) == subtractionSet.end());
+
+    // The value of heap n depends on the values of heaps n - limit through n - 1, which are called the window of heap n - 1.
+    size_t const limit = static_cast<size_t>(subtractionSet.back());
+    size_t const words = (limit + 63) / 64; // Number of words in a window
+
+    // The mex is computed with bit sets rather than one move at a time. heaps[g] is the set of heaps with a value of g, in which
+    // heap n is bit (n + limit), so the window of any heap starts at a bit >= 0. mask is the set of moves, in the same order as
+    // a window: bit j is set if (limit - j) is in the subtraction set. Heap n can reach a heap with a value of g if the window
+    // ending at heap n - 1 in heaps[g] has a bit in common with the mask, which tests 64 moves at once, and the loop over the
+    // words has no branches, so the compiler can vectorize it.
+    std::vector<uint64_t> mask(words, 0);
+    for (int s : subtractionSet)
+    {
+        size_t j = limit - static_cast<size_t>(s);
+        mask[j / 64] |= uint64_t(1) << (j % 64);
+    }
+    std::vector<std::vector<uint64_t>> heaps;
+    size_t                             capacity = 0; // Number of words in each set of heaps
+
+    // The window of heap n - 1 is hashed, so that windows can be compared in constant time
+    std::vector<uint64_t> hashes;
+    uint64_t              power = 1; // HASH_BASE ^ limit
+    for (size_t i = 0; i < limit; ++i)
+    {
+        power *= HASH_BASE;
+    }
+
+    // Computes the value of the next heap and the hash of the window ending with it.
+    auto next = [&]()
+    {
+        size_t n = values_.size();
+        if (n / 64 + words + 2 > capacity)
+        {
+            capacity = 2 * (n / 64 + words + 2);
+            for (std::vector<uint64_t> & set : heaps)
+            {
+                set.resize(capacity, 0);
+            }
+        }
+
+        int const shift = static_cast<int>(n % 64);
+        size_t    g     = 0;
+        for (; g < heaps.size(); ++g)
+        {
+            uint64_t const * window    = heaps[g].data() + n / 64;
+            uint64_t         reachable = 0;
+            for (size_t k = 0; k < words; ++k)
+            {
+                // The second shift is split in two, so that it is not a shift by 64 when `shift` is 0
+                reachable |= ((window[k] >> shift) | ((window[k + 1] << 1) << (63 - shift))) & mask[k];
+            }
+            if (reachable == 0)
+                break;
+        }
+        if (g == heaps.size())
+            heaps.emplace_back(capacity, 0);
+        heaps[g][(n + limit) / 64] |= uint64_t(1) << ((n + limit) % 64);
+        values_.push_back(static_cast<uint8_t>(g));
+
+        uint64_t hash = (n > 0 ? hashes.back() : 0) * HASH_BASE + g;
+        if (n >= limit)
+            hash -= values_[n - limit] * power;
+        hashes.push_back(hash);
+    };
+
+    // Returns true if the windows ending with heaps a and b are the same.
+    auto same = [&](size_t a, size_t b)
+    {
+        return hashes[a] == hashes[b] &&
+               std::equal(values_.begin() + (a + 1 - limit), values_.begin() + (a + 1), values_.begin() + (b + 1 - limit));
+    };
+
+    // The values in a window determine every value that follows it, so the sequence is periodic from the first window that
+    // repeats. The period is found with Brent's cycle detection, which compares each window to one earlier window rather than to
+    // all of them, and then the first window that repeats is found by comparing each window to the one a period later.
+    while (values_.size() <= limit)
+    {
+        next();
+    }
+    size_t tortoise = limit - 1;
+    size_t hare     = limit;
+    size_t steps    = 1; // Number of steps from the tortoise to the hare
+    size_t lap      = 1; // Number of steps after which the tortoise jumps to the hare
+    while (!same(tortoise, hare))
+    {
+        if (steps == lap)
+        {
+            tortoise = hare;
+            lap *= 2;
+            steps = 0;
+        }
+        next();
+        ++hare;
+        ++steps;
+    }
+    size_t first = limit - 1;
+    while (!same(first, first + steps))
+    {
+        ++first;
+    }
+    preperiod_ = static_cast<int>(first + 1 - limit);
+    period_    = static_cast<int>(steps);
+
+    // Only the values through the end of the first period are needed
+    values_.resize(preperiod_ + period_);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Grundy values (nimbers) of a single heap in a subtraction game.
+//
+// In a subtraction game, a move removes a number of objects in the subtraction set from a heap, such as 1 to `removalLimit`,
+// or {1, 3, 4}. The Grundy value of a heap is the smallest non-negative value that is not the Grundy value of a heap reachable
+// in one move (the "mex"). A position with several heaps is lost for the player to move if and only if the XOR of the Grundy
+// values of its heaps is 0.
+//
+// The sequence of Grundy values of a subtraction game with a finite set of moves is always eventually periodic. The table is
+// computed only until the period is detected, so the value of a heap of any size can be looked up in constant time.
+class GrundyTable
+{
+public:
+    // Constructor, for a game in which a move removes 1 to `removalLimit` objects
+    explicit GrundyTable(int removalLimit);
+
+    // Constructor, for a game in which a move removes a number of objects in `subtractionSet`, which is sorted and has no
+    // duplicates.
+    explicit GrundyTable(std::vector<int> const & subtractionSet);
+
+    // Returns the Grundy value of a heap containing `n` objects.
+    int value(uint64_t n) const
+    {
+        if (n < values_.size())
+            return values_[n];
+        return values_[preperiod_ + (n - preperiod_) % period_];
+    }
+
+    // Returns the number of values before the periodic part of the sequence.
+    int preperiod() const { return preperiod_; }
+
+    // Returns the length of the period of the sequence.
+    int period() const { return period_; }
+
+private:
+    std::vector<uint8_t> values_;    // Grundy values of heaps 0 through (preperiod + period - 1)
+    int                  preperiod_; // Number of values before the periodic part of the sequence
+    int                  period_;    // Length of the periodic part of the sequence
+};
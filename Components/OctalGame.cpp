@@ -0,0 +1,342 @@
+#include "OctalGame.h"
+
+#include "Board.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Digits of a code that allow a move to leave nothing, one heap, or two heaps
+static int const LEAVE_NOTHING = 1;
+static int const LEAVE_ONE     = 2;
+static int const LEAVE_TWO     = 4;
+
+bool OctalGame::isCode(std::string const & code)
+{
+    if (code.size() < 3 || code.size() > 2 + MAX_DIGITS || code.compare(0, 2, "0.") != 0)
+        return false;
+    bool any = false;
+    for (size_t i = 2; i < code.size(); ++i)
+    {
+        if (code[i] < '0' || code[i] > '7')
+            return false;
+        any = any || code[i] != '0';
+    }
+    return any;
+}
+
+OctalGame::OctalGame(std::string const & code, uint64_t limit /*= DEFAULT_LIMIT*/)
+    : code_(code)
+    , digits_{}
+    , maxRemoval_(0)
+    , preperiod_(0)
+    , period_(0)
+{
+    assert(isCode(code));
+    assert(limit > 0);
+    for (size_t i = 2; i < code.size(); ++i)
+    {
+        int k      = static_cast<int>(i) - 1;
+        digits_[k] = static_cast<uint8_t>(code[i] - '0');
+        if (digits_[k] != 0)
+            maxRemoval_ = k;
+    }
+    compute(limit);
+}
+
+int OctalGame::minimumRemoval() const
+{
+    int k = 1;
+    while (digits_[k] == 0)
+    {
+        ++k;
+    }
+    return k;
+}
+
+bool OctalGame::splits() const
+{
+    return std::any_of(digits_ + 1, digits_ + maxRemoval_ + 1, [](uint8_t d) { return (d & LEAVE_TWO) != 0; });
+}
+
+bool OctalGame::isLegal(uint64_t size, uint64_t n, uint64_t split) const
+{
+    if (n < 1 || n > size || n > static_cast<uint64_t>(maxRemoval_))
+        return false;
+    int      d    = digits_[n];
+    uint64_t rest = size - n;
+    if (split > 0)
+        return (d & LEAVE_TWO) && split < rest;
+    return (rest == 0) ? (d & LEAVE_NOTHING) != 0 : (d & LEAVE_ONE) != 0;
+}
+
+bool OctalGame::hasMove(uint64_t size) const
+{
+    for (uint64_t k = 1; k <= std::min(size, static_cast<uint64_t>(maxRemoval_)); ++k)
+    {
+        int d = digits_[k];
+        if ((d & LEAVE_NOTHING && size == k) || (d & LEAVE_ONE && size > k) || (d & LEAVE_TWO && size >= k + 2))
+            return true;
+    }
+    return false;
+}
+
+size_t OctalGame::maxHeaps(Board const & board) const
+{
+    if (!splits())
+        return board.size();
+
+    // Each split of a heap removes at least one object and leaves two non-empty heaps, so a heap of n objects can be split at most
+    // (n - 1) / 2 times
+    size_t heaps = board.size();
+    for (int n : board)
+    {
+        if (n > 1)
+            heaps += static_cast<size_t>(n - 1) / 2;
+    }
+    return heaps;
+}
+
+std::optional<OctalGame::Move> OctalGame::reply(uint64_t size, int target) const
+{
+    for (uint64_t k = 1; k <= std::min(size, static_cast<uint64_t>(maxRemoval_)); ++k)
+    {
+        int      d    = digits_[k];
+        uint64_t rest = size - k;
+        if ((d & LEAVE_NOTHING) && rest == 0 && target == 0)
+            return Move{k, 0};
+        if ((d & LEAVE_ONE) && rest > 0 && value(rest) == target)
+            return Move{k, 0};
+        if ((d & LEAVE_TWO) && rest >= 2)
+        {
+            // Once both parts are in the periodic part of the sequence, the values of the parts repeat with the period, so only
+            // one period of splits past the preperiod needs to be tried
+            uint64_t last = rest / 2;
+            if (isPeriodic())
+                last = std::min(last, preperiod_ + period_);
+            for (uint64_t a = 1; a <= last; ++a)
+            {
+                if ((value(a) ^ value(rest - a)) == target)
+                    return Move{k, a};
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+void OctalGame::compute(uint64_t limit)
+{
+    size_t const t = static_cast<size_t>(maxRemoval_);
+
+    // Moves that split a heap leave at least 2 objects, and the fewest they can remove is `first`
+    size_t first = 0;
+    for (size_t k = t; k >= 1; --k)
+    {
+        if (digits_[k] & LEAVE_TWO)
+            first = k;
+    }
+
+    // positions[g] is the set of heaps with a value of g, in which heap a is bit a. reversed[g] is the same set in reverse order,
+    // in which heap a is bit (capacity - 1 - a). A heap of m objects can be split into heaps with values of x and y if there is an
+    // a such that bit a is set in positions[x] and bit (capacity - 1 - (m - a)) is set in reversed[y], which is found by ANDing
+    // positions[x] with reversed[y] shifted by (capacity - 1 - m), 64 splits at a time. Most values are rare in most games, so
+    // the heaps with each value are also listed, and a split into a rare value is found by trying each heap in the list instead.
+    std::vector<std::vector<uint64_t>> positions;
+    std::vector<std::vector<uint64_t>> reversed;
+    std::vector<std::vector<uint64_t>> heaps;
+    size_t                             capacity = 0; // Number of bits in each set, a multiple of 64
+
+    auto record = [&](size_t a)
+    {
+        size_t g = values_[a];
+        size_t r = capacity - 1 - a;
+        positions[g][a / 64] |= uint64_t(1) << (a % 64);
+        reversed[g][r / 64] |= uint64_t(1) << (r % 64);
+    };
+
+    // Returns true if a heap of m objects can be split into heaps with values of x and y.
+    auto splitReaches = [&](size_t m, size_t x, size_t y)
+    {
+        size_t const words = m / 64 + 1;
+        if (std::min(heaps[x].size(), heaps[y].size()) < words)
+        {
+            size_t const rare  = (heaps[x].size() < heaps[y].size()) ? x : y;
+            size_t const other = x ^ y ^ rare;
+            for (uint64_t a : heaps[rare])
+            {
+                if (a >= m)
+                    break;
+                if (a > 0 && values_[m - a] == other)
+                    return true;
+            }
+            return false;
+        }
+
+        uint64_t const * p     = positions[x].data();
+        uint64_t const * q     = reversed[y].data();
+        size_t const     shift = capacity - 1 - m;
+        int const        bits  = static_cast<int>(shift % 64);
+        for (size_t w = 0; w < words; ++w)
+        {
+            size_t const j = w + shift / 64;
+
+            // The second shift is split in two, so that it is not a shift by 64 when `bits` is 0. The reversed sets have an extra
+            // word of padding, so j + 1 is always in range.
+            uint64_t both = p[w] & ((q[j] >> bits) | ((q[j + 1] << 1) << (63 - bits)));
+            if (w == 0)
+                both &= ~uint64_t(1); // Both parts must be non-empty
+            if (w == words - 1)
+                both &= (uint64_t(1) << (m % 64)) - 1;
+            if (both != 0)
+                return true;
+        }
+        return false;
+    };
+
+    // The set of values reachable by splitting each of the last t heaps, as a bit set indexed by m % (t + 1). Every move that
+    // leaves m objects to be split uses the same set.
+    std::vector<std::vector<uint64_t>> splitValues(t + 1);
+    size_t                             valueWords = 2; // Number of words in a set of values, enough for the XOR of any two
+
+    std::vector<uint64_t> reachable;
+    uint64_t              nextCheck = 16; // Number of values at which periodicity is checked next
+    values_.push_back(0);
+    heaps.push_back({0});
+
+    for (uint64_t n = 1; n < limit; ++n)
+    {
+        // Make room for heap n in the sets of heaps. The sets are rebuilt, because the bits of the reversed sets move.
+        if (n >= capacity)
+        {
+            capacity = std::max<size_t>(1024, 2 * capacity);
+            positions.resize(std::max<size_t>(positions.size(), 1));
+            reversed.resize(positions.size());
+            for (size_t g = 0; g < positions.size(); ++g)
+            {
+                positions[g].assign(capacity / 64, 0);
+                reversed[g].assign(capacity / 64 + 1, 0);
+            }
+            for (size_t a = 0; a < values_.size(); ++a)
+            {
+                record(a);
+            }
+        }
+
+        // The values reachable by splitting the largest heap that a move from heap n can split, which is new
+        if (first != 0 && n >= first + 2)
+        {
+            size_t                  m   = static_cast<size_t>(n) - first;
+            std::vector<uint64_t> & set = splitValues[m % (t + 1)];
+            set.assign(valueWords, 0);
+            if (positions.size() * positions.size() < m)
+            {
+                for (size_t x = 0; x < positions.size(); ++x)
+                {
+                    for (size_t y = x; y < positions.size(); ++y)
+                    {
+                        size_t v = x ^ y;
+                        if (((set[v / 64] >> (v % 64)) & 1) == 0 && splitReaches(m, x, y))
+                            set[v / 64] |= uint64_t(1) << (v % 64);
+                    }
+                }
+            }
+            else
+            {
+                // There are more pairs of values than splits, so it is faster to try each split
+                for (size_t a = 1; 2 * a <= m; ++a)
+                {
+                    size_t v = values_[a] ^ values_[m - a];
+                    set[v / 64] |= uint64_t(1) << (v % 64);
+                }
+            }
+        }
+
+        // The value of heap n is the smallest value that no move reaches
+        reachable.assign(valueWords, 0);
+        for (size_t k = 1; k <= std::min<size_t>(t, n); ++k)
+        {
+            int    d    = digits_[k];
+            size_t rest = static_cast<size_t>(n) - k;
+            if ((d & LEAVE_NOTHING) && rest == 0)
+                reachable[0] |= 1;
+            if ((d & LEAVE_ONE) && rest > 0)
+                reachable[values_[rest] / 64] |= uint64_t(1) << (values_[rest] % 64);
+            if ((d & LEAVE_TWO) && rest >= 2)
+            {
+                std::vector<uint64_t> const & set = splitValues[rest % (t + 1)];
+                for (size_t w = 0; w < set.size(); ++w)
+                {
+                    reachable[w] |= set[w];
+                }
+            }
+        }
+        size_t w = 0;
+        while (~reachable[w] == 0)
+        {
+            ++w;
+        }
+        size_t g = 64 * w;
+        while ((reachable[w] >> (g % 64)) & 1)
+        {
+            ++g;
+        }
+        assert(g <= std::numeric_limits<uint16_t>::max());
+        values_.push_back(static_cast<uint16_t>(g));
+
+        // The mex can skip values, since the XOR of two values can
+        if (g >= positions.size())
+        {
+            positions.resize(g + 1, std::vector<uint64_t>(capacity / 64, 0));
+            reversed.resize(g + 1, std::vector<uint64_t>(capacity / 64 + 1, 0));
+            heaps.resize(g + 1);
+
+            // The XOR of two values is less than twice the next power of 2, plus a word so that a mex past the end can be found
+            while (64 * (valueWords - 1) < 2 * positions.size())
+            {
+                ++valueWords;
+            }
+        }
+        record(static_cast<size_t>(n));
+        heaps[g].push_back(n);
+
+        if (n + 1 == nextCheck)
+        {
+            if (findPeriod())
+                return;
+            nextCheck += std::max<uint64_t>(16, nextCheck / 8);
+        }
+    }
+    findPeriod();
+}
+
+bool OctalGame::findPeriod()
+{
+    // By the periodicity theorem for octal games, if v(n + p) = v(n) for every n from n0 through 2 n0 + p + t - 1, where t is the
+    // largest number of objects a move removes, then v(n + p) = v(n) for every n >= n0. For each period p, the smallest n0 that
+    // works so far is found by looking back for the last value that doesn't repeat. It is usually found right away, because the
+    // period is wrong.
+    size_t const count = values_.size();
+    size_t const t     = static_cast<size_t>(maxRemoval_);
+    for (size_t p = 1; 2 * p + t <= count; ++p)
+    {
+        size_t n = count;
+        while (n > p && values_[n - 1] == values_[n - 1 - p])
+        {
+            --n;
+        }
+        size_t n0 = n - p; // Every value from n0 + p on repeats the value p before it
+        if (2 * n0 + 2 * p + t <= count)
+        {
+            preperiod_ = n0;
+            period_    = p;
+            values_.resize(n0 + p);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+class Board;
+
+// Grundy values (nimbers) of a single heap in an octal game.
+//
+// An octal game is given by a code 0.d1d2d3..., in which digit dk says what a move that removes k objects from a heap may leave
+// behind: nothing (1), one heap (2), or two heaps (4), or any sum of these. For example, in Kayles (0.77), a move removes 1 or 2
+// objects and may split what is left into two heaps, and in Dawson's chess (0.137), a move removes 1 object only if it is the
+// whole heap, 2 objects only if it doesn't split the heap, and 3 objects in any way. As in the subtraction variation, a position
+// with several heaps is lost for the player to move if and only if the XOR of the Grundy values of its heaps is 0.
+//
+// A move that splits a heap can reach two heaps in about n / 2 ways, so computing the values of the first n heaps one option at
+// a time takes quadratic time. Instead, the set of values reachable by splitting a heap is computed one pair of values at a
+// time, and it is computed once and cached for every move that leaves that heap. The heaps with each value are kept in bit sets,
+// so a split into a common pair of values is found 64 splits at a time, and in lists, so a split into a rare value is found by
+// trying only the heaps with that value. In most games, few values are common, so this takes far less than quadratic time, and
+// the values of a million heaps are computed in seconds. The values are computed until the sequence is proven to be periodic by
+// the periodicity theorem for octal games, after which the value of a heap of any size is looked up in constant time.
+class OctalGame
+{
+public:
+    static int constexpr      MAX_DIGITS    = 16;      // Maximum number of digits in a code
+    static uint64_t constexpr DEFAULT_LIMIT = 1 << 16; // Number of values computed if the sequence is not proven periodic sooner
+
+    // A move on a single heap
+    struct Move
+    {
+        uint64_t n;     // Number of objects removed from the heap
+        uint64_t split; // Number of objects of the rest that are moved to a new heap (0 if the heap is not split)
+    };
+
+    // Returns true if `code` is an octal code, such as "0.77": "0." followed by 1 to MAX_DIGITS octal digits, not all of them 0.
+    static bool isCode(std::string const & code);
+
+    // Constructor. The values are computed until the sequence is proven to be periodic or `limit` values are known. `code` must
+    // be an octal code.
+    explicit OctalGame(std::string const & code, uint64_t limit = DEFAULT_LIMIT);
+
+    // Returns the code of the game.
+    std::string const & code() const { return code_; }
+
+    // Returns digit dk of the code, or 0 if it has no such digit.
+    int digit(int k) const { return (k >= 1 && k <= maxRemoval_) ? digits_[k] : 0; }
+
+    // Returns the largest number of objects that a move can remove.
+    int maxRemoval() const { return maxRemoval_; }
+
+    // Returns the smallest number of objects that a move can remove.
+    int minimumRemoval() const;
+
+    // Returns true if a move may split a heap in two.
+    bool splits() const;
+
+    // Returns true if a move may remove `n` objects from a heap of `size` objects and then move `split` of the rest to a new heap.
+    bool isLegal(uint64_t size, uint64_t n, uint64_t split) const;
+
+    // Returns true if there is a move on a heap of `size` objects.
+    bool hasMove(uint64_t size) const;
+
+    // Returns the largest number of heaps that a game starting on `board` can have, since each split adds a heap.
+    size_t maxHeaps(Board const & board) const;
+
+    // Returns true if the sequence of values has been proven to be periodic.
+    bool isPeriodic() const { return period_ > 0; }
+
+    // Returns true if the value of a heap of `n` objects is known.
+    bool isKnown(uint64_t n) const { return isPeriodic() || n < values_.size(); }
+
+    // Returns the number of values before the periodic part of the sequence, if it is periodic.
+    uint64_t preperiod() const { return preperiod_; }
+
+    // Returns the length of the period of the sequence, or 0 if it has not been proven to be periodic.
+    uint64_t period() const { return period_; }
+
+    // Returns the Grundy value of a heap containing `n` objects, which must be known.
+    int value(uint64_t n) const
+    {
+        if (n < values_.size())
+            return values_[n];
+        return values_[preperiod_ + (n - preperiod_) % period_];
+    }
+
+    // Returns a move on a heap of `size` objects that leaves heaps whose values XOR to `target`, or std::nullopt if there is none.
+    std::optional<Move> reply(uint64_t size, int target) const;
+
+private:
+    // Computes the values of the heaps until the sequence is proven to be periodic or `limit` values are known.
+    void compute(uint64_t limit);
+
+    // Returns true if the values computed so far prove that the sequence is periodic, and sets the preperiod and the period.
+    bool findPeriod();
+
+    std::string           code_;                   // Code of the game
+    uint8_t               digits_[MAX_DIGITS + 1]; // Digit dk of the code for each k (digits_[0] is unused)
+    int                   maxRemoval_;             // Index of the last non-zero digit
+    std::vector<uint16_t> values_;                 // Values of heaps 0 through (preperiod + period - 1), or of every heap computed
+    uint64_t              preperiod_;              // Number of values before the periodic part of the sequence
+    uint64_t              period_;                 // Length of the periodic part of the sequence, or 0 if not known to be periodic
+};
@@ -2,8 +2,18 @@
 
 // Various rules for the game
 
+#include "Components/Board.h"
+#include "Components/GrundyTable.h"
+#include "Components/OctalGame.h"
+
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
 #include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 class Rules
 {
@@ -14,18 +24,168 @@ public:
         MISERE = 0,      // Misre
         NORMAL,          // Normal
         SUBTRACT,     // Subtraction
+        OCTAL,           // Octal game, in which a move may split a heap in two
         DEFAULT = MISERE // Default variation
     };
 
     explicit Rules(Variation variation = Variation::DEFAULT, int removalLimit = std::numeric_limits<int8_t>::max())
         : variation_(variation)
         , removalLimit_(removalLimit)
+        , allowed_{}
+    {
+        // In the subtraction variation, a move removes 1 to `removalLimit` objects
+        if (variation_ == Variation::SUBTRACT)
+        {
+            assert(1 <= removalLimit_ && removalLimit_ < 256); // There must be a legal move, and the set must fit in allowed_
+            for (int n = 1; n <= removalLimit_; ++n)
+            {
+                subtractionSet_.push_back(n);
+            }
+            initialize();
+        }
+    }
+
+    // Constructor for the subtraction variation, in which a move removes a number of objects in a set, such as {1, 3, 4}
+    explicit Rules(std::vector<int> subtractionSet)
+        : variation_(Variation::SUBTRACT)
+        , removalLimit_(0)
+        , subtractionSet_(std::move(subtractionSet))
+        , allowed_{}
+    {
+        std::sort(subtractionSet_.begin(), subtractionSet_.end());
+        subtractionSet_.erase(std::unique(subtractionSet_.begin(), subtractionSet_.end()), subtractionSet_.end());
+        assert(!subtractionSet_.empty() && subtractionSet_.front() > 0 && subtractionSet_.back() < 256);
+        removalLimit_ = subtractionSet_.back();
+        initialize();
+    }
+
+    // Constructor for the subtraction variation with a removal limit for each heap, in the order of the heaps on the board, such
+    // as {4, 3, 7}. A move removes 1 to the limit of its heap. Heaps with different limits are different games even if they are
+    // the same size, so these rules are only played from the Grundy values of the heaps, and never searched.
+    Rules(Variation variation, std::vector<int> heapLimits)
+        : variation_(variation)
+        , removalLimit_(0)
+        , heapLimits_(std::move(heapLimits))
+        , allowed_{}
+    {
+        assert(variation_ == Variation::SUBTRACT && !heapLimits_.empty());
+        assert(std::all_of(heapLimits_.begin(), heapLimits_.end(), [](int limit) { return 1 <= limit && limit < 256; }));
+        removalLimit_ = *std::max_element(heapLimits_.begin(), heapLimits_.end());
+        for (int n = 1; n <= removalLimit_; ++n)
+        {
+            subtractionSet_.push_back(n);
+        }
+        initialize();
+
+        // Heaps with the same limit share a table
+        for (int limit : heapLimits_)
+        {
+            size_t first = std::find(heapLimits_.begin(), heapLimits_.end(), limit) - heapLimits_.begin();
+            if (limit == removalLimit_)
+                heapTables_.push_back(grundyTable_);
+            else if (first < heapTables_.size())
+                heapTables_.push_back(heapTables_[first]);
+            else
+                heapTables_.push_back(std::make_shared<GrundyTable const>(limit));
+        }
+    }
+
+    // Constructor for an octal game, given by its code, such as "0.77" for Kayles. The code must be an octal code (see
+    // OctalGame::isCode()). The Grundy values are computed for heaps smaller than `limit`, or for heaps of any size if they are
+    // proven to be periodic sooner. By default, that is every heap a Board can hold.
+    Rules(Variation variation, std::string const & code, uint64_t limit = Board::MAX_OBJECTS + 1)
+        : variation_(variation)
+        , removalLimit_(0)
+        , allowed_{}
+        , octalGame_(std::make_shared<OctalGame const>(code, limit))
     {
+        assert(variation_ == Variation::OCTAL);
+        removalLimit_ = octalGame_->maxRemoval();
     }
+
     Variation variation() const { return variation_; }
     int       removalLimit() const { return removalLimit_; }
 
+    // Returns the maximum number of objects that can be removed from heap `i`.
+    int removalLimit(int i) const { return heapLimits_.empty() ? removalLimit_ : heapLimits_[i]; }
+
+    // Returns the removal limit of each heap, or an empty vector if the heaps don't have limits of their own.
+    std::vector<int> const & heapLimits() const { return heapLimits_; }
+
+    // Returns the numbers of objects that a move can remove in the subtraction variation, in increasing order. The set is
+    // empty for other variations.
+    std::vector<int> const & subtractionSet() const { return subtractionSet_; }
+
+    // Returns true if a move may remove any number of objects from 1 to the removal limit (always true for misre and normal
+    // play, and never for octal games, whose moves also depend on what they leave).
+    bool isRange() const
+    {
+        if (variation_ == Variation::OCTAL)
+            return false;
+        return variation_ != Variation::SUBTRACT || static_cast<int>(subtractionSet_.size()) == removalLimit_;
+    }
+
+    // Returns the smallest number of objects that a move can remove. Except in octal games, the game is over when every heap is
+    // smaller than this.
+    int minimumRemoval() const
+    {
+        switch (variation_)
+        {
+        case Variation::SUBTRACT:
+            return subtractionSet_.front();
+        case Variation::OCTAL:
+            return octalGame_->minimumRemoval();
+        default:
+            return 1;
+        }
+    }
+
+    // Returns true if a move may remove `n` objects from a heap that is large enough. In an octal game, whether it may also
+    // depends on what the move leaves.
+    bool allows(int n) const
+    {
+        if (n < 1 || n > removalLimit_)
+            return false;
+        if (variation_ == Variation::OCTAL)
+            return octalGame_->digit(n) != 0;
+        return variation_ != Variation::SUBTRACT || (allowed_[n / 64] >> (n % 64)) & 1;
+    }
+
+    // Returns true if there is a move on a heap of `n` objects. The game is over when there is none on any heap.
+    bool hasMove(int n) const { return (variation_ == Variation::OCTAL) ? octalGame_->hasMove(n) : n >= minimumRemoval(); }
+
+    // Returns true if a move may remove `n` objects from heap `i`, if it is large enough.
+    bool allows(int i, int n) const { return allows(n) && n <= removalLimit(i); }
+
+    // Returns the Grundy values of a heap for the subtraction variation, or nullptr for other variations. If the heaps have
+    // limits of their own, these are the values for the largest limit.
+    GrundyTable const * grundyTable() const { return grundyTable_.get(); }
+
+    // Returns the Grundy values of heap `i` for the subtraction variation, or nullptr for other variations.
+    GrundyTable const * grundyTable(int i) const { return heapTables_.empty() ? grundyTable_.get() : heapTables_[i].get(); }
+
+    // Returns the octal game, or nullptr for other variations.
+    OctalGame const * octalGame() const { return octalGame_.get(); }
+
 private:
-    Variation variation_;    // Variation of the game
-    int       removalLimit_; // Maximum number of objects that can be removed from a heap
+    // Sets up the subtraction variation after the set is known.
+    void initialize()
+    {
+        for (int n : subtractionSet_)
+        {
+            allowed_[n / 64] |= uint64_t(1) << (n % 64);
+        }
+
+        // The Grundy values are computed once and shared by every copy of these rules
+        grundyTable_ = std::make_shared<GrundyTable const>(subtractionSet_);
+    }
+
+    Variation                                       variation_;      // Variation of the game
+    int                                             removalLimit_;   // Maximum number of objects that can be removed from a heap
+    std::vector<int>                                heapLimits_;     // Removal limit of each heap, if they have their own
+    std::vector<int>                                subtractionSet_; // Numbers of objects that can be removed
+    uint64_t                                        allowed_[4];     // Bit set of the subtraction set
+    std::shared_ptr<GrundyTable const>              grundyTable_;    // Grundy values for the subtraction variation
+    std::vector<std::shared_ptr<GrundyTable const>> heapTables_;     // Grundy values of each heap, if they have their own limits
+    std::shared_ptr<OctalGame const>                octalGame_;      // Code and Grundy values of an octal game
 };
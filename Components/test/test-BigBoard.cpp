@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+
+#include "Components/BigBoard.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Nim
+{
+
+TEST(BigBoard, Constructor)
+{
+    ASSERT_NO_THROW(BigBoard());
+    ASSERT_NO_THROW(BigBoard({1, 2, 3}));
+    ASSERT_NO_THROW(BigBoard({UINT64_MAX}));                       // Maximum number of objects in a heap
+    ASSERT_NO_THROW(BigBoard(std::vector<uint64_t>(100000, 7)));  // Any number of heaps
+    EXPECT_EQ(BigBoard(std::vector<uint64_t>(100000, 7)).size(), 100000);
+}
+
+TEST(BigBoard, Read)
+{
+    // Numbers can be separated by any white space
+    std::istringstream in1("1 2\t3\n\n18446744073709551615\r\n 0 ");
+    auto               board1 = BigBoard::read(in1);
+    ASSERT_TRUE(board1.has_value());
+    EXPECT_EQ(*board1, BigBoard({1, 2, 3, UINT64_MAX, 0}));
+
+    // The last number doesn't need to be followed by white space
+    std::istringstream in2("42");
+    EXPECT_EQ(BigBoard::read(in2), BigBoard({42}));
+
+    // An empty stream is an empty board
+    std::istringstream in3("");
+    EXPECT_EQ(BigBoard::read(in3), BigBoard());
+
+    // Numbers that span the blocks in which the stream is read are read whole
+    std::string text;
+    for (int i = 0; i < 50000; ++i)
+    {
+        text += std::to_string(1000000007ull * i) + " ";
+    }
+    std::istringstream in4(text);
+    auto               board4 = BigBoard::read(in4);
+    ASSERT_TRUE(board4.has_value());
+    ASSERT_EQ(board4->size(), 50000);
+    for (size_t i = 0; i < board4->size(); ++i)
+    {
+        EXPECT_EQ(board4->heap(i), 1000000007ull * i);
+    }
+
+    // Anything else is an error
+    std::istringstream bad1("1 2 x");
+    EXPECT_FALSE(BigBoard::read(bad1).has_value());
+    std::istringstream bad2("-1");
+    EXPECT_FALSE(BigBoard::read(bad2).has_value());
+    std::istringstream bad3("18446744073709551616"); // Too large
+    EXPECT_FALSE(BigBoard::read(bad3).has_value());
+}
+
+TEST(BigBoard, Empty)
+{
+    EXPECT_TRUE(BigBoard().empty());
+    EXPECT_TRUE(BigBoard({0, 0, 0}).empty());
+    EXPECT_FALSE(BigBoard({0, 1ull << 40, 0}).empty());
+}
+
+TEST(BigBoard, NimSum)
+{
+    EXPECT_EQ(BigBoard().nimSum(), 0);
+    EXPECT_EQ(BigBoard({1, 2, 3}).nimSum(), 0);
+    EXPECT_EQ(BigBoard({1ull << 63, 5, 1ull << 33}).nimSum(), (1ull << 63) | (1ull << 33) | 5);
+
+    std::vector<uint64_t> heaps(10001, 123456789012345ull); // An odd number of equal heaps
+    EXPECT_EQ(BigBoard(heaps).nimSum(), 123456789012345ull);
+}
+
+TEST(BigBoard, Remove)
+{
+    BigBoard board({5000000000ull, 7});
+    EXPECT_EQ(board.remove(0, 1000000000ull), 4000000000ull);
+    EXPECT_EQ(board.remove(1, 7), 0);
+    EXPECT_EQ(board, BigBoard({4000000000ull, 0}));
+}
+
+} // namespace Nim
@@ -2,6 +2,9 @@
 
 #include "Components/Board.h"
 
+#include <cstring>
+#include <vector>
+
 namespace Nim
 {
 
@@ -32,6 +35,43 @@ TEST(Board, Size)
 TEST(Board, Empty)
 {
     EXPECT_TRUE(Board({0, 0, 0}).empty()); // Check if an empty board is recognized as empty
+    EXPECT_FALSE(Board({0, 0, 1}).empty());
+    EXPECT_FALSE(Board(std::vector<int8_t>{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1}).empty());
+}
+
+TEST(Board, NimSum)
+{
+    EXPECT_EQ(Board({0, 0, 0}).nimSum(), 0);
+    EXPECT_EQ(Board({1, 2, 3}).nimSum(), 0);
+    EXPECT_EQ(Board({1, 3, 5, 7, 9}).nimSum(), 9);
+    EXPECT_EQ(Board({Board::MAX_OBJECTS}).nimSum(), Board::MAX_OBJECTS);
+
+    // Every heap contributes, regardless of its position
+    std::vector<int8_t> heaps(Board::MAX_HEAPS, 0);
+    int                 expected = 0;
+    for (int i = 0; i < Board::MAX_HEAPS; ++i)
+    {
+        heaps[i] = static_cast<int8_t>((i * 37 + 11) % (Board::MAX_OBJECTS + 1));
+        expected ^= heaps[i];
+    }
+    EXPECT_EQ(Board(heaps).nimSum(), expected);
+}
+
+TEST(Board, Count)
+{
+    EXPECT_EQ(Board({0, 0, 0}).count(), 0);
+    EXPECT_EQ(Board({1, 0, 3}).count(), 2);
+    EXPECT_EQ(Board(std::vector<int8_t>(Board::MAX_HEAPS, Board::MAX_OBJECTS)).count(), Board::MAX_HEAPS);
+    EXPECT_EQ(Board(std::vector<int8_t>(Board::MAX_HEAPS, 1)).count(), Board::MAX_HEAPS);
+}
+
+TEST(Board, Copy)
+{
+    // A board can be copied with memcpy
+    Board board({1, 2, 3});
+    Board copy({0});
+    std::memcpy(static_cast<void *>(&copy), &board, sizeof(Board));
+    EXPECT_EQ(copy, board);
 }
 
 TEST(Board, Heap)
@@ -60,4 +100,33 @@ TEST(Board, Remove)
     EXPECT_DEATH(board.remove(99, 1), "Assertion failed: .*");  // Attempt to remove from an invalid heap should fail
 }
 
+TEST(Board, Add)
+{
+    Board board({0, 2, Board::MAX_OBJECTS});
+    EXPECT_TRUE(board.add(0, 1) == 1 && board.heap(0) == 1);      // Add 1 to an empty heap
+    EXPECT_TRUE(board.add(1, 3) == 5 && board.heap(1) == 5);      // Add 3 to a heap of 2
+    EXPECT_TRUE(board.remove(1, 3) == 2 && board.add(1, 3) == 5); // Adding undoes removing
+    EXPECT_DEATH(board.add(2, 1), "Assertion failed: .*");        // Attempt to overfill a heap should fail
+    EXPECT_DEATH(board.add(0, 0), "Assertion failed: .*");        // Attempt to add 0 should fail
+    EXPECT_DEATH(board.add(0, -1), "Assertion failed: .*");       // Attempt to add a negative number should fail
+    EXPECT_DEATH(board.add(3, 1), "Assertion failed: .*");        // Attempt to add to an invalid heap should fail
+}
+
+TEST(Board, Append)
+{
+    Board board({3, 4});
+    EXPECT_EQ(board.append(2), 2); // The new heap is the last one
+    EXPECT_EQ(board.size(), 3);
+    EXPECT_EQ(board.heap(2), 2);
+    EXPECT_EQ(board.nimSum(), 3 ^ 4 ^ 2);
+    EXPECT_EQ(board.count(), 3);
+    EXPECT_TRUE(board.remove(2, 2) == 0);
+    board.pop(); // Popping undoes appending
+    EXPECT_TRUE(board == Board({3, 4}));
+
+    Board full(std::vector<int8_t>(Board::MAX_HEAPS - 1, 1));
+    EXPECT_EQ(full.append(Board::MAX_OBJECTS), Board::MAX_HEAPS - 1);
+    EXPECT_EQ(full.count(), Board::MAX_HEAPS);
+}
+
 } // namespace Nim
@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+
+#include "Components/GrundyTable.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Nim
+{
+
+TEST(GrundyTable, Constructor)
+{
+    ASSERT_NO_THROW(GrundyTable(1));
+    ASSERT_NO_THROW(GrundyTable(4));
+    ASSERT_NO_THROW(GrundyTable(255));
+    EXPECT_DEATH(GrundyTable(0), "Assertion failed: .*");   // There must be at least one legal move
+    EXPECT_DEATH(GrundyTable(256), "Assertion failed: .*"); // The values must fit in a byte
+
+    ASSERT_NO_THROW(GrundyTable(std::vector<int>{1, 3, 4}));
+    ASSERT_NO_THROW(GrundyTable(std::vector<int>{255}));
+    EXPECT_DEATH(GrundyTable(std::vector<int>{}), "Assertion failed: .*");     // There must be at least one legal move
+    EXPECT_DEATH(GrundyTable(std::vector<int>{3, 1}), "Assertion failed: .*"); // The set must be sorted
+}
+
+TEST(GrundyTable, Value)
+{
+    // Compare the table to the values computed directly from the definition
+    for (int k : {1, 2, 3, 4, 10, 99})
+    {
+        GrundyTable      table(k);
+        std::vector<int> values;
+        for (int n = 0; n < 1000; ++n)
+        {
+            std::vector<bool> reachable(k + 1, false);
+            for (int s = 1; s <= k && s <= n; ++s)
+            {
+                reachable[values[n - s]] = true;
+            }
+            int g = static_cast<int>(std::find(reachable.begin(), reachable.end(), false) - reachable.begin());
+            values.push_back(g);
+            EXPECT_EQ(table.value(n), g);
+        }
+    }
+}
+
+TEST(GrundyTable, Value_Set)
+{
+    // Compare the table to the values computed directly from the definition, for sets that are not ranges, and for sets with
+    // moves in every word of the bit sets
+    for (std::vector<int> const & set : std::vector<std::vector<int>>{
+             {1, 3, 4}, {2, 5, 7}, {3}, {1, 4, 9, 16, 25}, {2, 3, 63, 64, 65}, {1, 70, 128, 200, 255}})
+    {
+        GrundyTable      table(set);
+        std::vector<int> values;
+        for (int n = 0; n < 3000; ++n)
+        {
+            std::vector<bool> reachable(set.size() + 1, false);
+            for (int s : set)
+            {
+                if (s <= n)
+                    reachable[values[n - s]] = true;
+            }
+            int g = static_cast<int>(std::find(reachable.begin(), reachable.end(), false) - reachable.begin());
+            values.push_back(g);
+            EXPECT_EQ(table.value(n), g) << "heap " << n << " of set " << set.front() << "...";
+        }
+    }
+}
+
+TEST(GrundyTable, Period)
+{
+    // For a removal limit of k, the values are 0, 1, ..., k repeated.
+    for (int k : {1, 4, 99})
+    {
+        GrundyTable table(k);
+        EXPECT_EQ(table.preperiod(), 0);
+        EXPECT_EQ(table.period(), k + 1);
+        EXPECT_EQ(table.value(1000000007ull), 1000000007ull % (k + 1)); // Heaps far larger than Board::MAX_OBJECTS
+    }
+
+    // The values of {1, 3, 4} are 0, 1, 0, 1, 2, 3, 2 repeated
+    {
+        GrundyTable table(std::vector<int>{1, 3, 4});
+        EXPECT_EQ(table.preperiod(), 0);
+        EXPECT_EQ(table.period(), 7);
+    }
+
+    // The values of {2, 5, 7} repeat with a longer period
+    {
+        GrundyTable table(std::vector<int>{2, 5, 7});
+        EXPECT_EQ(table.preperiod(), 0);
+        EXPECT_EQ(table.period(), 22);
+    }
+
+    // The values of {1, 4, 9, 16, 25} only repeat after a preperiod
+    {
+        GrundyTable table(std::vector<int>{1, 4, 9, 16, 25});
+        EXPECT_EQ(table.preperiod(), 34);
+        EXPECT_EQ(table.period(), 34);
+    }
+}
+
+} // namespace Nim
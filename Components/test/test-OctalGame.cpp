@@ -0,0 +1,213 @@
+#include "gtest/gtest.h"
+
+#include "Components/Board.h"
+#include "Components/OctalGame.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Returns the values of heaps 0 through count - 1, computed directly from the definition, one move at a time.
+std::vector<int> naiveValues(std::string const & code, int count)
+{
+    std::vector<int> digits{0};
+    for (size_t i = 2; i < code.size(); ++i)
+    {
+        digits.push_back(code[i] - '0');
+    }
+    int const        t = static_cast<int>(digits.size()) - 1;
+    std::vector<int> values{0};
+    for (int n = 1; n < count; ++n)
+    {
+        std::vector<bool> reachable(2 * n + 2, false);
+        for (int k = 1; k <= std::min(t, n); ++k)
+        {
+            int rest = n - k;
+            if ((digits[k] & 1) && rest == 0)
+                reachable[0] = true;
+            if ((digits[k] & 2) && rest > 0)
+                reachable[values[rest]] = true;
+            if (digits[k] & 4)
+            {
+                for (int a = 1; 2 * a <= rest; ++a)
+                {
+                    reachable[values[a] ^ values[rest - a]] = true;
+                }
+            }
+        }
+        values.push_back(static_cast<int>(std::find(reachable.begin(), reachable.end(), false) - reachable.begin()));
+    }
+    return values;
+}
+
+} // anonymous namespace
+
+namespace Nim
+{
+
+TEST(OctalGame, Constructor)
+{
+    ASSERT_NO_THROW(OctalGame("0.77"));
+    ASSERT_NO_THROW(OctalGame("0.137"));
+    ASSERT_NO_THROW(OctalGame("0.16", 1000));
+    ASSERT_NO_THROW(OctalGame("0.7777777777777777"));
+}
+
+TEST(OctalGame, IsCode)
+{
+    EXPECT_TRUE(OctalGame::isCode("0.77"));
+    EXPECT_TRUE(OctalGame::isCode("0.137"));
+    EXPECT_TRUE(OctalGame::isCode("0.007"));
+    EXPECT_FALSE(OctalGame::isCode(""));
+    EXPECT_FALSE(OctalGame::isCode("0."));
+    EXPECT_FALSE(OctalGame::isCode("0.00"));   // There must be a move
+    EXPECT_FALSE(OctalGame::isCode("0.78"));   // Not an octal digit
+    EXPECT_FALSE(OctalGame::isCode("4.07"));   // Only 0 is allowed before the point
+    EXPECT_FALSE(OctalGame::isCode("077"));
+    EXPECT_FALSE(OctalGame::isCode("0.77777777777777777")); // Too many digits
+}
+
+TEST(OctalGame, Digits)
+{
+    OctalGame dawson("0.137");
+    EXPECT_EQ(dawson.code(), "0.137");
+    EXPECT_EQ(dawson.digit(0), 0);
+    EXPECT_EQ(dawson.digit(1), 1);
+    EXPECT_EQ(dawson.digit(3), 7);
+    EXPECT_EQ(dawson.digit(4), 0);
+    EXPECT_EQ(dawson.maxRemoval(), 3);
+    EXPECT_EQ(dawson.minimumRemoval(), 1);
+    EXPECT_TRUE(dawson.splits());
+
+    OctalGame game("0.0320");
+    EXPECT_EQ(game.maxRemoval(), 3); // Trailing zeros are ignored
+    EXPECT_EQ(game.minimumRemoval(), 2);
+    EXPECT_FALSE(game.splits());
+}
+
+TEST(OctalGame, IsLegal)
+{
+    // In Dawson's chess, 1 may be removed only if it is the whole heap, 2 only if the heap is not split, and 3 in any way
+    OctalGame dawson("0.137");
+    EXPECT_TRUE(dawson.isLegal(1, 1, 0));
+    EXPECT_FALSE(dawson.isLegal(5, 1, 0));
+    EXPECT_TRUE(dawson.isLegal(2, 2, 0));
+    EXPECT_TRUE(dawson.isLegal(5, 2, 0));
+    EXPECT_FALSE(dawson.isLegal(5, 2, 1));
+    EXPECT_TRUE(dawson.isLegal(3, 3, 0));
+    EXPECT_TRUE(dawson.isLegal(6, 3, 0));
+    EXPECT_TRUE(dawson.isLegal(6, 3, 1));
+    EXPECT_TRUE(dawson.isLegal(6, 3, 2));
+    EXPECT_FALSE(dawson.isLegal(6, 3, 3)); // Both heaps must be non-empty
+    EXPECT_FALSE(dawson.isLegal(6, 4, 0)); // Too many
+    EXPECT_FALSE(dawson.isLegal(2, 3, 0)); // More than the heap
+    EXPECT_FALSE(dawson.isLegal(2, 0, 0));
+}
+
+TEST(OctalGame, HasMove)
+{
+    OctalGame dawson("0.137");
+    EXPECT_FALSE(dawson.hasMove(0));
+    EXPECT_TRUE(dawson.hasMove(1));
+    EXPECT_TRUE(dawson.hasMove(1000));
+
+    // Only 2 or 3 may be removed, and only if something is left
+    OctalGame game("0.022");
+    EXPECT_FALSE(game.hasMove(2));
+    EXPECT_TRUE(game.hasMove(3));
+}
+
+TEST(OctalGame, MaxHeaps)
+{
+    OctalGame kayles("0.77");
+    EXPECT_EQ(kayles.maxHeaps(Board({1, 2})), 2);
+    EXPECT_EQ(kayles.maxHeaps(Board({5, 4})), 5); // 5 can be split twice and 4 once
+    EXPECT_EQ(OctalGame("0.33").maxHeaps(Board({5, 4})), 2);
+}
+
+TEST(OctalGame, Value)
+{
+    // Compare the values to the values computed directly from the definition, for games with and without splits, and for games
+    // that are not known to be periodic
+    for (char const * code : {"0.77", "0.137", "0.07", "0.4", "0.16", "0.106", "0.6", "0.51", "0.33", "0.7777"})
+    {
+        OctalGame        game(code, 2000);
+        std::vector<int> values = naiveValues(code, 2000);
+        for (int n = 0; n < 2000; ++n)
+        {
+            ASSERT_EQ(game.value(n), values[n]) << "heap " << n << " of " << code;
+        }
+    }
+}
+
+TEST(OctalGame, Period)
+{
+    // Kayles
+    {
+        OctalGame kayles("0.77");
+        EXPECT_TRUE(kayles.isPeriodic());
+        EXPECT_EQ(kayles.preperiod(), 71);
+        EXPECT_EQ(kayles.period(), 12);
+        EXPECT_EQ(kayles.value(70), 6); // The last exception, since a period later, the value is 2
+        EXPECT_EQ(kayles.value(82), 2);
+        EXPECT_EQ(kayles.value(1000000000000000000ull), kayles.value(71 + (1000000000000000000ull - 71) % 12));
+    }
+
+    // Dawson's chess
+    {
+        OctalGame dawson("0.137");
+        EXPECT_TRUE(dawson.isPeriodic());
+        EXPECT_EQ(dawson.preperiod(), 52);
+        EXPECT_EQ(dawson.period(), 34);
+    }
+
+    // 0.16 is not known to be periodic
+    {
+        OctalGame game("0.16", 5000);
+        EXPECT_FALSE(game.isPeriodic());
+        EXPECT_TRUE(game.isKnown(4999));
+        EXPECT_FALSE(game.isKnown(5000));
+    }
+}
+
+TEST(OctalGame, Reply)
+{
+    OctalGame kayles("0.77");
+
+    // No move reaches the value of the heap itself
+    for (uint64_t size : {4ull, 70ull, 1000ull})
+    {
+        EXPECT_FALSE(kayles.reply(size, kayles.value(size)).has_value()) << size;
+    }
+
+    // Any heap can be emptied or split evenly, leaving a value of 0
+    for (uint64_t size : {1ull, 2ull, 7ull, 8ull, 1000000000001ull})
+    {
+        std::optional<OctalGame::Move> move = kayles.reply(size, 0);
+        ASSERT_TRUE(move.has_value()) << size;
+        EXPECT_TRUE(kayles.isLegal(size, move->n, move->split));
+        uint64_t rest = size - move->n;
+        EXPECT_EQ(kayles.value(rest - move->split) ^ kayles.value(move->split), 0);
+    }
+
+    // Every reply reaches its target
+    OctalGame dawson("0.137");
+    for (uint64_t size = 1; size < 200; ++size)
+    {
+        for (int target = 0; target < 8; ++target)
+        {
+            std::optional<OctalGame::Move> move = dawson.reply(size, target);
+            if (!move)
+                continue;
+            EXPECT_TRUE(dawson.isLegal(size, move->n, move->split));
+            uint64_t rest = size - move->n;
+            EXPECT_EQ(dawson.value(rest - move->split) ^ dawson.value(move->split), target);
+        }
+    }
+}
+
+} // namespace Nim
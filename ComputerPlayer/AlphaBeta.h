@@ -0,0 +1,189 @@
+#pragma once
+
+#include "NimTranspositionTable.h"
+
+#include "Components/Rules.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+// The work done by a search
+struct SearchCounters
+{
+    uint64_t nodes        = 0; // Number of nodes visited
+    uint64_t probes       = 0; // Number of transposition table probes
+    uint64_t hits         = 0; // Number of probes that found the state
+    uint64_t stores       = 0; // Number of values stored in the transposition table
+    uint64_t replacements = 0; // Number of stores that replaced a different state
+    uint64_t evaluations  = 0; // Number of calls to the static evaluator
+};
+
+// The budget for a search, shared by all the threads searching the same state
+struct SearchBudget
+{
+    std::chrono::steady_clock::time_point deadline;  // Time at which the search must stop
+    bool                                  timed;     // True if the search must stop at the deadline
+    uint64_t                              nodeLimit; // Number of nodes at which the search must stop (0 means no limit)
+    std::atomic<uint64_t>                 counted;   // Number of nodes counted against the limit by all the threads
+    std::atomic<bool>                     stopped;   // True if the budget has run out
+};
+
+// A depth-limited alpha-beta search that makes and undoes moves in place on a single state.
+//
+// The search is bound at compile time to the types of the state, the move orderer and the static evaluator, and to the variation
+// of the game, so every call it makes for a node is a direct call that the compiler can inline. There are no virtual calls, no
+// calls through std::function, and no RTTI. The types must provide:
+//   State      move(i, n) returning an undo record, undo(record), isGameOver(), whoseTurn(), fingerprint() and board()
+//   Orderer    Orderer(board, rules, hint, killers), next() returning the next move (if any), hint(board, move), and
+//              addKiller(killers, hint), with the types Orderer::Hint and Orderer::Killers
+//   Evaluator  evaluate<V>(state), returning the value of the state for the first player
+//   Table      probe(fingerprint), returning a pointer to or an optional copy of a NimTranspositionTable::Entry, and
+//              store(fingerprint, value, depth, bound, heap, n), e.g. NimTranspositionTable or SharedTranspositionTable
+//
+// The first player maximizes the value and the second player minimizes it. Values are stored in a transposition table, which
+// also supplies the first move to search at each node.
+template <typename State, typename Orderer, typename Evaluator, Rules::Variation V, typename Table = NimTranspositionTable>
+class AlphaBeta
+{
+public:
+    static int constexpr NODES_PER_CHECK = 1024; // Number of nodes visited between checks of the budget
+
+    // Constructor
+    AlphaBeta(Rules const &                            rules,
+              Evaluator const &                        evaluator,
+              Table &                                  table,
+              std::vector<typename Orderer::Killers> & killers,
+              SearchCounters &                         counters,
+              SearchBudget &                           budget,
+              int                                      horizon,
+              bool                                     moveOrdering)
+        : rules_(rules)
+        , evaluator_(evaluator)
+        , table_(table)
+        , killers_(killers)
+        , counters_(counters)
+        , budget_(budget)
+        , horizon_(horizon)
+        , moveOrdering_(moveOrdering)
+    {
+        assert(rules_.variation() == V);
+        assert(static_cast<int>(killers_.size()) > horizon_);
+    }
+
+    // Returns the value of the state, which is `depth` plies from the root. The value is meaningless if the budget runs out.
+    float search(State & state, int depth, float alpha, float beta)
+    {
+        using Bound = NimTranspositionTable::Bound;
+
+        countNode();
+        if (state.isGameOver() || depth >= horizon_)
+        {
+            ++counters_.evaluations;
+            return evaluator_.template evaluate<V>(state);
+        }
+
+        // Check the transposition table for a value that was searched at least as deep. An entry that was not searched deep
+        // enough still suggests the move to search first.
+        int                    remaining = horizon_ - depth;
+        typename Orderer::Hint preferred{};
+        ++counters_.probes;
+        if (auto entry = table_.probe(state.fingerprint()))
+        {
+            ++counters_.hits;
+            if (entry->depth >= remaining)
+            {
+                if (entry->bound() == Bound::EXACT)
+                    return entry->value;
+                if (entry->bound() == Bound::LOWER && entry->value >= beta)
+                    return entry->value;
+                if (entry->bound() == Bound::UPPER && entry->value <= alpha)
+                    return entry->value;
+            }
+            preferred = typename Orderer::Hint{entry->heap(), entry->n()};
+        }
+
+        float const originalAlpha = alpha;
+        float const originalBeta  = beta;
+        bool        maximizing    = (state.whoseTurn() == State::PlayerId::FIRST);
+        float       best          = maximizing ? -INFINITE_VALUE : INFINITE_VALUE;
+        int         bestHeap      = 0;
+        int         bestN         = 0;
+
+        // Make each move in place, search it, and then undo it
+        typename Orderer::Killers & killers = killers_[depth];
+        Orderer                     moves(state.board(), rules_, preferred, moveOrdering_ ? &killers : nullptr);
+        while (auto move = moves.next())
+        {
+            int   heap  = state.board().heap(move->i);
+            auto  undo  = state.move(move->i, move->n);
+            float value = search(state, depth + 1, alpha, beta);
+            state.undo(undo);
+
+            // If the search was stopped, the value is meaningless and must not be saved
+            if (budget_.stopped)
+                return 0.0f;
+
+            if (maximizing ? value > best : value < best)
+            {
+                best     = value;
+                bestHeap = heap;
+                bestN    = move->n;
+            }
+            if (maximizing)
+                alpha = std::max(alpha, value);
+            else
+                beta = std::min(beta, value);
+            if (alpha >= beta)
+            {
+                // The opponent will avoid this state, so the remaining moves don't matter. The move that caused the cutoff will
+                // likely cause one in other states at the same depth too.
+                Orderer::addKiller(killers, Orderer::hint(state.board(), *move));
+                break;
+            }
+        }
+
+        // Save the result in the transposition table, noting whether the value is exact or only a bound. The best move is saved by
+        // the size of its heap rather than its index, because a permutation of the board has the same fingerprint.
+        ++counters_.stores;
+        Bound bound = (best <= originalAlpha) ? Bound::UPPER : (best >= originalBeta) ? Bound::LOWER : Bound::EXACT;
+        if (table_.store(state.fingerprint(), best, remaining, bound, bestHeap, bestN))
+            ++counters_.replacements;
+        return best;
+    }
+
+private:
+    static float constexpr INFINITE_VALUE = std::numeric_limits<float>::infinity();
+
+    // Counts a node and stops the search if the budget has run out.
+    void countNode()
+    {
+        ++counters_.nodes;
+        if (counters_.nodes % NODES_PER_CHECK != 0)
+            return;
+
+        // The first iteration is never stopped, so that there is always a move to return
+        if (horizon_ <= 1)
+            return;
+
+        uint64_t counted = (budget_.counted += NODES_PER_CHECK);
+        if (budget_.nodeLimit > 0 && counted >= budget_.nodeLimit)
+            budget_.stopped = true;
+        if (budget_.timed && std::chrono::steady_clock::now() >= budget_.deadline)
+            budget_.stopped = true;
+    }
+
+    Rules const &                            rules_;        // The rules for the game being played
+    Evaluator const &                        evaluator_;    // Static evaluator for the leaves
+    Table &                                  table_;        // Transposition table
+    std::vector<typename Orderer::Killers> & killers_;      // Killer moves for each depth
+    SearchCounters &                         counters_;     // Work done by the search
+    SearchBudget &                           budget_;       // Budget for the search
+    int                                      horizon_;      // Depth at which states are evaluated instead of searched
+    bool                                     moveOrdering_; // Search winning replies and killer moves early
+};
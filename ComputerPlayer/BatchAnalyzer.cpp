@@ -0,0 +1,239 @@
+#include "BatchAnalyzer.h"
+
+#include "NimSearch.h"
+#include "NimSolver.h"
+#include "Position.h"
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "NimState/NimState.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Returns true if the player to move can force a win, using the solver.
+static bool isWin(Board const & board, Rules const & rules, NimSolver const & solver)
+{
+    // If the game is over, the player to move wins the misre variation, because the other player took the last object
+    if (board.empty())
+        return rules.variation() == Rules::Variation::MISERE;
+    return solver.winningMove(board).has_value();
+}
+
+// The data used by a single thread. A search and a solver are created for each variation the first time it is seen, and kept.
+class BatchAnalyzer::Worker
+{
+public:
+    // Constructor
+    explicit Worker(BatchAnalyzer & analyzer)
+        : analyzer_(analyzer)
+    {
+    }
+
+    // Returns the result of analyzing a position, as a line of JSON.
+    std::string analyze(Position const & position, uint64_t lineNumber);
+
+private:
+    // The engines for one variation
+    struct Engines
+    {
+        // Constructor
+        Engines(Rules const & rules, NimSearch::Settings const & settings)
+            : rules(rules)
+            , solver(rules)
+            , search(rules, settings)
+        {
+        }
+
+        Rules     rules;  // The rules of the variation
+        NimSolver solver; // Finds the winning moves
+        NimSearch search; // Chooses a move and reports the statistics
+    };
+
+    // Returns the engines for the variation of a position.
+    Engines & engines(Position const & position);
+
+    BatchAnalyzer &                                 analyzer_; // The analyzer, which holds the settings and the shared tables
+    std::map<std::string, std::unique_ptr<Engines>> engines_;  // The engines for each variation seen so far, by name
+};
+
+std::string BatchAnalyzer::Worker::analyze(Position const & position, uint64_t lineNumber)
+{
+    auto toJson = [](NimState::Move const & m) { return nlohmann::json{{"heap", m.i}, {"count", m.n}}; };
+
+    Engines &     engines = this->engines(position);
+    Rules const & rules   = engines.rules;
+    Board         board(position.heaps);
+
+    nlohmann::json line;
+    line["line"]      = lineNumber;
+    line["variation"] = Position::variationName(rules.variation());
+    if (rules.variation() == Rules::Variation::SUBTRACT && rules.isRange())
+        line["removalLimit"] = rules.removalLimit();
+    else if (rules.variation() == Rules::Variation::SUBTRACT)
+        line["subtractionSet"] = rules.subtractionSet();
+    line["player"] = (position.player == NimState::PlayerId::FIRST) ? "first" : "second";
+    line["board"]  = position.heaps;
+    line["result"] = isWin(board, rules, engines.solver) ? "win" : "loss";
+
+    // A move is winning if it leaves the opponent in a losing position
+    line["winningMoves"] = nlohmann::json::array();
+    for (int i = 0; i < static_cast<int>(board.size()); ++i)
+    {
+        int max = std::min(board.heap(i), rules.removalLimit());
+        for (int n = 1; n <= max; ++n)
+        {
+            if (!rules.allows(n))
+                continue;
+            Board response = board;
+            response.remove(i, n);
+            if (!isWin(response, rules, engines.solver))
+                line["winningMoves"].push_back(toJson(NimState::Move{static_cast<int8_t>(i), static_cast<int8_t>(n)}));
+        }
+    }
+
+    // The search is only done if there is a move to make
+    NimState state(board, rules, position.player, ZHash::Mode::CANONICAL);
+    if (state.isGameOver())
+        return line.dump();
+
+    NimState::Move           move  = engines.search.findBestMove(state);
+    SearchStatistics const & stats = engines.search.statistics();
+    line["move"]                   = toJson(move);
+    line["depth"]                  = engines.search.depthSearched();
+    line["nodes"]                  = stats.nodes;
+    line["probes"]                 = stats.probes;
+    line["hits"]                   = stats.hits;
+    line["evaluations"]            = stats.evaluations;
+    line["milliseconds"]           = stats.milliseconds;
+    return line.dump();
+}
+
+BatchAnalyzer::Worker::Engines & BatchAnalyzer::Worker::engines(Position const & position)
+{
+    std::string key = Position::rulesName(position.rules);
+    auto        it  = engines_.find(key);
+    if (it == engines_.end())
+    {
+        NimSearch::Settings settings = analyzer_.settings_;
+        settings.sharedTable         = analyzer_.sharedTable(position.rules);
+        it                           = engines_.emplace(key, std::make_unique<Engines>(position.rules, settings)).first;
+    }
+    return *it->second;
+}
+
+BatchAnalyzer::BatchAnalyzer(NimSearch::Settings const & settings, int jobs)
+    : settings_(settings)
+    , next_(0)
+{
+    assert(jobs > 0);
+    for (int i = 0; i < jobs; ++i)
+    {
+        workers_.push_back(std::make_unique<Worker>(*this));
+    }
+    results_.reserve(BLOCK_SIZE);
+}
+
+BatchAnalyzer::~BatchAnalyzer() = default;
+
+uint64_t BatchAnalyzer::run(std::istream & in, std::ostream & out)
+{
+    std::vector<std::string> lines(BLOCK_SIZE);
+    std::string              output;
+    uint64_t                 lineNumber = 1;
+    uint64_t                 analyzed   = 0;
+    while (true)
+    {
+        // Read a block of lines, reusing the strings of the previous block
+        size_t count = 0;
+        while (count < BLOCK_SIZE && std::getline(in, lines[count]))
+        {
+            ++count;
+        }
+        if (count == 0)
+            break;
+
+        // Analyze the block, on the calling thread and on a helper thread for each of the other workers
+        results_.assign(count, std::string());
+        next_ = 0;
+        std::vector<std::thread> helpers;
+        for (size_t i = 1; i < workers_.size(); ++i)
+        {
+            helpers.emplace_back(&BatchAnalyzer::analyzeLines, this, std::ref(*workers_[i]), std::cref(lines), lineNumber);
+        }
+        analyzeLines(*workers_[0], lines, lineNumber);
+        for (std::thread & helper : helpers)
+        {
+            helper.join();
+        }
+
+        // Write the results of the block all at once
+        output.clear();
+        for (std::string const & result : results_)
+        {
+            if (result.empty())
+                continue;
+            output += result;
+            output += '\n';
+            ++analyzed;
+        }
+        out.write(output.data(), static_cast<std::streamsize>(output.size()));
+        lineNumber += count;
+
+        // The entries of earlier blocks stay in the shared tables, but are replaced before the entries of later blocks
+        std::lock_guard<std::mutex> lock(tablesMutex_);
+        for (auto & table : sharedTables_)
+        {
+            table.second->age();
+        }
+    }
+    out.flush();
+    return analyzed;
+}
+
+void BatchAnalyzer::analyzeLines(Worker & worker, std::vector<std::string> const & lines, uint64_t firstLine)
+{
+    // Only the first results_.size() lines belong to the current block
+    Position position;
+    for (size_t i = next_++; i < results_.size(); i = next_++)
+    {
+        std::string const & line  = lines[i];
+        size_t              first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+
+        std::istringstream words(line);
+        std::string        error = Position::parse(words, position);
+        if (!error.empty())
+        {
+            results_[i] = nlohmann::json{{"line", firstLine + i}, {"error", error}}.dump();
+            continue;
+        }
+        results_[i] = worker.analyze(position, firstLine + i);
+    }
+}
+
+std::shared_ptr<SharedTranspositionTable> BatchAnalyzer::sharedTable(Rules const & rules)
+{
+    std::lock_guard<std::mutex>                 lock(tablesMutex_);
+    std::shared_ptr<SharedTranspositionTable> & table = sharedTables_[Position::rulesName(rules)];
+    if (!table)
+    {
+        size_t bytes = settings_.transpositionTableMegabytes * 1024 * 1024 * workers_.size();
+        table        = std::make_shared<SharedTranspositionTable>(bytes, settings_.hugePages);
+    }
+    return table;
+}
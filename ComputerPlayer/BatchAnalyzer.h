@@ -0,0 +1,61 @@
+#pragma once
+
+#include "NimSearch.h"
+#include "SharedTranspositionTable.h"
+
+#include "Components/Rules.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Analyzes positions read from a stream, without any interaction.
+//
+// Each line of the input is a Position, such as "normal first 1 3 5 7". Empty lines and lines starting with '#' are skipped.
+//
+// Each position is written to the output as one line of JSON, in the same order as the input. The line reports whether the
+// position is a win or a loss for the player to move, every winning move (found exactly from the nim-sum or the Grundy values),
+// the move chosen by an in-place search and the statistics of that search. A line that can't be parsed is reported with an
+// error instead, and the analysis continues.
+//
+// The input is read and the output is written in blocks of lines, and the positions of a block are spread across the worker
+// threads. Each thread keeps its own search for each variation from position to position, and the searches of a variation on
+// every thread share one transposition table, so each search finds what was learned from earlier positions on any thread. The
+// shared tables are aged after each block, so entries from recent blocks are kept over older ones.
+class BatchAnalyzer
+{
+public:
+    static size_t constexpr BLOCK_SIZE = 4096; // Number of lines read, analyzed and written at a time
+
+    // Constructor
+    BatchAnalyzer(NimSearch::Settings const & settings, int jobs);
+
+    // Destructor
+    ~BatchAnalyzer();
+
+    // Analyzes every position in the input, writing the results to the output. Returns the number of positions analyzed.
+    uint64_t run(std::istream & in, std::ostream & out);
+
+private:
+    class Worker; // The data used by a single thread
+
+    // Analyzes the lines of a block, taking the next unanalyzed one each time, until there are none left.
+    void analyzeLines(Worker & worker, std::vector<std::string> const & lines, uint64_t firstLine);
+
+    // Returns the table shared by the searches of a variation, creating it if needed. May be called from any thread.
+    std::shared_ptr<SharedTranspositionTable> sharedTable(Rules const & rules);
+
+    NimSearch::Settings                  settings_; // Settings for the searches
+    std::vector<std::unique_ptr<Worker>> workers_;  // Data for each thread
+    std::vector<std::string>             results_;  // The result of each line of the current block (empty if skipped)
+    std::atomic<size_t>                  next_;     // Index of the next line of the current block to be analyzed
+
+    std::mutex                                                       tablesMutex_;  // Guards sharedTables_
+    std::map<std::string, std::shared_ptr<SharedTranspositionTable>> sharedTables_; // Tables shared by the workers, by rules
+};
@@ -0,0 +1,206 @@
+#include "BigNimSolver.h"
+
+#include "Components/BigBoard.h"
+#include "Components/GrundyTable.h"
+#include "Components/OctalGame.h"
+#include "Components/Rules.h"
+
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+BigNimSolver::BigNimSolver(Rules rules)
+    : rules_(std::move(rules))
+{
+}
+
+std::optional<BigNimSolver::Move> BigNimSolver::winningMove(BigBoard const & board) const
+{
+    Summary summary = summarize(board);
+    if (summary.ones == 0 && summary.significant == 0)
+        return std::nullopt;
+
+    switch (rules_.variation())
+    {
+    case Rules::Variation::MISERE:
+        return winningMisereMove(board, summary);
+    case Rules::Variation::NORMAL:
+        return winningNormalMove(board, summary.sum);
+    case Rules::Variation::SUBTRACT:
+        return winningSubtractMove(board, summary.sum);
+    case Rules::Variation::OCTAL:
+        return winningOctalMove(board, summary.sum);
+    default:
+        assert(false && "Unknown variation");
+        return std::nullopt;
+    }
+}
+
+// Returns 1 if x is not 0, or 0 otherwise, without a comparison. SSE2 has no 64-bit comparisons, so this lets the loops below
+// be vectorized.
+static uint64_t nonZero(uint64_t x)
+{
+    return (x | (0 - x)) >> 63;
+}
+
+BigNimSolver::Summary BigNimSolver::summarize(BigBoard const & board) const
+{
+    // The loops have no branches and no early exits, so the compiler vectorizes them (all but the division by the period)
+    uint64_t sum         = 0;
+    uint64_t nonEmpty    = 0;
+    uint64_t significant = 0;
+    if (rules_.variation() == Rules::Variation::SUBTRACT && (!rules_.isRange() || !rules_.heapLimits().empty()))
+    {
+        // The Grundy values of an arbitrary subtraction set, or of heaps with limits of their own, are looked up in the tables,
+        // which the compiler doesn't vectorize
+        for (size_t i = 0; i < board.size(); ++i)
+        {
+            uint64_t n = board.heap(i);
+            sum ^= static_cast<uint64_t>(rules_.grundyTable(static_cast<int>(i))->value(n));
+            nonEmpty += nonZero(n);
+            significant += nonZero(n >> 1);
+        }
+    }
+    else if (OctalGame const * octal = rules_.octalGame())
+    {
+        for (uint64_t n : board)
+        {
+            assert(octal->isKnown(n));
+            sum ^= static_cast<uint64_t>(octal->value(n));
+            nonEmpty += nonZero(n);
+            significant += nonZero(n >> 1);
+        }
+    }
+    else if (rules_.variation() == Rules::Variation::SUBTRACT)
+    {
+        uint64_t period = static_cast<uint64_t>(rules_.removalLimit()) + 1;
+        for (uint64_t n : board)
+        {
+            sum ^= n % period;
+            nonEmpty += nonZero(n);
+            significant += nonZero(n >> 1);
+        }
+    }
+    else
+    {
+        for (uint64_t n : board)
+        {
+            sum ^= n;
+            nonEmpty += nonZero(n);
+            significant += nonZero(n >> 1);
+        }
+    }
+    return Summary{sum, nonEmpty - significant, significant};
+}
+
+std::optional<BigNimSolver::Move> BigNimSolver::winningMisereMove(BigBoard const & board, Summary const & summary) const
+{
+    // If all the heaps have at most 1 object, then the player who faces an odd number of them loses. The winning move (if the
+    // number is even) is to take one of them.
+    if (summary.significant == 0)
+    {
+        if (summary.ones % 2 != 0)
+            return std::nullopt;
+        for (size_t i = 0; i < board.size(); ++i)
+        {
+            if (board.heap(i) == 1)
+                return Move{i, 1};
+        }
+        assert(false && "A non-empty board must have a heap with 1 object");
+    }
+
+    // If exactly one heap has more than 1 object, then the position is always a win. Reduce that heap to 0 or 1 so that an odd
+    // number of heaps with 1 object remain.
+    if (summary.significant == 1)
+    {
+        uint64_t target = (summary.ones % 2 != 0) ? 0 : 1;
+        for (size_t i = 0; i < board.size(); ++i)
+        {
+            if (board.heap(i) > 1)
+                return Move{i, board.heap(i) - target};
+        }
+        assert(false && "The heap with more than 1 object must exist");
+    }
+
+    // Otherwise, play as in the normal variation.
+    return winningNormalMove(board, summary.sum);
+}
+
+std::optional<BigNimSolver::Move> BigNimSolver::winningNormalMove(BigBoard const & board, uint64_t sum) const
+{
+    if (sum == 0)
+        return std::nullopt;
+
+    // There is always a heap containing the highest bit of the nim-sum. Reducing it to (heap ^ sum) makes the nim-sum 0.
+    for (size_t i = 0; i < board.size(); ++i)
+    {
+        uint64_t n      = board.heap(i);
+        uint64_t target = n ^ sum;
+        if (target < n)
+            return Move{i, n - target};
+    }
+    assert(false && "A non-zero nim-sum must have a winning move");
+    return std::nullopt;
+}
+
+std::optional<BigNimSolver::Move> BigNimSolver::winningSubtractMove(BigBoard const & board, uint64_t sum) const
+{
+    if (sum == 0)
+        return std::nullopt;
+
+    if (!rules_.isRange() || !rules_.heapLimits().empty())
+    {
+        // As in the normal variation, there is a heap whose Grundy value contains the highest bit of the sum, and a move reduces
+        // the Grundy value of a heap to any smaller value
+        for (size_t i = 0; i < board.size(); ++i)
+        {
+            GrundyTable const * table  = rules_.grundyTable(static_cast<int>(i));
+            uint64_t            from   = board.heap(i);
+            uint64_t            target = static_cast<uint64_t>(table->value(from)) ^ sum;
+            if (target >= static_cast<uint64_t>(table->value(from)))
+                continue;
+            for (int n : rules_.subtractionSet())
+            {
+                if (static_cast<uint64_t>(n) > from || n > rules_.removalLimit(static_cast<int>(i)))
+                    break;
+                if (static_cast<uint64_t>(table->value(from - n)) == target)
+                    return Move{i, static_cast<uint64_t>(n)};
+            }
+        }
+        assert(false && "A non-zero Grundy value must have a winning move");
+        return std::nullopt;
+    }
+
+    // As in the normal variation, there is a heap whose Grundy value contains the highest bit of the sum. Its Grundy value is
+    // reduced by removing the difference, which is at most the removal limit.
+    uint64_t period = static_cast<uint64_t>(rules_.removalLimit()) + 1;
+    for (size_t i = 0; i < board.size(); ++i)
+    {
+        uint64_t value  = board.heap(i) % period;
+        uint64_t target = value ^ sum;
+        if (target < value)
+            return Move{i, value - target};
+    }
+    assert(false && "A non-zero Grundy value must have a winning move");
+    return std::nullopt;
+}
+
+std::optional<BigNimSolver::Move> BigNimSolver::winningOctalMove(BigBoard const & board, uint64_t sum) const
+{
+    if (sum == 0)
+        return std::nullopt;
+
+    // As in the subtraction variation, except that the move may split the heap, and a move may increase the Grundy value of a
+    // heap, so every heap is tried
+    OctalGame const * octal = rules_.octalGame();
+    for (size_t i = 0; i < board.size(); ++i)
+    {
+        uint64_t from   = board.heap(i);
+        int      target = octal->value(from) ^ static_cast<int>(sum);
+        if (std::optional<OctalGame::Move> reply = octal->reply(from, target))
+            return Move{i, reply->n, reply->split};
+    }
+    assert(false && "A non-zero Grundy value must have a winning move");
+    return std::nullopt;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Components/Rules.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+class BigBoard;
+
+// Computes perfect play for a game of Big Nim directly from the nim-sum of the board, like NimSolver.
+//
+// The board is summarized in a single pass that only XORs and counts, which the compiler vectorizes. Finding the winning move
+// then takes at most one more pass, which stops at the first heap that works. Nothing is stored for each heap. In the subtraction
+// variation, the Grundy value of a heap of n objects is n mod (removal limit + 1), so no Grundy table is needed either, unless
+// the subtraction set is not a range or the heaps have removal limits of their own. Then the values are looked up in the
+// periodic Grundy tables of the rules. The values of an octal game are looked up the same way, and must be known for the size of
+// every heap (see OctalGame::isKnown()).
+class BigNimSolver
+{
+public:
+    // A move
+    struct Move
+    {
+        size_t   i;         // Index of the heap
+        uint64_t n;         // Number of objects removed
+        uint64_t split = 0; // Number of objects of the rest moved to a new heap, in an octal game
+    };
+
+    // Constructor
+    explicit BigNimSolver(Rules rules);
+
+    // Returns the winning move for the player to move, or std::nullopt if the position is lost (or the game is over).
+    std::optional<Move> winningMove(BigBoard const & board) const;
+
+private:
+    // The values computed by a pass over the board
+    struct Summary
+    {
+        uint64_t sum;         // Nim-sum (or the XOR of the Grundy values) of the heaps
+        uint64_t ones;        // Number of heaps with exactly 1 object
+        uint64_t significant; // Number of heaps with more than 1 object
+    };
+
+    Summary             summarize(BigBoard const & board) const;
+    std::optional<Move> winningMisereMove(BigBoard const & board, Summary const & summary) const;
+    std::optional<Move> winningNormalMove(BigBoard const & board, uint64_t sum) const;
+    std::optional<Move> winningSubtractMove(BigBoard const & board, uint64_t sum) const;
+    std::optional<Move> winningOctalMove(BigBoard const & board, uint64_t sum) const;
+
+    Rules rules_; // The rules for the game being played
+};
@@ -1,5 +1,6 @@
 #include "ComputerPlayer.h"
 
+#include "MoveOrderer.h"
 #include "NimEvaluator.h"
 
 #include "Components/Board.h"
@@ -8,33 +9,100 @@
 #include "GamePlayer/TranspositionTable.h"
 #include "NimState/NimState.h"
 
+#include <nlohmann/json.hpp>
+
 #include <algorithm>
 #include <cassert>
-#include <ctime>
+#include <chrono>
+#include <fstream>
 #include <functional>
-#include <iterator>
-#include <utility>
+#include <optional>
+#include <ostream>
 #include <vector>
 
-static const int TRANSPOSITION_TABLE_SIZE = 100000; // Limits memory usage of the transposition table
-static const int MAXIMUM_DEPTH            = 10;     // Determines how good the AI is and how long it takes to respond
+namespace
+{
+
+// A static evaluator that counts the states it evaluates
+class CountingEvaluator : public NimEvaluator
+{
+public:
+    CountingEvaluator(Rules rules, uint64_t & count)
+        : NimEvaluator(std::move(rules))
+        , count_(count)
+    {
+    }
+
+    using NimEvaluator::evaluate;
+
+    virtual float evaluate(GamePlayer::GameState const & state) const override
+    {
+        ++count_;
+        return NimEvaluator::evaluate(state);
+    }
+
+private:
+    uint64_t & count_; // Number of states evaluated
+};
+
+// Returns the engine that plays the given rules. The subtraction variation is always played by the solver, and octal games by
+// the solver or the game tree search, which can split heaps.
+ComputerPlayer::Engine chooseEngine(Rules const & rules, ComputerPlayer::Engine engine)
+{
+    if (rules.variation() == Rules::Variation::SUBTRACT)
+        return ComputerPlayer::Engine::SOLVER;
+    if (rules.variation() == Rules::Variation::OCTAL && engine == ComputerPlayer::Engine::IN_PLACE)
+        return ComputerPlayer::Engine::SOLVER;
+    return engine;
+}
+
+// Returns the number of milliseconds since the given time
+double elapsedMilliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+// Approximate size of an entry in the game tree's transposition table, for converting the memory budget into a number of entries
+static size_t const GAME_TREE_ENTRY_SIZE = 16;
 
-ComputerPlayer::ComputerPlayer(NimState::PlayerId playerId, Rules const & rules /*= Rules()*/)
+ComputerPlayer::ComputerPlayer(NimState::PlayerId          playerId,
+                               Rules const &               rules,
+                               Engine                      engine /*= Engine::DEFAULT*/,
+                               NimSearch::Settings const & settings /*= NimSearch::Settings()*/)
     : Player(playerId, rules)
+    , engine_(chooseEngine(rules, engine))
+    , solver_(rules, settings.seed)
     , gameTree_(nullptr)
     , staticEvaluator_(nullptr)
     , transpositionTable_(nullptr)
+    , maxDepth_(settings.maxDepth)
+    , telemetry_(nullptr)
 {
-    staticEvaluator_    = std::make_shared<NimEvaluator>(rules);
-    transpositionTable_ = std::make_shared<GamePlayer::TranspositionTable>(TRANSPOSITION_TABLE_SIZE, MAXIMUM_DEPTH);
-    gameTree_           = new GamePlayer::GameTree(transpositionTable_,
-                                         staticEvaluator_,
-                                         std::bind(&ComputerPlayer::responseGenerator,
-                                                   this,
-                                                   std::placeholders::_1,
-                                                   std::placeholders::_2),
-                                         MAXIMUM_DEPTH);
-    std::srand(static_cast<unsigned int>(std::time(nullptr))); // Seed the random number generator
+    // Only the engine being used is set up
+    if (engine_ == Engine::SEARCH)
+    {
+        staticEvaluator_    = std::make_shared<CountingEvaluator>(rules, statistics_.evaluations);
+        size_t entries      = settings.transpositionTableMegabytes * 1024 * 1024 / GAME_TREE_ENTRY_SIZE;
+        transpositionTable_ = std::make_shared<GamePlayer::TranspositionTable>(entries, settings.maxDepth);
+        gameTree_           = new GamePlayer::GameTree(transpositionTable_,
+                                             staticEvaluator_,
+                                             std::bind(&ComputerPlayer::responseGenerator,
+                                                       this,
+                                                       std::placeholders::_1,
+                                                       std::placeholders::_2),
+                                             settings.maxDepth);
+    }
+    else if (engine_ == Engine::IN_PLACE)
+    {
+        search_ = std::make_unique<NimSearch>(rules, settings);
+    }
+}
+
+ComputerPlayer::~ComputerPlayer()
+{
+    delete gameTree_;
 }
 
 void ComputerPlayer::move(NimState * pState)
@@ -43,60 +111,162 @@ void ComputerPlayer::move(NimState * pState)
     assert(pState->whoseTurn() == playerId_);
     assert(pState->isGameOver() == false);
 
-    // Find the best response to the current state
-    auto pCopy = std::make_shared<NimState>(*pState);
+    auto           start = std::chrono::steady_clock::now();
+    NimState::Move move;
+    statistics_.tablebase = false;
+
+    // A winning move in the tablebase is played without using the engine
+    std::optional<NimState::Move> known = probeTablebase(pState->board());
+    if (known)
+    {
+        statistics_.clear();
+        statistics_.tablebase = true;
+        move                  = *known;
+        statistics_.principalVariation.push_back(move);
+        statistics_.milliseconds = elapsedMilliseconds(start);
+    }
+    else
+    {
+        switch (engine_)
+        {
+        case Engine::SOLVER:
+            // The solver doesn't need to search
+            statistics_.clear();
+            move = solver_.bestMove(pState->board());
+            statistics_.principalVariation.push_back(move);
+            statistics_.milliseconds = elapsedMilliseconds(start);
+            break;
+
+        case Engine::IN_PLACE:
+            // The in-place search makes and undoes moves on its own copy of the state, and collects its own statistics
+            move = search_->findBestMove(*pState);
+            break;
+
+        default:
+            move                     = searchGameTree(*pState);
+            statistics_.milliseconds = elapsedMilliseconds(start);
+            break;
+        }
+    }
+
+    if (telemetry_)
+        writeTelemetry(*telemetry_, pState->board(), move);
+    pState->move(move.i, move.n, move.split);
+}
+
+void ComputerPlayer::clearTranspositionTable()
+{
+    if (search_)
+        search_->clearTranspositionTable();
+}
+
+bool ComputerPlayer::saveTranspositionTable(std::string const & path) const
+{
+    if (!search_)
+        return false;
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    return out && search_->saveTranspositionTable(out);
+}
+
+bool ComputerPlayer::loadTranspositionTable(std::string const & path)
+{
+    if (!search_)
+        return false;
+    std::ifstream in(path, std::ios::binary);
+    return in && search_->loadTranspositionTable(in);
+}
+
+std::optional<NimState::Move> ComputerPlayer::probeTablebase(Board const & board) const
+{
+    if (!tablebase_ || tablebase_->variation() != rules_.variation())
+        return std::nullopt;
+    std::optional<Tablebase::Result> result = tablebase_->probe(board);
+    if (!result || !result->win)
+        return std::nullopt;
+    return result->move;
+}
+
+NimState::Move ComputerPlayer::searchGameTree(NimState const & state)
+{
+    auto start = std::chrono::steady_clock::now();
+    statistics_.clear();
+
+    // Find the best response to the current state. The search uses canonical hashing because the order of the heaps doesn't
+    // affect the value of a state, so permutations of a board can share entries in the transposition table.
+    auto pCopy = std::make_shared<NimState>(state.board(), rules_, state.whoseTurn(), ZHash::Mode::CANONICAL);
     gameTree_->findBestResponse(std::static_pointer_cast<GamePlayer::GameState>(pCopy));
-    auto pResponse = std::dynamic_pointer_cast<NimState>(pCopy->response_);
-    assert(pResponse);
-    *pState = *pResponse;
+
+    // The principal variation is the chain of best responses
+    for (auto pResponse = std::dynamic_pointer_cast<NimState>(pCopy->response_); pResponse;
+         pResponse      = std::dynamic_pointer_cast<NimState>(pResponse->response_))
+    {
+        assert(pResponse->lastMove().has_value());
+        statistics_.principalVariation.push_back(pResponse->lastMove().value());
+    }
+    assert(!statistics_.principalVariation.empty());
+    statistics_.iterations.push_back({maxDepth_, statistics_.nodes, elapsedMilliseconds(start), true});
+    return statistics_.principalVariation.front();
+}
+
+void ComputerPlayer::writeTelemetry(std::ostream & out, Board const & board, NimState::Move const & move) const
+{
+    static char const * const ENGINE_NAMES[] = {"search", "solver", "in-place"};
+
+    auto toJson = [](NimState::Move const & m)
+    {
+        nlohmann::json json{{"heap", m.i}, {"count", m.n}};
+        if (m.split > 0)
+            json["split"] = m.split;
+        return json;
+    };
+
+    SearchStatistics const & stats = statistics();
+    nlohmann::json           line;
+    line["player"]          = (playerId_ == NimState::PlayerId::FIRST) ? "first" : "second";
+    line["engine"]          = ENGINE_NAMES[static_cast<int>(engine_)];
+    line["board"]           = board.heaps();
+    line["move"]            = toJson(move);
+    line["nodes"]           = stats.nodes;
+    line["probes"]          = stats.probes;
+    line["hits"]            = stats.hits;
+    line["stores"]          = stats.stores;
+    line["replacements"]    = stats.replacements;
+    line["evaluations"]     = stats.evaluations;
+    line["branchingFactor"] = stats.branchingFactor;
+    line["milliseconds"]    = stats.milliseconds;
+    line["tablebase"]       = stats.tablebase;
+    line["iterations"]      = nlohmann::json::array();
+    for (auto const & iteration : stats.iterations)
+    {
+        line["iterations"].push_back({{"depth", iteration.depth},
+                                      {"nodes", iteration.nodes},
+                                      {"milliseconds", iteration.milliseconds},
+                                      {"completed", iteration.completed}});
+    }
+    line["principalVariation"] = nlohmann::json::array();
+    for (auto const & m : stats.principalVariation)
+    {
+        line["principalVariation"].push_back(toJson(m));
+    }
+    out << line.dump() << std::endl;
 }
 
 std::vector<GamePlayer::GameState *> ComputerPlayer::responseGenerator(GamePlayer::GameState const & state, int depth)
 {
+    ++statistics_.nodes;
+
     std::vector<GamePlayer::GameState *> responses;
     auto const &                         nimState = dynamic_cast<NimState const &>(state);
     Board const &                        board    = nimState.board();
-    std::vector<int8_t> const &          heaps    = board.heaps();
 
-    if (rules_.variation() == Rules::Variation::SUBTRACT)
+    // Generate all possible responses, excluding duplicates, with the winning replies first
+    MoveOrderer::Killers none{};
+    MoveOrderer          moves(board, rules_, MoveOrderer::Hint(), &none);
+    while (std::optional<NimState::Move> move = moves.next())
     {
-        // In the subtraction variation, only one heap is used
-        assert(heaps.size() == 1);
-        int max = std::min(static_cast<int>(heaps[0]), rules_.removalLimit());
-        for (int n = 1; n <= max; ++n)
-        {
-            NimState * pResponse = new NimState(nimState);
-            pResponse->move(0, n);
-            responses.push_back(pResponse);
-        }
-    }
-    else
-    {
-        // Get a list of unique heaps to consider in order to avoid duplicate moves on heaps with the same number of objects
-        std::vector<std::pair<int, int>> distinctHeaps;
-        for (size_t i = 0; i < heaps.size(); ++i)
-        {
-            distinctHeaps.emplace_back(heaps[i], static_cast<int>(i)); // (n, i) to make sorting easier
-        }
-        std::sort(distinctHeaps.begin(), distinctHeaps.end());
-        auto last = std::unique(distinctHeaps.begin(),
-                                distinctHeaps.end(),
-                                [](auto const & a, auto const & b) { return a.first == b.first; });
-        distinctHeaps.erase(last, distinctHeaps.end());
-
-        // Generate all possible responses, excluding duplicates
-        for (auto const & [size, i] : distinctHeaps)
-        {
-            if (size > 0) // Only consider heaps with objects
-            {
-                for (int n = 1; n <= size; ++n) // Remove 1 to all objects in the heap
-                {
-                    NimState * pResponse = new NimState(nimState);
-                    pResponse->move(i, n);
-                    responses.push_back(pResponse);
-                }
-            }
-        }
+        NimState * pResponse = new NimState(nimState);
+        pResponse->move(move->i, move->n, move->split);
+        responses.push_back(pResponse);
     }
     return responses;
 }
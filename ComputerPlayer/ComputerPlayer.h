@@ -2,9 +2,17 @@
 
 #include "Components/Player.h"
 #include "Components/Rules.h"
+#include "NimSearch.h"
+#include "NimSolver.h"
+#include "SearchStatistics.h"
+#include "Tablebase.h"
 #include "NimState/NimState.h"
 
+#include <cstdint>
+#include <iosfwd>
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace GamePlayer
@@ -17,19 +25,86 @@ class TranspositionTable;
 class ComputerPlayer : public Player
 {
 public:
-    // Constructor
-    explicit ComputerPlayer(NimState::PlayerId playerId, Rules const & rules);
+    // Methods for choosing a move
+    enum class Engine
+    {
+        SEARCH = 0,      // Search the game tree
+        SOLVER,          // Compute the best move directly from the nim-sum
+        IN_PLACE,        // Search the game tree in place on a single state
+        DEFAULT = SEARCH // Default engine
+    };
+
+    // Constructor. The subtraction variation is always played by Engine::SOLVER, from the Grundy values of the heaps, because they
+    // are exact and the heaps may have removal limits of their own, which the searches don't tell apart. If Engine::IN_PLACE is
+    // requested for an octal game, Engine::SOLVER is used instead, because that search doesn't split heaps.
+    explicit ComputerPlayer(NimState::PlayerId          playerId,
+                            Rules const &               rules,
+                            Engine                      engine   = Engine::DEFAULT,
+                            NimSearch::Settings const & settings = NimSearch::Settings());
+
+    // Destructor
+    ~ComputerPlayer() override;
 
     // Noncopyable
     ComputerPlayer(ComputerPlayer const &) = delete;
 
     // Makes a move on the game state. Overrides Player::move().
-    void ComputerPlayer::move(NimState * pState) override;
+    void move(NimState * pState) override;
+
+    // Returns the engine used to choose a move, which may not be the one requested.
+    Engine engine() const { return engine_; }
+
+    // Returns the number of nodes visited by the last move.
+    uint64_t nodesSearched() const { return statistics().nodes; }
+
+    // Returns the statistics collected by the last move. Engine::SEARCH counts the states it expands as nodes, and doesn't report
+    // transposition table statistics. Engine::SOLVER and moves found in the tablebase only report the time and the move.
+    SearchStatistics const & statistics() const
+    {
+        return (search_ && !statistics_.tablebase) ? search_->statistics() : statistics_;
+    }
+
+    // Discards what the in-place search learned in earlier moves, e.g. between games. Takes constant time. The other engines are
+    // not affected.
+    void clearTranspositionTable();
+
+    // Saves what the in-place search has learned to a snapshot file. Returns false if the engine is not Engine::IN_PLACE or the
+    // file can't be written.
+    bool saveTranspositionTable(std::string const & path) const;
+
+    // Adds the states in a snapshot file saved by an earlier player of the same game to the in-place search's transposition table.
+    // Returns false if the engine is not Engine::IN_PLACE, or if the file can't be read or is not compatible.
+    bool loadTranspositionTable(std::string const & path);
+
+    // Uses the given tablebase to find winning moves before the engine is used, or stops if it is nullptr. The tablebase is
+    // ignored if it solves a different variation.
+    void setTablebase(std::shared_ptr<Tablebase const> tablebase) { tablebase_ = std::move(tablebase); }
+
+    // Writes the statistics of each move as one line of JSON to the given stream, or stops if it is nullptr. The stream must
+    // outlive the player or be replaced.
+    void setTelemetry(std::ostream * out) { telemetry_ = out; }
+
+    // Returns the responses to a state, with the most promising first. Used by the game tree, which takes ownership of them.
+    std::vector<GamePlayer::GameState *> responseGenerator(GamePlayer::GameState const & state, int depth);
 
 private:
+    Engine                                          engine_;             // Method for choosing a move
+    NimSolver                                       solver_;             // Solver used by Engine::SOLVER
+    std::unique_ptr<NimSearch>                      search_;             // Search used by Engine::IN_PLACE
     GamePlayer::GameTree *                          gameTree_;           // Game tree for searching responses
     std::shared_ptr<GamePlayer::StaticEvaluator>    staticEvaluator_;    // Static evaluator for the game tree
     std::shared_ptr<GamePlayer::TranspositionTable> transpositionTable_; // Transposition table for the game tree
+    int                                             maxDepth_;           // Maximum depth searched by the game tree
+    SearchStatistics                                statistics_;         // Statistics for Engine::SEARCH and Engine::SOLVER
+    std::ostream *                                  telemetry_;          // Stream for the telemetry, or nullptr if none
+    std::shared_ptr<Tablebase const>                tablebase_;          // Tablebase probed before the engine, or nullptr
 
-    std::vector<GamePlayer::GameState *> responseGenerator(GamePlayer::GameState const & state, int depth);
+    // Returns the winning move found in the tablebase, or std::nullopt if the state is not a known win.
+    std::optional<NimState::Move> probeTablebase(Board const & board) const;
+
+    // Returns the best move found by searching the game tree.
+    NimState::Move searchGameTree(NimState const & state);
+
+    // Writes the statistics of the last move as a line of JSON.
+    void writeTelemetry(std::ostream & out, Board const & board, NimState::Move const & move) const;
 };
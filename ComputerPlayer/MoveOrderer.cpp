@@ -0,0 +1,205 @@
+#include "MoveOrderer.h"
+
+#include "Components/Board.h"
+#include "Components/GrundyTable.h"
+#include "Components/OctalGame.h"
+#include "Components/Rules.h"
+#include "NimState/MoveGenerator.h"
+#include "NimState/NimState.h"
+
+#include <algorithm>
+#include <cassert>
+#include <optional>
+
+MoveOrderer::MoveOrderer(Board const & board, Rules const & rules, Hint best /*= Hint()*/, Killers const * killers /*= nullptr*/)
+    : board_(board)
+    , rules_(rules)
+    , best_(best)
+    , killers_(killers)
+    , stage_(Stage::BEST)
+    , i_(0)
+    , sum_(0)
+    , sizes_{0, 0}
+    , moves_(board, rules)
+    , promotedCount_(0)
+{
+}
+
+std::optional<NimState::Move> MoveOrderer::next()
+{
+    while (true)
+    {
+        switch (stage_)
+        {
+        case Stage::BEST:
+        {
+            stage_ = killers_ ? Stage::WINNING : Stage::REMAINING;
+
+            // The sum is needed by the next stage
+            if (stage_ == Stage::WINNING)
+            {
+                if (rules_.variation() == Rules::Variation::SUBTRACT)
+                {
+                    for (int i = 0; i < static_cast<int>(board_.size()); ++i)
+                    {
+                        sum_ ^= rules_.grundyTable(i)->value(board_.heap(i));
+                    }
+                }
+                else if (OctalGame const * octal = rules_.octalGame())
+                {
+                    for (int n : board_)
+                    {
+                        sum_ ^= octal->value(n);
+                    }
+                }
+                else
+                {
+                    sum_ = board_.nimSum();
+                }
+            }
+
+            if (std::optional<NimState::Move> move = resolve(best_))
+                return promote(*move);
+            break;
+        }
+
+        case Stage::WINNING:
+        {
+            // There are no winning replies if the sum is already zero
+            while (sum_ != 0 && i_ < static_cast<int>(board_.size()))
+            {
+                std::optional<NimState::Move> move = winningReply(i_++);
+                if (move && !promoted(*move))
+                    return promote(*move);
+            }
+            stage_ = Stage::KILLERS;
+            i_     = 0;
+            break;
+        }
+
+        case Stage::KILLERS:
+        {
+            while (i_ < static_cast<int>(killers_->size()))
+            {
+                std::optional<NimState::Move> move = resolve((*killers_)[i_++]);
+                if (move && !promoted(*move))
+                    return promote(*move);
+            }
+            stage_ = Stage::REMAINING;
+            break;
+        }
+
+        case Stage::REMAINING:
+        {
+            while (std::optional<NimState::Move> move = moves_.next())
+            {
+                if (!promoted(*move))
+                    return move;
+            }
+            stage_ = Stage::DONE;
+            break;
+        }
+
+        case Stage::DONE:
+            return std::nullopt;
+        }
+    }
+}
+
+MoveOrderer::Hint MoveOrderer::hint(Board const & board, NimState::Move const & move)
+{
+    return Hint{static_cast<int8_t>(board.heap(move.i)), move.n};
+}
+
+void MoveOrderer::addKiller(Killers & killers, Hint move)
+{
+    if (killers[0].heap == move.heap && killers[0].n == move.n)
+        return;
+    std::copy_backward(killers.begin(), killers.end() - 1, killers.end());
+    killers[0] = move;
+}
+
+std::optional<NimState::Move> MoveOrderer::winningReply(int i)
+{
+    // Only the first of the heaps with the same size and limit is considered, matching MoveGenerator
+    int size = board_.heap(i);
+    if (size == 0)
+        return std::nullopt;
+    if (!rules_.heapLimits().empty())
+    {
+        if (MoveGenerator::repeatsEarlierHeap(board_, rules_.heapLimits(), i))
+            return std::nullopt;
+    }
+    else
+    {
+        uint64_t & word = sizes_[size / 64];
+        uint64_t   bit  = uint64_t(1) << (size % 64);
+        if (word & bit)
+            return std::nullopt;
+        word |= bit;
+    }
+
+    if (rules_.variation() == Rules::Variation::SUBTRACT)
+    {
+        // The reply must leave the heap with a Grundy value that cancels the Grundy values of the other heaps
+        GrundyTable const * table  = rules_.grundyTable(i);
+        int                 target = table->value(size) ^ sum_;
+        for (int n : rules_.subtractionSet())
+        {
+            if (n > size || n > rules_.removalLimit(i))
+                break;
+            if (table->value(size - n) == target)
+                return NimState::Move{static_cast<int8_t>(i), static_cast<int8_t>(n)};
+        }
+        return std::nullopt;
+    }
+
+    if (OctalGame const * octal = rules_.octalGame())
+    {
+        // The reply must leave one or two heaps whose Grundy values cancel the Grundy values of the other heaps
+        std::optional<OctalGame::Move> reply = octal->reply(size, octal->value(size) ^ sum_);
+        if (!reply)
+            return std::nullopt;
+        return NimState::Move{static_cast<int8_t>(i), static_cast<int8_t>(reply->n), static_cast<int8_t>(reply->split)};
+    }
+
+    // The reply must leave the heap with a size that cancels the nim-sum of the other heaps
+    int target = size ^ sum_;
+    if (target >= size)
+        return std::nullopt;
+    return NimState::Move{static_cast<int8_t>(i), static_cast<int8_t>(size - target)};
+}
+
+std::optional<NimState::Move> MoveOrderer::resolve(Hint hint) const
+{
+    if (hint.heap <= 0 || hint.n < 1 || hint.n > hint.heap)
+        return std::nullopt;
+    if (!rules_.allows(hint.n))
+        return std::nullopt;
+
+    // A hint doesn't split a heap, so it is only legal in an octal game if the move doesn't have to
+    if (rules_.octalGame() && !rules_.octalGame()->isLegal(hint.heap, hint.n, 0))
+        return std::nullopt;
+    for (int i = 0; i < static_cast<int>(board_.size()); ++i)
+    {
+        if (board_.heap(i) == hint.heap && hint.n <= rules_.removalLimit(i))
+            return NimState::Move{static_cast<int8_t>(i), hint.n};
+    }
+    return std::nullopt;
+}
+
+std::optional<NimState::Move> MoveOrderer::promote(NimState::Move const & move)
+{
+    assert(promotedCount_ < MAX_PROMOTED);
+    promotedMoves_[promotedCount_++] = move;
+    return move;
+}
+
+bool MoveOrderer::promoted(NimState::Move const & move) const
+{
+    auto end = promotedMoves_.begin() + promotedCount_;
+    return std::find_if(promotedMoves_.begin(),
+                        end,
+                        [&move](NimState::Move const & m)
+                        { return m.i == move.i && m.n == move.n && m.split == move.split; }) != end;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "NimState/MoveGenerator.h"
+#include "NimState/NimState.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+// Returns the moves for a board with the most promising moves first, without creating the resulting states.
+//
+// The moves are returned in stages:
+//   1. The best move found by an earlier search of the same state (e.g. from a transposition table)
+//   2. Winning replies, which leave a nim-sum of zero (or a Grundy sum of zero in the subtraction variation and octal games)
+//   3. Killer moves, which caused cutoffs in other states at the same depth
+//   4. All the other moves, in the order generated by MoveGenerator
+// Each move is returned only once. If no killer moves are given, stages 2 and 3 are skipped. The board must not change while
+// moves are being returned, except by moves that have been undone.
+class MoveOrderer
+{
+public:
+    // A move identified by the size of its heap rather than the heap's index, so that it applies to any permutation of a board. A
+    // value-initialized hint (heap size 0) is no move.
+    struct Hint
+    {
+        int8_t heap; // Size of the heap
+        int8_t n;    // Number of objects removed
+    };
+
+    // Killer moves for one depth
+    using Killers = std::array<Hint, 2>;
+
+    // Constructor
+    MoveOrderer(Board const & board, Rules const & rules, Hint best = Hint(), Killers const * killers = nullptr);
+
+    // Returns the next move, or std::nullopt if there are no more moves.
+    std::optional<NimState::Move> next();
+
+    // Returns the hint for a move on the given board.
+    static Hint hint(Board const & board, NimState::Move const & move);
+
+    // Adds a move to the killer moves, replacing the oldest one.
+    static void addKiller(Killers & killers, Hint move);
+
+private:
+    // Stages of move ordering
+    enum class Stage
+    {
+        BEST = 0,
+        WINNING,
+        KILLERS,
+        REMAINING,
+        DONE
+    };
+
+    // Maximum number of moves returned before the last stage
+    static int constexpr MAX_PROMOTED = 1 + Board::MAX_HEAPS + std::tuple_size<Killers>::value;
+
+    // Returns the winning reply on heap i, if there is one and no earlier heap has the same size.
+    std::optional<NimState::Move> winningReply(int i);
+
+    // Returns the move corresponding to a hint, if the move is legal.
+    std::optional<NimState::Move> resolve(Hint hint) const;
+
+    // Remembers a move so that it is not returned again, and returns it.
+    std::optional<NimState::Move> promote(NimState::Move const & move);
+
+    // Returns true if the move has already been returned.
+    bool promoted(NimState::Move const & move) const;
+
+    Board const &                            board_;         // The board
+    Rules const &                            rules_;         // The rules of the game
+    Hint                                     best_;          // Best move from an earlier search
+    Killers const *                          killers_;       // Killer moves (or nullptr if there are none)
+    Stage                                    stage_;         // Current stage
+    int                                      i_;             // Index of the next heap or killer in the current stage
+    int                                      sum_;           // Nim-sum (or Grundy sum) of the board
+    uint64_t                                 sizes_[2];      // Bit set of the sizes of heaps seen in the winning stage
+    MoveGenerator                            moves_;         // Generates the moves for the last stage
+    std::array<NimState::Move, MAX_PROMOTED> promotedMoves_; // Moves returned before the last stage
+    int                                      promotedCount_; // Number of moves returned before the last stage
+};
@@ -1,15 +1,18 @@
 #pragma once
 
+#include "Components/GrundyTable.h"
+#include "Components/OctalGame.h"
 #include "Components/Rules.h"
 #include "GamePlayer/StaticEvaluator.h"
+#include "NimState/NimState.h"
+
+#include <cassert>
 
 namespace GamePlayer
 {
 class GameState;
 }
 
-class NimState;
-
 // A static evaluation function for tic-tac-toe.
 class NimEvaluator : public GamePlayer::StaticEvaluator
 {
@@ -23,6 +26,14 @@ public:
     // Returns a value for the given state. Overrides StaticEvaluator::evaluate().
     virtual float evaluate(GamePlayer::GameState const & state) const override;
 
+    // Returns a value for the given state. This is used directly by searches that already have a NimState.
+    float evaluate(NimState const & state) const;
+
+    // Returns a value for the given state of variation V, which must be the variation being played. This is used by searches that
+    // choose the variation at compile time, so that the evaluation can be inlined.
+    template <Rules::Variation V>
+    float evaluate(NimState const & state) const;
+
     // Returns the value of a winning state for the first player. Overrides StaticEvaluator::firstPlayerWinsValue().
     virtual float firstPlayerWinsValue() const override { return WIN_VALUE; }
 
@@ -37,6 +48,103 @@ private:
     float evaluateMisere(NimState const & state) const;
     float evaluateNormal(NimState const & state) const;
     float evaluateSubtract(NimState const & state) const;
+    float evaluateOctal(NimState const & state) const;
+
+    // Returns the values of winning and losing states for the player who made the last move
+    static float winningValue(NimState const & state, float value);
 
     Rules rules_; // The rules for the game being played
 };
+
+template <Rules::Variation V>
+inline float NimEvaluator::evaluate(NimState const & state) const
+{
+    assert(rules_.variation() == V);
+
+    // If the game is over, then return the score for the winner
+    if (state.isGameOver())
+        return (state.winner().value() == GamePlayer::GameState::PlayerId::FIRST) ? WIN_VALUE : -WIN_VALUE;
+
+    if constexpr (V == Rules::Variation::MISERE)
+        return evaluateMisere(state);
+    else if constexpr (V == Rules::Variation::NORMAL)
+        return evaluateNormal(state);
+    else if constexpr (V == Rules::Variation::SUBTRACT)
+        return evaluateSubtract(state);
+    else
+        return evaluateOctal(state);
+}
+
+inline float NimEvaluator::winningValue(NimState const & state, float value)
+{
+    // The player who made the last move is the one who isn't moving next
+    return (state.whoseTurn() == GamePlayer::GameState::PlayerId::SECOND) ? value : -value;
+}
+
+inline float NimEvaluator::evaluateMisere(NimState const & state) const
+{
+    float winningStateValue = winningValue(state, LIKELY_WIN_VALUE);
+    float losingStateValue  = -winningStateValue;
+
+    // In the misre variation, evaluation is based on the nim-sum (as in the normal variation) until there 0 or 1 heaps with more
+    // than 1 object.
+
+    int significantHeaps = state.significantHeaps();
+
+    // If there is exactly one heap with a size greater than one, then the state is a losing state.
+    if (significantHeaps == 1)
+    {
+        return losingStateValue;
+    }
+
+    // If there are no significant heaps, then all that are left are heaps of size 1. The winner depends on the number of remaining
+    // heaps. The state is a losing state if there is an even number of heaps (nim-sum == 0), otherwise it is a winning state.
+    if (significantHeaps == 0)
+    {
+        return (state.nimSum() == 0) ? losingStateValue : winningStateValue;
+    }
+
+    // In the general case, if the nim-sum is zero, then the state is a winning state, otherwise it is a losing state.
+    return (state.nimSum() == 0) ? winningStateValue : losingStateValue;
+}
+
+inline float NimEvaluator::evaluateNormal(NimState const & state) const
+{
+    float winningStateValue = winningValue(state, LIKELY_WIN_VALUE);
+    float losingStateValue  = -winningStateValue;
+
+    return (state.nimSum() == 0) ? winningStateValue : losingStateValue;
+}
+
+inline float NimEvaluator::evaluateSubtract(NimState const & state) const
+{
+    float winningStateValue = winningValue(state, WIN_VALUE);
+    float losingStateValue  = -winningStateValue;
+
+    // The Grundy values are exact, so the result is a win or a loss rather than a likely win or loss. The state is a winning state
+    // if the XOR of the Grundy values of the heaps is zero.
+    assert(rules_.grundyTable());
+    Board const & board = state.board();
+    int           sum   = 0;
+    for (int i = 0; i < static_cast<int>(board.size()); ++i)
+    {
+        sum ^= rules_.grundyTable(i)->value(board.heap(i));
+    }
+    return (sum == 0) ? winningStateValue : losingStateValue;
+}
+
+inline float NimEvaluator::evaluateOctal(NimState const & state) const
+{
+    float winningStateValue = winningValue(state, WIN_VALUE);
+    float losingStateValue  = -winningStateValue;
+
+    // As in the subtraction variation, the Grundy values are exact, and the state is a winning state if their XOR is zero
+    assert(rules_.octalGame());
+    OctalGame const & octal = *rules_.octalGame();
+    int               sum   = 0;
+    for (int n : state.board())
+    {
+        sum ^= octal.value(n);
+    }
+    return (sum == 0) ? winningStateValue : losingStateValue;
+}
@@ -0,0 +1,486 @@
+#include "NimSearch.h"
+
+#include "MoveOrderer.h"
+#include "NimEvaluator.h"
+#include "NimTranspositionTable.h"
+#include "SharedTranspositionTable.h"
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "NimState/NimState.h"
+#include "NimState/ZHash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+static float const INFINITE_VALUE = std::numeric_limits<float>::infinity();
+
+// Killer moves for a depth with none recorded
+static MoveOrderer::Killers const NO_KILLERS{};
+
+using Bound = NimTranspositionTable::Bound;
+
+// Identifies a snapshot and the game and hash values it was saved with
+struct NimSearch::SnapshotHeader
+{
+    char     magic[8];     // Identifies the file as a snapshot
+    uint16_t version;      // Version of the snapshot format
+    uint16_t byteOrder;    // SNAPSHOT_ORDER, in the byte order of the machine that saved the snapshot
+    uint8_t  variation;    // Variation of the game
+    uint8_t  removalLimit; // Maximum number of objects that can be removed from a heap
+    uint16_t setDigest;    // Digest of the subtraction set, or 0 if it is 1 through the removal limit
+    uint64_t seed;         // Seed of the hash values
+    uint64_t signature;    // Digest of the hash values
+    uint64_t count;        // Number of records
+};
+
+// A state in a snapshot
+struct NimSearch::SnapshotRecord
+{
+    uint64_t fingerprint; // Fingerprint of the state
+    float    value;       // Value of the state
+    int8_t   depth;       // Number of plies searched below the state
+    uint8_t  bound;       // Kind of value
+    int8_t   heap;        // Size of the heap changed by the best move (0 if none)
+    int8_t   n;           // Number of objects removed by the best move
+};
+
+// Returns a digest of the subtraction set of the rules, which is 0 if the set is 1 through the removal limit (as it was before
+// other sets were allowed).
+static uint16_t setDigest(Rules const & rules)
+{
+    if (rules.isRange())
+        return 0;
+    uint64_t digest = 0xcbf29ce484222325ull; // FNV-1a
+    for (int n : rules.subtractionSet())
+    {
+        digest = (digest ^ static_cast<uint64_t>(n)) * 0x100000001b3ull;
+    }
+    return static_cast<uint16_t>((digest >> 48) | 1);
+}
+
+static char const SNAPSHOT_MAGIC[8] = {'N', 'I', 'M', 'T', 'T', 'A', 'B', 'L'};
+
+NimSearch::Worker::Worker(size_t tableBytes, bool hugePages)
+    : transpositionTable(tableBytes, hugePages)
+    , killers(MAX_DEPTH + 1)
+{
+}
+
+NimSearch::NimSearch(Rules const & rules, Settings const & settings)
+    : rules_(rules)
+    , evaluator_(rules)
+    , settings_(settings)
+    , depth_(0)
+    , budget_()
+    , depthSearched_(0)
+    , iteration_()
+    , iterations_(0)
+    , busy_(0)
+    , quitting_(false)
+{
+    assert(settings_.maxDepth > 0 && settings_.maxDepth <= MAX_DEPTH);
+    assert(settings_.transpositionTableMegabytes > 0);
+    assert(settings_.threads > 0);
+    assert(rules_.heapLimits().empty()); // The hashes of states don't tell apart heaps with different limits
+    assert(!rules_.octalGame());         // The moves made in place don't split heaps
+
+    // The memory budget is divided evenly among the threads' tables. They are left as small as possible if they are not used.
+    size_t tableBytes = settings_.sharedTable ? 0 : settings_.transpositionTableMegabytes * 1024 * 1024 / settings_.threads;
+    workers_.reserve(settings_.threads);
+    for (int i = 0; i < settings_.threads; ++i)
+    {
+        workers_.emplace_back(tableBytes, settings_.hugePages);
+    }
+
+    // Reserve the memory for the statistics up front, so that a search doesn't allocate anything
+    statistics_.iterations.reserve(MAX_DEPTH);
+    statistics_.principalVariation.reserve(MAX_DEPTH);
+
+    // The calling thread is the first worker. Each of the others gets a helper thread, which lives as long as the search.
+    helpers_.reserve(workers_.size() - 1);
+    for (size_t i = 1; i < workers_.size(); ++i)
+    {
+        helpers_.emplace_back(&NimSearch::help, this, std::ref(workers_[i]));
+    }
+}
+
+NimSearch::~NimSearch()
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        quitting_ = true;
+    }
+    started_.notify_all();
+    for (auto & helper : helpers_)
+    {
+        helper.join();
+    }
+}
+
+NimState::Move NimSearch::findBestMove(NimState const & state)
+{
+    assert(!state.isGameOver());
+
+    // The search uses canonical hashing because the order of the heaps doesn't affect the value of a state
+    NimState root(state.board(), rules_, state.whoseTurn(), ZHash::Mode::CANONICAL);
+
+    for (auto & worker : workers_)
+    {
+        worker.counters = SearchCounters();
+        worker.transpositionTable.age(); // Entries left by earlier searches are replaced first
+        std::fill(worker.killers.begin(), worker.killers.end(), NO_KILLERS);
+    }
+    statistics_.clear();
+
+    auto start        = std::chrono::steady_clock::now();
+    budget_.deadline  = start + settings_.timeLimit;
+    budget_.timed     = settings_.timeLimit.count() > 0;
+    budget_.nodeLimit = settings_.nodeLimit;
+    budget_.counted   = 0;
+    budget_.stopped   = false;
+
+    // The variation is resolved once, rather than at every node
+    RootSearch searchRoot = rootSearch();
+
+    // No game lasts longer than the number of objects on the board, so searching deeper than that finds nothing new
+    int                           objects  = std::accumulate(root.board().begin(), root.board().end(), 0);
+    int                           maxDepth = std::min(settings_.maxDepth, objects);
+    std::optional<NimState::Move> best;
+    depthSearched_ = 0;
+    for (depth_ = 1; depth_ <= maxDepth; ++depth_)
+    {
+        RootResult result;
+        auto       iterationStart = std::chrono::steady_clock::now();
+        uint64_t   iterationNodes = totalNodes();
+
+        // The calling thread searches with the first worker, and the helper threads (if any) with the others
+        if (!helpers_.empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock(poolMutex_);
+                iteration_ = Iteration{searchRoot, &root, &best, &result};
+                ++iterations_;
+                busy_ = helpers_.size();
+            }
+            started_.notify_all();
+        }
+        (this->*searchRoot)(root, best, workers_[0], result);
+        if (!helpers_.empty())
+        {
+            std::unique_lock<std::mutex> lock(poolMutex_);
+            finished_.wait(lock, [this] { return busy_ == 0; });
+        }
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - iterationStart;
+        statistics_.iterations.push_back({depth_, totalNodes() - iterationNodes, elapsed.count(), !budget_.stopped});
+
+        // The result of an iteration that was stopped early is incomplete, so it is ignored
+        if (budget_.stopped)
+            break;
+        assert(result.move.has_value());
+        best           = result.move;
+        depthSearched_ = depth_;
+    }
+    assert(best.has_value());
+
+    for (auto const & worker : workers_)
+    {
+        statistics_.nodes += worker.counters.nodes;
+        statistics_.probes += worker.counters.probes;
+        statistics_.hits += worker.counters.hits;
+        statistics_.stores += worker.counters.stores;
+        statistics_.replacements += worker.counters.replacements;
+        statistics_.evaluations += worker.counters.evaluations;
+    }
+    if (depthSearched_ >= 2)
+    {
+        auto const & last     = statistics_.iterations[depthSearched_ - 1];
+        auto const & previous = statistics_.iterations[depthSearched_ - 2];
+        if (previous.nodes > 0)
+            statistics_.branchingFactor = double(last.nodes) / double(previous.nodes);
+    }
+    findPrincipalVariation(root, best.value());
+    statistics_.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    return best.value();
+}
+
+void NimSearch::help(Worker & worker)
+{
+    uint64_t done = 0;
+    while (true)
+    {
+        Iteration iteration;
+        {
+            std::unique_lock<std::mutex> lock(poolMutex_);
+            started_.wait(lock, [this, done] { return quitting_ || iterations_ != done; });
+            if (quitting_)
+                return;
+            iteration = iteration_;
+            done      = iterations_;
+        }
+
+        // The root and the preferred move are copied by searchRoot(), and the calling thread keeps them until every helper is done
+        (this->*iteration.search)(*iteration.root, *iteration.preferred, worker, *iteration.result);
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(poolMutex_);
+            last = --busy_ == 0;
+        }
+        if (last)
+            finished_.notify_one();
+    }
+}
+
+template <Rules::Variation V, typename Table>
+void NimSearch::searchRoot(NimState root, std::optional<NimState::Move> preferred, Worker & worker, RootResult & result)
+{
+    Table * table;
+    if constexpr (std::is_same_v<Table, SharedTranspositionTable>)
+        table = settings_.sharedTable.get();
+    else
+        table = &worker.transpositionTable;
+
+    bool             maximizing = (root.whoseTurn() == NimState::PlayerId::FIRST);
+    Engine<V, Table> engine(rules_, evaluator_, *table, worker.killers, worker.counters, budget_, depth_, settings_.moveOrdering);
+
+    // Every thread generates the same moves in the same order, and searches only the ones it claims.
+    MoveOrderer::Hint hint{};
+    if (preferred)
+        hint = MoveOrderer::hint(root.board(), *preferred);
+    MoveOrderer moves(root.board(), rules_, hint, settings_.moveOrdering ? &NO_KILLERS : nullptr);
+    int           index   = 0;
+    int           claimed = result.next++;
+    while (std::optional<NimState::Move> move = moves.next())
+    {
+        if (index++ != claimed)
+            continue;
+
+        // A move must do better than the best move so far, or do as well if it was generated earlier. In the latter case, the
+        // window is widened slightly so that a move with the same value gets an exact value rather than a bound.
+        float alpha = -INFINITE_VALUE;
+        float beta  = INFINITE_VALUE;
+        {
+            std::lock_guard<std::mutex> lock(result.mutex);
+            if (result.move.has_value())
+            {
+                bool  earlier = claimed < result.index;
+                float bound   = result.value;
+                if (maximizing)
+                    alpha = earlier ? std::nextafter(bound, -INFINITE_VALUE) : bound;
+                else
+                    beta = earlier ? std::nextafter(bound, INFINITE_VALUE) : bound;
+            }
+        }
+
+        NimState::Undo undo  = root.move(move->i, move->n);
+        float          value = engine.search(root, 1, alpha, beta);
+        root.undo(undo);
+        if (budget_.stopped)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(result.mutex);
+            bool better = !result.move.has_value() || (maximizing ? value > result.value : value < result.value) ||
+                          (value == result.value && claimed < result.index);
+            if (better)
+            {
+                result.move  = move;
+                result.index = claimed;
+                result.value = value;
+            }
+        }
+
+        claimed = result.next++;
+    }
+}
+
+NimSearch::RootSearch NimSearch::rootSearch() const
+{
+    switch (rules_.variation())
+    {
+    case Rules::Variation::MISERE:
+        return rootSearch<Rules::Variation::MISERE>();
+    case Rules::Variation::NORMAL:
+        return rootSearch<Rules::Variation::NORMAL>();
+    case Rules::Variation::SUBTRACT:
+        return rootSearch<Rules::Variation::SUBTRACT>();
+    default:
+        assert(false && "Unknown variation");
+        return rootSearch<Rules::Variation::DEFAULT>();
+    }
+}
+
+template <Rules::Variation V>
+NimSearch::RootSearch NimSearch::rootSearch() const
+{
+    if (settings_.sharedTable)
+        return &NimSearch::searchRoot<V, SharedTranspositionTable>;
+    return &NimSearch::searchRoot<V, NimTranspositionTable>;
+}
+
+uint64_t NimSearch::totalNodes() const
+{
+    uint64_t nodes = 0;
+    for (auto const & worker : workers_)
+    {
+        nodes += worker.counters.nodes;
+    }
+    return nodes;
+}
+
+void NimSearch::findPrincipalVariation(NimState root, NimState::Move best)
+{
+    std::vector<NimState::Move> & variation = statistics_.principalVariation;
+    variation.push_back(best);
+    root.move(best.i, best.n);
+
+    // Follow the best move stored for each state, taking the deepest entry among the threads' tables (or the entry in the shared
+    // table). The variation is no longer than the depth searched, so that it can't loop.
+    while (!root.isGameOver() && static_cast<int>(variation.size()) < depthSearched_)
+    {
+        std::optional<NimTranspositionTable::Entry> found;
+        if (settings_.sharedTable)
+        {
+            found = settings_.sharedTable->probe(root.fingerprint());
+        }
+        else
+        {
+            for (auto const & worker : workers_)
+            {
+                NimTranspositionTable::Entry const * entry = worker.transpositionTable.probe(root.fingerprint());
+                if (entry && entry->heap() != 0 && (!found || entry->depth > found->depth))
+                    found = *entry;
+            }
+        }
+        if (!found || found->heap() == 0)
+            break;
+        MoveOrderer                   moves(root.board(), rules_, MoveOrderer::Hint{found->heap(), found->n()});
+        std::optional<NimState::Move> move = moves.next();
+        assert(move.has_value());
+        variation.push_back(*move);
+        root.move(move->i, move->n);
+    }
+}
+
+void NimSearch::clearTranspositionTable()
+{
+    for (auto & worker : workers_)
+    {
+        worker.transpositionTable.clear();
+    }
+}
+
+bool NimSearch::saveTranspositionTable(std::ostream & out) const
+{
+    static_assert(sizeof(SnapshotHeader) == 40, "The header must have no padding");
+    static_assert(sizeof(SnapshotRecord) == 16, "A record must have no padding");
+
+    // A state may be in more than one thread's table, in which case the deepest entry is saved
+    std::unordered_map<uint64_t, SnapshotRecord> records;
+
+    auto add = [&records](NimTranspositionTable::Entry const & entry)
+    {
+        SnapshotRecord record{entry.fingerprint,
+                              entry.value,
+                              entry.depth,
+                              static_cast<uint8_t>(entry.bound()),
+                              entry.heap(),
+                              entry.n()};
+        auto [saved, inserted] = records.try_emplace(entry.fingerprint, record);
+        if (!inserted && record.depth > saved->second.depth)
+            saved->second = record;
+    };
+    if (settings_.sharedTable)
+    {
+        settings_.sharedTable->forEach(add);
+    }
+    else
+    {
+        for (auto const & worker : workers_)
+        {
+            worker.transpositionTable.forEach(add);
+        }
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version      = SNAPSHOT_VERSION;
+    header.byteOrder    = SNAPSHOT_ORDER;
+    header.variation    = static_cast<uint8_t>(rules_.variation());
+    header.removalLimit = static_cast<uint8_t>(rules_.removalLimit());
+    header.setDigest    = setDigest(rules_);
+    header.seed         = ZHash::SEED;
+    header.signature    = ZHash::signature();
+    header.count        = records.size();
+    out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    for (auto const & r : records)
+    {
+        out.write(reinterpret_cast<char const *>(&r.second), sizeof(r.second));
+    }
+    return static_cast<bool>(out);
+}
+
+bool NimSearch::loadTranspositionTable(std::istream & in)
+{
+    SnapshotHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return false;
+    bool valid = std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0 && header.version == SNAPSHOT_VERSION &&
+                 header.byteOrder == SNAPSHOT_ORDER &&
+                 header.variation == static_cast<uint8_t>(rules_.variation()) &&
+                 header.removalLimit == static_cast<uint8_t>(rules_.removalLimit()) &&
+                 header.setDigest == setDigest(rules_) && header.seed == ZHash::SEED &&
+                 header.signature == ZHash::signature();
+    if (!valid)
+        return false;
+
+    // All the records are read and checked before any of them are stored, so that a bad snapshot leaves the table unchanged
+    std::vector<SnapshotRecord> records;
+    SnapshotRecord              record;
+    while (records.size() < header.count && in.read(reinterpret_cast<char *>(&record), sizeof(record)))
+    {
+        bool ok = record.fingerprint != ZHash::UNDEFINED && record.depth >= 0 && record.depth <= MAX_DEPTH &&
+                  record.bound <= static_cast<uint8_t>(Bound::UPPER) && record.heap >= 0 && record.heap <= Board::MAX_OBJECTS &&
+                  record.n >= 0 && record.n <= record.heap;
+        if (!ok)
+            return false;
+        records.push_back(record);
+    }
+    if (records.size() != header.count)
+        return false;
+
+    // Every thread gets every state, unless the threads share a table
+    if (settings_.sharedTable)
+    {
+        for (auto const & r : records)
+        {
+            settings_.sharedTable->store(r.fingerprint, r.value, r.depth, static_cast<Bound>(r.bound), r.heap, r.n);
+        }
+        return true;
+    }
+    for (auto & worker : workers_)
+    {
+        for (auto const & r : records)
+        {
+            worker.transpositionTable.store(r.fingerprint, r.value, r.depth, static_cast<Bound>(r.bound), r.heap, r.n);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "AlphaBeta.h"
+#include "MoveOrderer.h"
+#include "NimEvaluator.h"
+#include "NimTranspositionTable.h"
+#include "SearchStatistics.h"
+#include "SharedTranspositionTable.h"
+
+#include "Components/Rules.h"
+#include "NimState/NimState.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// An alpha-beta search that walks the game tree in place on a single NimState.
+//
+// Unlike GamePlayer::GameTree, which creates a new state for every response, this search makes and undoes moves on one state,
+// so nothing is copied or allocated per node. The first player maximizes the value and the second player minimizes it.
+//
+// The moves at the root can be searched in parallel. Each thread takes the next unsearched root move and searches it on its own
+// copy of the state with its own transposition table. The best value found so far is shared so that the threads can cut off
+// moves that can't improve on it. Ties are always resolved in favor of the move generated first, so the result is the same as a
+// search on a single thread. The calling thread is the first of them, and the others are helper threads started with the search,
+// which wait between iterations, so no threads are started per move.
+//
+// A SharedTranspositionTable can be given in the settings instead. All the threads then use it, along with any other searches
+// of the same game given the same table, so a state searched by one of them is not searched again by the others.
+//
+// Moves are ordered by MoveOrderer, so that the moves most likely to cause a cutoff are searched first. Below the root, the search
+// is done by AlphaBeta, specialized for the variation being played, so that it makes no virtual calls and uses no RTTI.
+//
+// The search deepens one ply at a time, up to the maximum depth. Each iteration searches the best move of the previous iteration
+// first, and the transposition table entries left by earlier iterations supply the first move to search at every other node.
+// If a time or node budget is set, the search stops when the budget runs out and returns the best move of the last completed
+// iteration. The first iteration always completes, so there is always a move to return.
+class NimSearch
+{
+public:
+    static int constexpr      MAX_DEPTH        = 127;    // Deepest search supported by the transposition table
+    static uint16_t constexpr SNAPSHOT_VERSION = 2;      // Version of the transposition table snapshot format
+    static uint16_t constexpr SNAPSHOT_ORDER   = 0x0102; // Reads as 0x0201 if the snapshot was saved with another byte order
+
+    // Settings for the search
+    struct Settings
+    {
+        int                       maxDepth                    = 10;    // Determines how good the AI is and how long it takes
+        size_t                    transpositionTableMegabytes = 2;     // Memory budget for the tables of all the threads
+        int                       threads                     = 1;     // Number of threads searching the moves at the root
+        std::chrono::milliseconds timeLimit{0};                        // Time budget for each move (0 means no limit)
+        uint64_t                  nodeLimit    = 0;                    // Node budget for each move (0 means no limit)
+        bool                      moveOrdering = true;                 // Search winning replies and killer moves early
+        bool                      hugePages    = false;                // Back the tables with huge pages, if available
+        uint32_t                  seed         = 0;                    // Seed of the solver's random moves (0 for a random seed)
+
+        // Table shared with other searches of the same game, used instead of the threads' own tables (nullptr if none)
+        std::shared_ptr<SharedTranspositionTable> sharedTable = nullptr;
+    };
+
+    // Constructor
+    NimSearch(Rules const & rules, Settings const & settings);
+
+    // Destructor
+    ~NimSearch();
+
+    // Noncopyable and nonmovable, because the helper threads refer to it
+    NimSearch(NimSearch const &)             = delete;
+    NimSearch & operator=(NimSearch const &) = delete;
+
+    // Returns the best move for the player to move in the given state. The game must not be over.
+    NimState::Move findBestMove(NimState const & state);
+
+    // Returns the number of nodes visited by the last search.
+    uint64_t nodesSearched() const { return statistics_.nodes; }
+
+    // Returns the statistics collected by the last search.
+    SearchStatistics const & statistics() const { return statistics_; }
+
+    // Returns the depth of the last iteration completed by the last search.
+    int depthSearched() const { return depthSearched_; }
+
+    // Discards everything learned by earlier searches, e.g. between games. Takes constant time. A shared table is not cleared,
+    // because other searches are using it.
+    void clearTranspositionTable();
+
+    // Writes the transposition table to a stream as a snapshot, which can be loaded by a later search of the same game. Returns
+    // false if the stream can't be written.
+    //
+    // Snapshot format (native byte order, which is checked when the snapshot is loaded):
+    //   SnapshotHeader              (40 bytes) Identifies the game, the hash values, and the byte order
+    //   SnapshotRecord[count]       (16 bytes each) One record for each state, by fingerprint
+    bool saveTranspositionTable(std::ostream & out) const;
+
+    // Adds the states in a snapshot to the transposition table. Returns false, leaving the table unchanged, if the snapshot can't
+    // be read, or if it was saved by a different version, for a different game, with different hash values, or on a machine with
+    // a different byte order.
+    bool loadTranspositionTable(std::istream & in);
+
+private:
+    struct SnapshotHeader; // The header of a snapshot
+    struct SnapshotRecord; // A state in a snapshot
+
+    // The data used by a single thread
+    struct Worker
+    {
+        // Constructor
+        Worker(size_t tableBytes, bool hugePages);
+
+        NimTranspositionTable             transpositionTable; // Transposition table
+        std::vector<MoveOrderer::Killers> killers;            // Killer moves for each depth
+        SearchCounters                    counters;           // Work done during the current search
+    };
+
+    // The best root move found so far, shared by all the threads
+    struct RootResult
+    {
+        std::mutex                    mutex;     // Guards the other members
+        std::atomic<int>              next{0};   // Index of the next root move to be searched
+        std::optional<NimState::Move> move;      // Best move
+        int                           index = 0; // Index of the best move in the order generated
+        float                         value = 0; // Value of the best move
+    };
+
+    // The search below the root, specialized for variation V
+    template <Rules::Variation V, typename Table>
+    using Engine = AlphaBeta<NimState, MoveOrderer, NimEvaluator, V, Table>;
+
+    // A function that searches root moves
+    using RootSearch = void (NimSearch::*)(NimState, std::optional<NimState::Move>, Worker &, RootResult &);
+
+    // An iteration handed to the helper threads
+    struct Iteration
+    {
+        RootSearch                            search;    // Function searching the root moves
+        NimState const *                      root;      // State searched
+        std::optional<NimState::Move> const * preferred; // Move searched first, if any
+        RootResult *                          result;    // Best root move found so far
+    };
+
+    // Searches the root moves of each iteration with a worker until the search is destroyed. Run by a helper thread.
+    void help(Worker & worker);
+
+    // Searches root moves, taking the next unsearched one each time, until there are none left. The preferred move (if any) is
+    // searched first. Table is the type of the transposition table used.
+    template <Rules::Variation V, typename Table>
+    void searchRoot(NimState root, std::optional<NimState::Move> preferred, Worker & worker, RootResult & result);
+
+    // Returns the instance of searchRoot() for the variation being played and the table used.
+    RootSearch rootSearch() const;
+
+    // Returns the instance of searchRoot() for variation V and the table used.
+    template <Rules::Variation V>
+    RootSearch rootSearch() const;
+
+    // Returns the total number of nodes visited by all the threads.
+    uint64_t totalNodes() const;
+
+    // Sets the principal variation in the statistics, by following the best moves in the transposition tables from the root.
+    void findPrincipalVariation(NimState root, NimState::Move best);
+
+    Rules               rules_;         // The rules for the game being played
+    NimEvaluator        evaluator_;     // Static evaluator for the leaves
+    Settings            settings_;      // Settings for the search
+    std::vector<Worker> workers_;       // Data for each thread
+    int                 depth_;         // Depth of the current iteration
+    SearchBudget        budget_;        // Budget for the current search
+    SearchStatistics    statistics_;    // Statistics collected by the last search
+    int                 depthSearched_; // Depth of the last iteration completed by the last search
+
+    std::vector<std::thread> helpers_;    // Threads searching with workers 1 and up
+    std::mutex               poolMutex_;  // Guards the members below
+    std::condition_variable  started_;    // Signaled when an iteration starts or the search is destroyed
+    std::condition_variable  finished_;   // Signaled when the last helper finishes an iteration
+    Iteration                iteration_;  // Current iteration
+    uint64_t                 iterations_; // Number of iterations handed to the helpers
+    size_t                   busy_;       // Number of helpers still searching the current iteration
+    bool                     quitting_;   // True if the helpers must exit
+};
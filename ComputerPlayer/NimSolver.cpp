@@ -0,0 +1,200 @@
+#include "NimSolver.h"
+
+#include "Components/Board.h"
+#include "Components/GrundyTable.h"
+#include "Components/OctalGame.h"
+#include "Components/Rules.h"
+#include "NimState/NimState.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <utility>
+
+static NimState::Move makeMove(int i, int n, int split = 0)
+{
+    return NimState::Move{static_cast<int8_t>(i), static_cast<int8_t>(n), static_cast<int8_t>(split)};
+}
+
+NimSolver::NimSolver(Rules rules, uint32_t seed /*= 0*/)
+    : rules_(std::move(rules))
+    , random_(seed != 0 ? seed : std::random_device()())
+{
+}
+
+std::optional<NimState::Move> NimSolver::winningMove(Board const & board) const
+{
+    if (board.empty())
+        return std::nullopt;
+
+    switch (rules_.variation())
+    {
+    case Rules::Variation::MISERE:
+        return winningMisereMove(board);
+    case Rules::Variation::NORMAL:
+        return winningNormalMove(board);
+    case Rules::Variation::SUBTRACT:
+        return winningSubtractMove(board);
+    case Rules::Variation::OCTAL:
+        return winningOctalMove(board);
+    default:
+        assert(false && "Unknown variation");
+        return std::nullopt;
+    }
+}
+
+NimState::Move NimSolver::bestMove(Board const & board)
+{
+    assert(!board.empty());
+    std::optional<NimState::Move> move = winningMove(board);
+    return move.has_value() ? move.value() : randomMove(board);
+}
+
+std::optional<NimState::Move> NimSolver::winningMisereMove(Board const & board) const
+{
+    int significantHeaps = 0;  // Number of heaps with more than 1 object
+    int ones             = 0;  // Number of heaps with exactly 1 object
+    int bigHeap          = -1; // Index of the last heap with more than 1 object
+    for (int i = 0; i < static_cast<int>(board.size()); ++i)
+    {
+        int n = board.heap(i);
+        if (n > 1)
+        {
+            ++significantHeaps;
+            bigHeap = i;
+        }
+        else if (n == 1)
+        {
+            ++ones;
+        }
+    }
+
+    // If all the heaps have at most 1 object, then the player who faces an odd number of them loses. The winning move (if the
+    // number is even) is to take one of them.
+    if (significantHeaps == 0)
+    {
+        if (ones % 2 != 0)
+            return std::nullopt;
+        for (int i = 0; i < static_cast<int>(board.size()); ++i)
+        {
+            if (board.heap(i) == 1)
+                return makeMove(i, 1);
+        }
+        assert(false && "A non-empty board must have a heap with 1 object");
+    }
+
+    // If exactly one heap has more than 1 object, then the position is always a win. Reduce that heap to 0 or 1 so that an odd
+    // number of heaps with 1 object remain.
+    if (significantHeaps == 1)
+    {
+        int target = (ones % 2 != 0) ? 0 : 1;
+        return makeMove(bigHeap, board.heap(bigHeap) - target);
+    }
+
+    // Otherwise, play as in the normal variation.
+    return winningNormalMove(board);
+}
+
+std::optional<NimState::Move> NimSolver::winningNormalMove(Board const & board) const
+{
+    int sum = board.nimSum();
+    if (sum == 0)
+        return std::nullopt;
+
+    // There is always a heap containing the highest bit of the nim-sum. Reducing it to (heap ^ sum) makes the nim-sum 0.
+    for (int i = 0; i < static_cast<int>(board.size()); ++i)
+    {
+        int n      = board.heap(i);
+        int target = n ^ sum;
+        if (target < n)
+            return makeMove(i, n - target);
+    }
+    assert(false && "A non-zero nim-sum must have a winning move");
+    return std::nullopt;
+}
+
+std::optional<NimState::Move> NimSolver::winningSubtractMove(Board const & board) const
+{
+    // The position is lost if the XOR of the Grundy values of the heaps is 0. Otherwise, the winning move changes the Grundy value
+    // of one heap so that the XOR becomes 0. If the heaps have removal limits of their own, each one has its own table.
+    assert(rules_.grundyTable());
+    int sum = 0;
+    for (int i = 0; i < static_cast<int>(board.size()); ++i)
+    {
+        sum ^= rules_.grundyTable(i)->value(board.heap(i));
+    }
+    if (sum == 0)
+        return std::nullopt;
+
+    for (int i = 0; i < static_cast<int>(board.size()); ++i)
+    {
+        GrundyTable const * table  = rules_.grundyTable(i);
+        int                 from   = board.heap(i);
+        int                 target = table->value(from) ^ sum;
+        for (int n : rules_.subtractionSet())
+        {
+            if (n > from || n > rules_.removalLimit(i))
+                break;
+            if (table->value(from - n) == target)
+                return makeMove(i, n);
+        }
+    }
+    assert(false && "A non-zero Grundy value must have a winning move");
+    return std::nullopt;
+}
+
+std::optional<NimState::Move> NimSolver::winningOctalMove(Board const & board) const
+{
+    // As in the subtraction variation, except that the winning move may split the heap into two heaps whose Grundy values XOR to
+    // the target
+    OctalGame const * octal = rules_.octalGame();
+    assert(octal);
+    int sum = 0;
+    for (int n : board)
+    {
+        sum ^= octal->value(n);
+    }
+    if (sum == 0)
+        return std::nullopt;
+
+    for (int i = 0; i < static_cast<int>(board.size()); ++i)
+    {
+        int from = board.heap(i);
+        if (std::optional<OctalGame::Move> reply = octal->reply(from, octal->value(from) ^ sum))
+            return makeMove(i, static_cast<int>(reply->n), static_cast<int>(reply->split));
+    }
+    assert(false && "A non-zero Grundy value must have a winning move");
+    return std::nullopt;
+}
+
+NimState::Move NimSolver::randomMove(Board const & board)
+{
+    // Choose a random heap that has a move and remove as few objects from it as the rules allow. Small moves prolong the game,
+    // which gives the opponent more opportunities to make a mistake.
+    int heaps = static_cast<int>(std::count_if(board.begin(), board.end(), [this](int n) { return rules_.hasMove(n); }));
+    assert(heaps > 0);
+    int k = std::uniform_int_distribution<int>(0, heaps - 1)(random_);
+    for (int i = 0; i < static_cast<int>(board.size()); ++i)
+    {
+        int size = board.heap(i);
+        if (!rules_.hasMove(size) || k-- > 0)
+            continue;
+
+        // In an octal game, the fewest objects that can be removed may depend on the size of the heap, and may have to split it
+        if (OctalGame const * octal = rules_.octalGame())
+        {
+            for (int n = 1; n <= std::min(size, octal->maxRemoval()); ++n)
+            {
+                if (octal->isLegal(size, n, 0))
+                    return makeMove(i, n);
+                if (octal->isLegal(size, n, 1))
+                    return makeMove(i, n, 1);
+            }
+        }
+        return makeMove(i, rules_.minimumRemoval());
+    }
+    assert(false && "The chosen heap must exist");
+    return makeMove(0, rules_.minimumRemoval());
+}
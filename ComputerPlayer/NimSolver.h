@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Components/Rules.h"
+#include "NimState/NimState.h"
+
+#include <cstdint>
+#include <optional>
+#include <random>
+
+class Board;
+
+// Computes perfect play directly from the nim-sum of the board, without searching.
+//
+// In the normal variation, a position is lost for the player to move if and only if its nim-sum is 0, and the winning move is
+// the one that makes the nim-sum 0. The misre variation is played the same way until the move would leave no heaps with more
+// than one object. At that point, the winning move leaves an odd number of heaps with one object. In the subtraction variation,
+// the Grundy values of the heaps take the place of their sizes, even when each heap has a removal limit of its own. Octal games
+// are played the same way, except that the winning move may leave two heaps in place of one.
+class NimSolver
+{
+public:
+    // Constructor. The moves chosen at random in lost positions are drawn from a generator seeded with `seed`, so they can be
+    // repeated, or from std::random_device if it is 0.
+    explicit NimSolver(Rules rules, uint32_t seed = 0);
+
+    // Returns the winning move for the player to move, or std::nullopt if the position is lost (or the game is over).
+    std::optional<NimState::Move> winningMove(Board const & board) const;
+
+    // Returns the best move for the player to move. If the position is lost, a legal move is chosen at random.
+    NimState::Move bestMove(Board const & board);
+
+private:
+    std::optional<NimState::Move> winningMisereMove(Board const & board) const;
+    std::optional<NimState::Move> winningNormalMove(Board const & board) const;
+    std::optional<NimState::Move> winningSubtractMove(Board const & board) const;
+    std::optional<NimState::Move> winningOctalMove(Board const & board) const;
+    NimState::Move                randomMove(Board const & board);
+
+    Rules        rules_;  // The rules for the game being played
+    std::mt19937 random_; // Chooses the moves in lost positions
+};
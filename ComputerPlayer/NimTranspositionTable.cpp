@@ -0,0 +1,121 @@
+#include "NimTranspositionTable.h"
+
+#include "NimState/ZHash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <memory>
+#include <utility>
+
+static_assert(sizeof(NimTranspositionTable::Entry) == 16, "Four entries must fit in a cache line");
+
+NimTranspositionTable::NimTranspositionTable(size_t budget, bool hugePages /*= false*/)
+    : bucketCount_(TableMemory::countBlocks(budget, sizeof(Bucket)))
+    , memory_(bucketCount_ * sizeof(Bucket), hugePages)
+    , buckets_(static_cast<Bucket *>(memory_.data()))
+    , generation_(0)
+    , first_(0)
+{
+    std::uninitialized_default_construct_n(buckets_, bucketCount_);
+    reset();
+}
+
+NimTranspositionTable::NimTranspositionTable(NimTranspositionTable && other) noexcept
+    : bucketCount_(other.bucketCount_)
+    , memory_(std::move(other.memory_))
+    , buckets_(std::exchange(other.buckets_, nullptr))
+    , generation_(other.generation_)
+    , first_(other.first_)
+{
+}
+
+NimTranspositionTable & NimTranspositionTable::operator=(NimTranspositionTable && other) noexcept
+{
+    if (this != &other)
+    {
+        bucketCount_ = other.bucketCount_;
+        memory_      = std::move(other.memory_);
+        buckets_     = std::exchange(other.buckets_, nullptr);
+        generation_  = other.generation_;
+        first_       = other.first_;
+    }
+    return *this;
+}
+
+NimTranspositionTable::Entry const * NimTranspositionTable::probe(uint64_t fingerprint) const
+{
+    for (Entry const & entry : bucket(fingerprint).entries)
+    {
+        if (entry.fingerprint == fingerprint && isCurrent(entry))
+            return &entry;
+    }
+    return nullptr;
+}
+
+bool NimTranspositionTable::store(uint64_t fingerprint, float value, int depth, Bound bound, int heap, int n)
+{
+    assert(fingerprint != ZHash::UNDEFINED);
+    assert(depth >= 0 && depth <= INT8_MAX);
+    assert(heap >= 0 && heap <= MOVE_MASK && n >= 0 && n <= MOVE_MASK);
+
+    // The state's own entry is always replaced. Otherwise, an unused entry is taken, or the least valuable entry is replaced.
+    Entry * victim = nullptr;
+    for (Entry & entry : bucket(fingerprint).entries)
+    {
+        if (entry.fingerprint == fingerprint && isCurrent(entry))
+        {
+            victim = &entry;
+            break;
+        }
+        if (!victim || worth(entry) < worth(*victim))
+            victim = &entry;
+    }
+    assert(victim);
+
+    bool replaced       = isCurrent(*victim) && victim->fingerprint != fingerprint;
+    victim->fingerprint = fingerprint;
+    victim->value       = value;
+    victim->depth       = static_cast<int8_t>(depth);
+    victim->generation  = generation_;
+    victim->data        = packData(bound, heap, n);
+    return replaced;
+}
+
+void NimTranspositionTable::age()
+{
+    // When the counter wraps around, the old generations can no longer be told apart from the new ones, so the table is reset
+    if (generation_ == UINT8_MAX)
+        reset();
+    else
+        ++generation_;
+}
+
+void NimTranspositionTable::clear()
+{
+    age();
+    first_ = generation_;
+}
+
+size_t NimTranspositionTable::bytes() const
+{
+    return bucketCount_ * sizeof(Bucket);
+}
+
+int NimTranspositionTable::worth(Entry const & entry) const
+{
+    if (!isCurrent(entry))
+        return INT_MIN;
+    return entry.depth - AGE_WEIGHT * uint8_t(generation_ - entry.generation);
+}
+
+void NimTranspositionTable::reset()
+{
+    Entry const unused{ZHash::UNDEFINED, 0.0f, -1, 0, 0};
+    for (size_t i = 0; i < bucketCount_; ++i)
+    {
+        std::fill(std::begin(buckets_[i].entries), std::end(buckets_[i].entries), unused);
+    }
+    generation_ = 0;
+    first_      = 0;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "TableMemory.h"
+
+#include "NimState/ZHash.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// A transposition table for NimSearch, sized by a memory budget.
+//
+// Entries are stored in buckets the size of a cache line, and a state can be stored in any entry of the bucket selected by its
+// fingerprint, so a probe reads a single cache line. When a bucket is full, the entry replaced is the one that is the least
+// valuable, preferring entries that are shallow and entries left by old searches.
+//
+// Each entry records the generation in which it was stored. age() starts a new generation, so that the entries of earlier
+// searches are replaced first, and clear() discards every entry by starting a new generation that ignores all the earlier ones.
+// Neither touches the entries, except once every 256 generations when the counter wraps around.
+//
+// The table can optionally be backed by huge pages, which reduces TLB misses in large tables. If huge pages are not available,
+// ordinary pages are used.
+class NimTranspositionTable
+{
+public:
+    // The kind of value stored in an entry
+    enum class Bound : uint8_t
+    {
+        EXACT = 0, // The value is exact
+        LOWER,     // The value is a lower bound (the search failed high)
+        UPPER      // The value is an upper bound (the search failed low)
+    };
+
+    // An entry
+    struct Entry
+    {
+        uint64_t fingerprint; // Fingerprint of the state
+        float    value;       // Value of the state
+        int8_t   depth;       // Number of plies searched below the state
+        uint8_t  generation;  // Generation in which the entry was stored
+        uint16_t data;        // Bound and best move, packed
+
+        // Returns the kind of value.
+        Bound bound() const { return static_cast<Bound>(data >> BOUND_SHIFT); }
+
+        // Returns the size of the heap changed by the best move (0 if none).
+        int8_t heap() const { return static_cast<int8_t>(data & MOVE_MASK); }
+
+        // Returns the number of objects removed by the best move.
+        int8_t n() const { return static_cast<int8_t>((data >> MOVE_BITS) & MOVE_MASK); }
+    };
+
+    static size_t constexpr ENTRIES_PER_BUCKET = 4; // Number of entries in a bucket
+    static int constexpr    AGE_WEIGHT         = 8; // Weight of a generation of age against a ply of depth, when replacing
+
+    // Constructor. The number of buckets is the largest power of 2 that fits in the budget, but there is always at least one.
+    NimTranspositionTable(size_t budget, bool hugePages = false);
+
+    // Noncopyable, but movable
+    NimTranspositionTable(NimTranspositionTable const &)             = delete;
+    NimTranspositionTable & operator=(NimTranspositionTable const &) = delete;
+    NimTranspositionTable(NimTranspositionTable && other) noexcept;
+    NimTranspositionTable & operator=(NimTranspositionTable && other) noexcept;
+
+    // Returns the bound and best move of an entry, packed.
+    static uint16_t packData(Bound bound, int heap, int n)
+    {
+        return static_cast<uint16_t>((static_cast<int>(bound) << BOUND_SHIFT) | (n << MOVE_BITS) | heap);
+    }
+
+    // Returns the entry for a state, or nullptr if it is not in the table.
+    Entry const * probe(uint64_t fingerprint) const;
+
+    // Stores the result of a search of a state. Returns true if the entry of a different state was replaced.
+    bool store(uint64_t fingerprint, float value, int depth, Bound bound, int heap, int n);
+
+    // Calls f(entry) for each entry stored since the last clear.
+    template <typename F>
+    void forEach(F f) const
+    {
+        for (size_t i = 0; i < bucketCount_; ++i)
+        {
+            for (Entry const & entry : buckets_[i].entries)
+            {
+                if (isCurrent(entry))
+                    f(entry);
+            }
+        }
+    }
+
+    // Starts a new generation. The entries stored earlier remain, but are replaced before the entries stored since.
+    void age();
+
+    // Discards every entry.
+    void clear();
+
+    // Returns the number of entries in the table.
+    size_t capacity() const { return bucketCount_ * ENTRIES_PER_BUCKET; }
+
+    // Returns the number of bytes used by the table.
+    size_t bytes() const;
+
+    // Returns true if the table is backed by huge pages.
+    bool hugePages() const { return memory_.hugePages(); }
+
+private:
+    static int constexpr      MOVE_BITS   = 7;                    // Number of bits in each part of a move
+    static uint16_t constexpr MOVE_MASK   = (1 << MOVE_BITS) - 1; // Mask for each part of a move
+    static int constexpr      BOUND_SHIFT = 2 * MOVE_BITS;        // Position of the bound
+
+    // A cache line of entries
+    struct alignas(64) Bucket
+    {
+        Entry entries[ENTRIES_PER_BUCKET];
+    };
+    static_assert(sizeof(Bucket) == 64, "A bucket must fill a cache line");
+
+    // Returns the bucket for a state.
+    Bucket & bucket(uint64_t fingerprint) const { return buckets_[fingerprint & (bucketCount_ - 1)]; }
+
+    // Returns true if the entry was stored since the last clear.
+    bool isCurrent(Entry const & entry) const
+    {
+        return entry.fingerprint != ZHash::UNDEFINED && uint8_t(entry.generation - first_) <= uint8_t(generation_ - first_);
+    }
+
+    // Returns the value of keeping an entry. Unused entries and entries discarded by clear() are worth the least.
+    int worth(Entry const & entry) const;
+
+    // Marks every entry as unused and restarts the generations.
+    void reset();
+
+    size_t      bucketCount_; // Number of buckets (a power of 2)
+    TableMemory memory_;      // Memory of the buckets
+    Bucket *    buckets_;     // The buckets
+    uint8_t     generation_;  // Current generation
+    uint8_t     first_;       // First generation since the last clear
+};
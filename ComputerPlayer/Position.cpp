@@ -0,0 +1,102 @@
+#include "Position.h"
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "NimState/NimState.h"
+
+#include <cstdlib>
+#include <istream>
+#include <string>
+#include <vector>
+
+std::string Position::parse(std::istream & in, Position & position)
+{
+    std::string variation;
+    std::string player;
+    in >> variation >> player;
+
+    if (variation == "misere")
+    {
+        position.rules = Rules(Rules::Variation::MISERE);
+    }
+    else if (variation == "normal")
+    {
+        position.rules = Rules(Rules::Variation::NORMAL);
+    }
+    else if (variation.compare(0, 13, "subtraction:{") == 0 && variation.back() == '}')
+    {
+        // A list of the numbers of objects that can be removed
+        std::vector<int> set;
+        char const *     next = variation.c_str() + 13;
+        char const *     last = variation.c_str() + variation.size() - 1; // The closing brace
+        for (;;)
+        {
+            char * end = nullptr;
+            long   n   = std::strtol(next, &end, 10);
+            if (end == next || (end != last && *end != ',') || n < 1 || n > Board::MAX_OBJECTS)
+                return "The subtraction set must be a list of numbers between 1 and " + std::to_string(Board::MAX_OBJECTS) + ".";
+            set.push_back(static_cast<int>(n));
+            if (end == last)
+                break;
+            next = end + 1;
+        }
+        position.rules = Rules(set);
+    }
+    else if (variation.compare(0, 12, "subtraction:") == 0)
+    {
+        char * end   = nullptr;
+        long   limit = std::strtol(variation.c_str() + 12, &end, 10);
+        if (*end != '\0' || end == variation.c_str() + 12 || limit < 1 || limit > Board::MAX_OBJECTS)
+            return "The removal limit must be between 1 and " + std::to_string(Board::MAX_OBJECTS) + ".";
+        position.rules = Rules(Rules::Variation::SUBTRACT, static_cast<int>(limit));
+    }
+    else
+    {
+        return "The variation must be misere, normal, subtraction:<k>, or subtraction:{<a>,<b>,...}.";
+    }
+
+    if (player == "first")
+        position.player = NimState::PlayerId::FIRST;
+    else if (player == "second")
+        position.player = NimState::PlayerId::SECOND;
+    else
+        return "The player to move must be first or second.";
+
+    position.heaps.clear();
+    int n;
+    while (in >> n)
+    {
+        if (n < 0 || n > Board::MAX_OBJECTS)
+            return "The number of objects in each heap must be between 0 and " + std::to_string(Board::MAX_OBJECTS) + ".";
+        if (position.heaps.size() == Board::MAX_HEAPS)
+            return "The maximum number of heaps is " + std::to_string(Board::MAX_HEAPS) + ".";
+        position.heaps.push_back(static_cast<int8_t>(n));
+    }
+    if (!in.eof())
+        return "The sizes of the heaps must be numbers.";
+    if (position.heaps.empty())
+        return "There must be at least one heap.";
+    return std::string();
+}
+
+char const * Position::variationName(Rules::Variation variation)
+{
+    static char const * const NAMES[] = {"misere", "normal", "subtraction"};
+    return NAMES[static_cast<int>(variation)];
+}
+
+std::string Position::rulesName(Rules const & rules)
+{
+    std::string name = variationName(rules.variation());
+    if (rules.variation() != Rules::Variation::SUBTRACT)
+        return name;
+    if (rules.isRange())
+        return name + ":" + std::to_string(rules.removalLimit());
+    char separator = '{';
+    for (int n : rules.subtractionSet())
+    {
+        name += separator + std::to_string(n);
+        separator = ',';
+    }
+    return name + "}";
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Components/Rules.h"
+#include "NimState/NimState.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// A position written as text: the variation, the player to move, and the sizes of the heaps, separated by white space.
+//
+// The variation is "misere", "normal", "subtraction:<k>", where k is the maximum number of objects that can be removed, or
+// "subtraction:{<a>,<b>,...}", where a, b, ... are the numbers of objects that can be removed. The player is "first" or "second".
+// For example:
+//
+//   normal first 1 3 5 7
+//   subtraction:3 second 21 10
+//   subtraction:{1,3,4} first 30
+struct Position
+{
+    Rules               rules;  // Rules of the game
+    NimState::PlayerId  player; // Player to move
+    std::vector<int8_t> heaps;  // Sizes of the heaps
+
+    // Reads a position from the rest of a stream. Returns an error message, or an empty string if the position was read.
+    static std::string parse(std::istream & in, Position & position);
+
+    // Returns the name of a variation, as it is written in a position.
+    static char const * variationName(Rules::Variation variation);
+
+    // Returns the rules of a game as they are written in a position, such as "subtraction:{1,3,4}". Rules with the same name are
+    // the same.
+    static std::string rulesName(Rules const & rules);
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "NimState/NimState.h"
+
+#include <cstdint>
+#include <vector>
+
+// Statistics collected while choosing a single move.
+//
+// Not every engine collects every statistic. The ones that an engine does not collect are left at 0 (or empty).
+struct SearchStatistics
+{
+    // Statistics for one iteration of a search
+    struct Iteration
+    {
+        int      depth;        // Depth of the iteration
+        uint64_t nodes;        // Number of nodes visited
+        double   milliseconds; // Time taken
+        bool     completed;    // False if the iteration was stopped because the budget ran out
+    };
+
+    uint64_t                    nodes           = 0;     // Number of nodes visited
+    uint64_t                    probes          = 0;     // Number of transposition table probes
+    uint64_t                    hits            = 0;     // Number of probes that found the state
+    uint64_t                    stores          = 0;     // Number of values stored in the transposition table
+    uint64_t                    replacements    = 0;     // Number of stores that replaced the entry of a different state
+    uint64_t                    evaluations     = 0;     // Number of calls to the static evaluator
+    double                      branchingFactor = 0.0;   // Ratio of the nodes visited by the last two completed iterations
+    double                      milliseconds    = 0.0;   // Total time taken
+    bool                        tablebase       = false; // True if the move was found in a tablebase instead of by the engine
+    std::vector<Iteration>      iterations;              // Statistics for each iteration
+    std::vector<NimState::Move> principalVariation;      // Expected sequence of moves, starting with the move chosen
+
+    // Resets the statistics without releasing the memory used by the lists.
+    void clear()
+    {
+        nodes           = 0;
+        probes          = 0;
+        hits            = 0;
+        stores          = 0;
+        replacements    = 0;
+        evaluations     = 0;
+        branchingFactor = 0.0;
+        milliseconds    = 0.0;
+        tablebase       = false;
+        iterations.clear();
+        principalVariation.clear();
+    }
+};
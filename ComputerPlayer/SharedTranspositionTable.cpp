@@ -0,0 +1,115 @@
+#include "SharedTranspositionTable.h"
+
+#include "NimState/ZHash.h"
+
+#include <cassert>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <optional>
+
+// Positions of the fields in the data of a slot
+static int const DEPTH_SHIFT      = 32;
+static int const GENERATION_SHIFT = 40;
+static int const PACKED_SHIFT     = 48;
+
+// Every access is relaxed. The two words of a slot are verified against each other, so no ordering between them is needed.
+static auto const RELAXED = std::memory_order_relaxed;
+
+SharedTranspositionTable::SharedTranspositionTable(size_t budget, bool hugePages /*= false*/)
+    : bucketCount_(TableMemory::countBlocks(budget, sizeof(Bucket)))
+    , memory_(bucketCount_ * sizeof(Bucket), hugePages)
+    , buckets_(static_cast<Bucket *>(memory_.data()))
+    , generation_(0)
+{
+    std::uninitialized_default_construct_n(buckets_, bucketCount_);
+    clear();
+}
+
+std::optional<SharedTranspositionTable::Entry> SharedTranspositionTable::probe(uint64_t fingerprint) const
+{
+    for (Slot const & slot : bucket(fingerprint).slots)
+    {
+        Entry entry = load(slot);
+        if (entry.fingerprint == fingerprint)
+            return entry;
+    }
+    return std::nullopt;
+}
+
+bool SharedTranspositionTable::store(uint64_t fingerprint, float value, int depth, Bound bound, int heap, int n)
+{
+    assert(fingerprint != ZHash::UNDEFINED);
+    assert(depth >= 0 && depth <= INT8_MAX);
+
+    // The choice of entry is made from a copy of the bucket, which other threads may be changing. A wrong choice only costs an
+    // entry.
+    uint8_t  generation = generation_.load(RELAXED);
+    Bucket & b          = bucket(fingerprint);
+    Slot *   victim     = nullptr;
+    Entry    replaced{};
+    for (Slot & slot : b.slots)
+    {
+        Entry entry = load(slot);
+        if (entry.fingerprint == fingerprint)
+        {
+            victim   = &slot;
+            replaced = entry;
+            break;
+        }
+        if (!victim || worth(entry, generation) < worth(replaced, generation))
+        {
+            victim   = &slot;
+            replaced = entry;
+        }
+    }
+    assert(victim);
+
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint64_t data = uint64_t(bits) | (uint64_t(uint8_t(depth)) << DEPTH_SHIFT) | (uint64_t(generation) << GENERATION_SHIFT) |
+                    (uint64_t(NimTranspositionTable::packData(bound, heap, n)) << PACKED_SHIFT);
+    victim->data.store(data, RELAXED);
+    victim->check.store(fingerprint ^ data, RELAXED);
+    return replaced.fingerprint != ZHash::UNDEFINED && replaced.fingerprint != fingerprint;
+}
+
+void SharedTranspositionTable::clear()
+{
+    for (size_t i = 0; i < bucketCount_; ++i)
+    {
+        for (Slot & slot : buckets_[i].slots)
+        {
+            slot.data.store(0, RELAXED);
+            slot.check.store(ZHash::UNDEFINED, RELAXED);
+        }
+    }
+    generation_.store(0, RELAXED);
+}
+
+size_t SharedTranspositionTable::bytes() const
+{
+    return bucketCount_ * sizeof(Bucket);
+}
+
+SharedTranspositionTable::Entry SharedTranspositionTable::load(Slot const & slot)
+{
+    uint64_t data  = slot.data.load(RELAXED);
+    uint64_t check = slot.check.load(RELAXED);
+    uint32_t bits  = static_cast<uint32_t>(data);
+    float    value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return Entry{check ^ data,
+                 value,
+                 static_cast<int8_t>(data >> DEPTH_SHIFT),
+                 static_cast<uint8_t>(data >> GENERATION_SHIFT),
+                 static_cast<uint16_t>(data >> PACKED_SHIFT)};
+}
+
+int SharedTranspositionTable::worth(Entry const & entry, uint8_t generation) const
+{
+    // The age wraps around after 256 generations, which only makes a very old entry look new
+    if (entry.fingerprint == ZHash::UNDEFINED)
+        return INT_MIN;
+    return entry.depth - NimTranspositionTable::AGE_WEIGHT * uint8_t(generation - entry.generation);
+}
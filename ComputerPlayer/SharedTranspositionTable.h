@@ -0,0 +1,104 @@
+#pragma once
+
+#include "NimTranspositionTable.h"
+#include "TableMemory.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+// A transposition table for NimSearch that any number of searches and threads can probe and store into at once, without locks.
+//
+// Each entry is two 64-bit words: the data (value, depth, generation, bound and best move, packed) and a check, which is the
+// fingerprint XORed with the data. The words are read and written separately, so a probe that races with a store may see the
+// data of one store and the check of another. Such an entry doesn't verify (check ^ data is not the fingerprint), so the probe
+// misses, just as it would if the entry had been replaced. Two stores racing to the same entry leave an entry that verifies
+// for neither state, which costs an entry but never returns a wrong value.
+//
+// Buckets, replacement and huge pages work as in NimTranspositionTable. The table is shared by searches of the same game only
+// (the same variation and removal limit), because the fingerprint of a state doesn't include the rules. Searches don't age or
+// clear a shared table, because other searches are using it; that is up to its owner.
+class SharedTranspositionTable
+{
+public:
+    using Bound = NimTranspositionTable::Bound; // The kind of value stored in an entry
+    using Entry = NimTranspositionTable::Entry; // An entry, as returned by a probe
+
+    static size_t constexpr ENTRIES_PER_BUCKET = NimTranspositionTable::ENTRIES_PER_BUCKET; // Number of entries in a bucket
+
+    // Constructor. The number of buckets is the largest power of 2 that fits in the budget, but there is always at least one.
+    SharedTranspositionTable(size_t budget, bool hugePages = false);
+
+    // Noncopyable and nonmovable, because other threads may be using it
+    SharedTranspositionTable(SharedTranspositionTable const &)             = delete;
+    SharedTranspositionTable & operator=(SharedTranspositionTable const &) = delete;
+
+    // Returns a copy of the entry for a state, or std::nullopt if it is not in the table. May be called from any thread.
+    std::optional<Entry> probe(uint64_t fingerprint) const;
+
+    // Stores the result of a search of a state. Returns true if the entry of a different state was replaced. May be called
+    // from any thread.
+    bool store(uint64_t fingerprint, float value, int depth, Bound bound, int heap, int n);
+
+    // Calls f(entry) for each entry in the table. Entries stored while it runs may or may not be included. An entry torn by a
+    // racing store is skipped unless it verifies by chance: its fingerprint must belong in the bucket it was found in.
+    template <typename F>
+    void forEach(F f) const
+    {
+        for (size_t i = 0; i < bucketCount_; ++i)
+        {
+            for (Slot const & slot : buckets_[i].slots)
+            {
+                Entry entry = load(slot);
+                if (entry.fingerprint != ZHash::UNDEFINED && &bucket(entry.fingerprint) == &buckets_[i])
+                    f(entry);
+            }
+        }
+    }
+
+    // Starts a new generation. The entries stored earlier remain, but are replaced before the entries stored since. May be
+    // called from any thread.
+    void age() { generation_.fetch_add(1, std::memory_order_relaxed); }
+
+    // Discards every entry. Takes time proportional to the size of the table, and must not be called while it is being used.
+    void clear();
+
+    // Returns the number of entries in the table.
+    size_t capacity() const { return bucketCount_ * ENTRIES_PER_BUCKET; }
+
+    // Returns the number of bytes used by the table.
+    size_t bytes() const;
+
+    // Returns true if the table is backed by huge pages.
+    bool hugePages() const { return memory_.hugePages(); }
+
+private:
+    // An entry, as stored
+    struct Slot
+    {
+        std::atomic<uint64_t> check; // Fingerprint ^ data
+        std::atomic<uint64_t> data;  // Value, depth, generation, bound and best move, packed
+    };
+
+    // A cache line of entries
+    struct alignas(64) Bucket
+    {
+        Slot slots[ENTRIES_PER_BUCKET];
+    };
+    static_assert(sizeof(Bucket) == 64, "A bucket must fill a cache line");
+
+    // Returns the bucket for a state.
+    Bucket & bucket(uint64_t fingerprint) const { return buckets_[fingerprint & (bucketCount_ - 1)]; }
+
+    // Returns the entry in a slot. The fingerprint is ZHash::UNDEFINED if the slot is unused.
+    static Entry load(Slot const & slot);
+
+    // Returns the value of keeping an entry. Unused entries are worth the least.
+    int worth(Entry const & entry, uint8_t generation) const;
+
+    size_t               bucketCount_; // Number of buckets (a power of 2)
+    TableMemory          memory_;      // Memory of the buckets
+    Bucket *             buckets_;     // The buckets
+    std::atomic<uint8_t> generation_;  // Current generation
+};
@@ -0,0 +1,94 @@
+#include "TableMemory.h"
+
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// Returns n rounded up to a multiple of `size`, which is a power of 2.
+static size_t roundUp(size_t n, size_t size)
+{
+    return (n + size - 1) & ~(size - 1);
+}
+
+size_t TableMemory::countBlocks(size_t budget, size_t size)
+{
+    size_t count = 1;
+    while (count * 2 * size <= budget)
+        count *= 2;
+    return count;
+}
+
+TableMemory::TableMemory(size_t bytes, bool hugePages)
+    : data_(nullptr)
+    , length_(roundUp(bytes, CACHE_LINE_SIZE))
+    , alignment_(CACHE_LINE_SIZE)
+    , hugePages_(false)
+{
+    if (hugePages)
+    {
+        length_ = roundUp(bytes, HUGE_PAGE_SIZE);
+#if defined(__linux__) && defined(MAP_HUGETLB)
+        void * memory = mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED)
+        {
+            data_      = memory;
+            alignment_ = 0;
+            hugePages_ = true;
+            return;
+        }
+#endif
+        // Ask for transparent huge pages instead, which must start on a huge page to be used
+        alignment_ = HUGE_PAGE_SIZE;
+        data_      = ::operator new(length_, std::align_val_t(alignment_));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        hugePages_ = madvise(data_, length_, MADV_HUGEPAGE) == 0;
+#endif
+        return;
+    }
+    data_ = ::operator new(length_, std::align_val_t(alignment_));
+}
+
+TableMemory::~TableMemory()
+{
+    release();
+}
+
+TableMemory::TableMemory(TableMemory && other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , length_(other.length_)
+    , alignment_(other.alignment_)
+    , hugePages_(other.hugePages_)
+{
+}
+
+TableMemory & TableMemory::operator=(TableMemory && other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        data_      = std::exchange(other.data_, nullptr);
+        length_    = other.length_;
+        alignment_ = other.alignment_;
+        hugePages_ = other.hugePages_;
+    }
+    return *this;
+}
+
+void TableMemory::release()
+{
+    if (!data_)
+        return;
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    if (alignment_ == 0)
+    {
+        munmap(data_, length_);
+        data_ = nullptr;
+        return;
+    }
+#endif
+    ::operator delete(data_, std::align_val_t(alignment_));
+    data_ = nullptr;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+// The memory of a transposition table, aligned to cache lines and optionally backed by huge pages.
+//
+// If huge pages are requested, the memory is first mapped from the system's pool of huge pages (MAP_HUGETLB). If the pool is
+// empty, the memory is allocated aligned to a huge page and the kernel is asked to back it with transparent huge pages
+// (MADV_HUGEPAGE). Either way, the length is rounded up to a whole number of huge pages, because a mapping of huge pages can't
+// be shorter and a huge page that is only partly used is wasted. If neither works, ordinary pages are used.
+class TableMemory
+{
+public:
+    static size_t constexpr CACHE_LINE_SIZE = 64;              // Alignment of the memory
+    static size_t constexpr HUGE_PAGE_SIZE  = size_t(2) << 20; // Size and alignment of a huge page
+
+    // Returns the largest power of 2 number of blocks of `size` bytes, such as the buckets of a table, that fits in `budget`
+    // bytes, but at least 1.
+    static size_t countBlocks(size_t budget, size_t size);
+
+    // Constructor. Allocates at least `bytes` bytes, which are not initialized.
+    TableMemory(size_t bytes, bool hugePages);
+
+    // Destructor
+    ~TableMemory();
+
+    // Noncopyable, but movable
+    TableMemory(TableMemory const &)             = delete;
+    TableMemory & operator=(TableMemory const &) = delete;
+    TableMemory(TableMemory && other) noexcept;
+    TableMemory & operator=(TableMemory && other) noexcept;
+
+    // Returns the memory, or nullptr if it has been moved away.
+    void * data() const { return data_; }
+
+    // Returns the number of bytes allocated, which may be more than were asked for.
+    size_t length() const { return length_; }
+
+    // Returns true if the memory is backed by huge pages, or the kernel has agreed to back it with transparent huge pages.
+    bool hugePages() const { return hugePages_; }
+
+private:
+    // Releases the memory.
+    void release();
+
+    void * data_;      // The memory
+    size_t length_;    // Number of bytes allocated
+    size_t alignment_; // Alignment of the allocation, or 0 if the memory is mapped
+    bool   hugePages_; // True if the memory is backed by huge pages
+};
@@ -0,0 +1,299 @@
+#include "Tablebase.h"
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "NimState/NimState.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct Tablebase::Header
+{
+    char     magic[8];   // Identifies the file as a tablebase
+    uint32_t version;    // Version of the file format
+    uint8_t  variation;  // Variation solved by the tablebase
+    uint8_t  maxHeaps;   // Maximum number of non-empty heaps in a covered position
+    uint8_t  maxObjects; // Maximum number of objects in a heap in a covered position
+    uint8_t  reserved0;  // Reserved (0)
+    uint64_t count;      // Number of entries
+    uint32_t byteOrder;  // ORDER_MARK, in the byte order of the machine that generated the tablebase
+    uint32_t reserved1;  // Reserved (0)
+};
+
+static_assert(sizeof(Tablebase::Header) == 32, "The header must have no padding");
+
+static char const MAGIC[8]          = {'N', 'I', 'M', 'T', 'B', 'A', 'S', 'E'};
+static uint64_t const MAX_POSITIONS = uint64_t(1) << 28; // Limits the size of a tablebase to 512 MB
+static uint32_t const ORDER_MARK    = 0x01020304;        // Reads differently if the file was written with another byte order
+
+// The fields of an entry
+static uint16_t const WIN_BIT   = 0x8000;
+static int const      MOVE_BITS = 7;
+static uint16_t const MOVE_MASK = (1 << MOVE_BITS) - 1;
+
+static_assert(Board::MAX_OBJECTS <= MOVE_MASK, "The size of a heap must fit in an entry");
+
+namespace
+{
+
+// Binomial coefficients C(n, k) for the ranks of positions, saturated at UINT64_MAX
+class Binomials
+{
+public:
+    static int constexpr MAX_N = Board::MAX_OBJECTS + Board::MAX_HEAPS + 1;
+    static int constexpr MAX_K = Board::MAX_HEAPS + 1;
+
+    Binomials()
+    {
+        for (int n = 0; n < MAX_N; ++n)
+        {
+            values_[n][0] = 1;
+            for (int k = 1; k < MAX_K; ++k)
+            {
+                uint64_t a    = (n > 0) ? values_[n - 1][k - 1] : 0;
+                uint64_t b    = (n > 0) ? values_[n - 1][k] : 0;
+                values_[n][k] = (a > UINT64_MAX - b) ? UINT64_MAX : a + b;
+            }
+        }
+    }
+
+    uint64_t operator()(int n, int k) const
+    {
+        assert(n >= 0 && n < MAX_N && k >= 0 && k < MAX_K);
+        return values_[n][k];
+    }
+
+private:
+    uint64_t values_[MAX_N][MAX_K];
+};
+
+Binomials const binomial;
+
+} // anonymous namespace
+
+Tablebase::Tablebase(void const * data, size_t size)
+    : data_(data)
+    , size_(size)
+{
+    Header const * header = static_cast<Header const *>(data_);
+    entries_              = reinterpret_cast<uint16_t const *>(header + 1);
+    variation_            = static_cast<Rules::Variation>(header->variation);
+    maxHeaps_             = header->maxHeaps;
+    maxObjects_           = header->maxObjects;
+}
+
+Tablebase::~Tablebase()
+{
+#if defined(_WIN32)
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<void *>(data_), size_);
+#endif
+}
+
+std::unique_ptr<Tablebase> Tablebase::open(std::string const & path)
+{
+    void const * data = nullptr;
+    size_t       size = 0;
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart >= LONGLONG(sizeof(Header)))
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+        {
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            size = static_cast<size_t>(fileSize.QuadPart);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    struct stat status;
+    if (fstat(fd, &status) == 0 && status.st_size >= static_cast<off_t>(sizeof(Header)))
+    {
+        size        = static_cast<size_t>(status.st_size);
+        void * view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        data        = (view == MAP_FAILED) ? nullptr : view;
+    }
+    ::close(fd);
+#endif
+    if (!data)
+        return nullptr;
+
+    // Once the tablebase owns the mapping, it is unmapped if the file turns out to be invalid
+    std::unique_ptr<Tablebase> tablebase(new Tablebase(data, size));
+    Header const *             header = static_cast<Header const *>(data);
+    bool valid = std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 && header->version == VERSION &&
+                 header->byteOrder == ORDER_MARK &&
+                 (header->variation == static_cast<uint8_t>(Rules::Variation::MISERE) ||
+                  header->variation == static_cast<uint8_t>(Rules::Variation::NORMAL)) &&
+                 header->maxHeaps >= 1 && header->maxHeaps <= Board::MAX_HEAPS && header->maxObjects >= 1 &&
+                 header->maxObjects <= Board::MAX_OBJECTS &&
+                 header->count == positionCount(header->maxHeaps, header->maxObjects) &&
+                 size == sizeof(Header) + header->count * sizeof(uint16_t);
+    if (!valid)
+        return nullptr;
+    return tablebase;
+}
+
+bool Tablebase::generate(std::string const & path, Rules const & rules, int maxHeaps, int maxObjects)
+{
+    if (rules.variation() != Rules::Variation::MISERE && rules.variation() != Rules::Variation::NORMAL)
+        return false;
+    if (maxHeaps < 1 || maxHeaps > Board::MAX_HEAPS || maxObjects < 1 || maxObjects > Board::MAX_OBJECTS)
+        return false;
+    uint64_t count = positionCount(maxHeaps, maxObjects);
+    if (count == 0)
+        return false;
+
+    std::vector<uint16_t> entries = solve(rules.variation(), maxHeaps, maxObjects);
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version    = VERSION;
+    header.byteOrder  = ORDER_MARK;
+    header.variation  = static_cast<uint8_t>(rules.variation());
+    header.maxHeaps   = static_cast<uint8_t>(maxHeaps);
+    header.maxObjects = static_cast<uint8_t>(maxObjects);
+    header.count      = count;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    out.write(reinterpret_cast<char const *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(uint16_t)));
+    return static_cast<bool>(out);
+}
+
+std::optional<Tablebase::Result> Tablebase::probe(Board const & board) const
+{
+    // Put the heaps in canonical order, with empty heaps filling the unused slots at the front
+    uint8_t sorted[Board::MAX_HEAPS] = {};
+    int     heaps                    = 0;
+    for (int n : board)
+    {
+        if (n == 0)
+            continue;
+        if (heaps == maxHeaps_ || n > maxObjects_)
+            return std::nullopt;
+        sorted[heaps++] = static_cast<uint8_t>(n);
+    }
+    std::sort(sorted, sorted + maxHeaps_);
+
+    uint16_t entry = entries_[rank(sorted, maxHeaps_)];
+    Result   result{(entry & WIN_BIT) != 0, std::nullopt};
+    int      from = entry & MOVE_MASK;
+    int      n    = (entry >> MOVE_BITS) & MOVE_MASK;
+    if (result.win && from > 0)
+    {
+        for (int i = 0; i < static_cast<int>(board.size()); ++i)
+        {
+            if (board.heap(i) == from)
+            {
+                result.move = NimState::Move{static_cast<int8_t>(i), static_cast<int8_t>(n)};
+                break;
+            }
+        }
+        assert(result.move.has_value());
+    }
+    return result;
+}
+
+uint64_t Tablebase::positionCount(int maxHeaps, int maxObjects)
+{
+    // The number of multisets of maxHeaps sizes from 0 to maxObjects
+    uint64_t count = binomial(maxObjects + maxHeaps, maxHeaps);
+    return (count <= MAX_POSITIONS) ? count : 0;
+}
+
+uint64_t Tablebase::rank(uint8_t const * sorted, int count)
+{
+    // Adding i to the i-th size makes the sizes strictly increasing, so they form a combination that can be ranked with the
+    // combinatorial number system.
+    uint64_t r = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        r += binomial(sorted[i] + i, i + 1);
+    }
+    return r;
+}
+
+void Tablebase::unrank(uint64_t r, uint8_t * sorted, int count)
+{
+    for (int i = count - 1; i >= 0; --i)
+    {
+        // Find the largest c such that C(c, i + 1) <= r
+        int c = i;
+        while (binomial(c + 1, i + 1) <= r)
+            ++c;
+        r -= binomial(c, i + 1);
+        sorted[i] = static_cast<uint8_t>(c - i);
+    }
+}
+
+std::vector<uint16_t> Tablebase::solve(Rules::Variation variation, int maxHeaps, int maxObjects)
+{
+    uint64_t              count = positionCount(maxHeaps, maxObjects);
+    std::vector<uint16_t> entries(count, 0);
+
+    // A move always leads to a position with a lower rank, so the positions are solved in order of rank
+    uint8_t sorted[Board::MAX_HEAPS];
+    uint8_t child[Board::MAX_HEAPS];
+    for (uint64_t r = 0; r < count; ++r)
+    {
+        unrank(r, sorted, maxHeaps);
+
+        // If there are no objects left, the player to move has won the misre variation and lost the normal variation
+        if (sorted[maxHeaps - 1] == 0)
+        {
+            entries[r] = (variation == Rules::Variation::MISERE) ? WIN_BIT : 0;
+            continue;
+        }
+
+        // The position is a win if any move leads to a loss. Larger moves are tried first, so that wins are quicker.
+        for (int j = maxHeaps - 1; j >= 0 && entries[r] == 0; --j)
+        {
+            int from = sorted[j];
+            if (from == 0 || (j < maxHeaps - 1 && sorted[j + 1] == from))
+                continue; // A heap of the same size has already been tried
+            for (int n = from; n >= 1; --n)
+            {
+                // Replace the heap and move it down to keep the sizes sorted
+                std::copy(sorted, sorted + maxHeaps, child);
+                int k = j;
+                while (k > 0 && child[k - 1] > from - n)
+                {
+                    child[k] = child[k - 1];
+                    --k;
+                }
+                child[k] = static_cast<uint8_t>(from - n);
+
+                if ((entries[rank(child, maxHeaps)] & WIN_BIT) == 0)
+                {
+                    entries[r] = static_cast<uint16_t>(WIN_BIT | (n << MOVE_BITS) | from);
+                    break;
+                }
+            }
+        }
+    }
+    return entries;
+}
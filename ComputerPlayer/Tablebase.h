@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Components/Rules.h"
+#include "NimState/NimState.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+class Board;
+
+// A precomputed table of the outcome and best move of every position up to a given size, stored in a memory-mapped file.
+//
+// A position is identified by its canonical form: the sizes of its non-empty heaps, sorted. A tablebase covers every position
+// with at most `maxHeaps` non-empty heaps of at most `maxObjects` objects each. The canonical forms are numbered with the
+// combinatorial number system, so a probe computes the position's entry directly and touches a single page of the file.
+//
+// File format (native byte order, since the entries are read in place; a file written with another byte order is rejected):
+//   Header                      (32 bytes)
+//   uint16_t entries[count]     One entry for each position, in order of rank
+// Bit 15 of an entry is set if the player to move wins. If so, bits 0-6 are the size of the heap to take from and bits 7-13 are
+// the number of objects to take. A win with no move is a finished game of the misre variation.
+//
+// Only the misre and normal variations are supported.
+class Tablebase
+{
+public:
+    static uint32_t constexpr VERSION = 2; // Version of the file format
+
+    // The header of a tablebase file
+    struct Header;
+
+    // The result of a probe
+    struct Result
+    {
+        bool                          win;  // True if the player to move wins
+        std::optional<NimState::Move> move; // The winning move, if the player to move wins
+    };
+
+    // Destructor
+    ~Tablebase();
+
+    // Noncopyable
+    Tablebase(Tablebase const &)             = delete;
+    Tablebase & operator=(Tablebase const &) = delete;
+
+    // Maps a tablebase file into memory. Returns nullptr if the file can't be mapped or is not a valid tablebase.
+    static std::unique_ptr<Tablebase> open(std::string const & path);
+
+    // Solves every position covered by the given limits and writes the tablebase to a file. Returns false if the limits or the
+    // variation are not supported, or if the file can't be written.
+    static bool generate(std::string const & path, Rules const & rules, int maxHeaps, int maxObjects);
+
+    // Returns the result for a board, or std::nullopt if the board is not covered by the tablebase.
+    std::optional<Result> probe(Board const & board) const;
+
+    // Returns the variation solved by the tablebase.
+    Rules::Variation variation() const { return variation_; }
+
+    // Returns the maximum number of non-empty heaps in a covered position.
+    int maxHeaps() const { return maxHeaps_; }
+
+    // Returns the maximum number of objects in a heap in a covered position.
+    int maxObjects() const { return maxObjects_; }
+
+private:
+    // Constructor
+    Tablebase(void const * data, size_t size);
+
+    // Returns the number of positions covered by the given limits, or 0 if there are too many to index.
+    static uint64_t positionCount(int maxHeaps, int maxObjects);
+
+    // Returns the rank of a canonical position, whose heap sizes are sorted in ascending order.
+    static uint64_t rank(uint8_t const * sorted, int count);
+
+    // Returns the position with the given rank, with heap sizes sorted in ascending order.
+    static void unrank(uint64_t rank, uint8_t * sorted, int count);
+
+    // Solves every position and returns the entries.
+    static std::vector<uint16_t> solve(Rules::Variation variation, int maxHeaps, int maxObjects);
+
+    void const *     data_;       // The mapped file
+    size_t           size_;       // Size of the mapped file
+    uint16_t const * entries_;    // The entries, in order of rank
+    Rules::Variation variation_;  // Variation solved by the tablebase
+    int              maxHeaps_;   // Maximum number of non-empty heaps in a covered position
+    int              maxObjects_; // Maximum number of objects in a heap in a covered position
+};
@@ -0,0 +1,184 @@
+#include "gtest/gtest.h"
+
+#include "ComputerPlayer/BatchAnalyzer.h"
+#include "ComputerPlayer/NimSearch.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Returns the lines of a string.
+static std::vector<std::string> lines(std::string const & text)
+{
+    std::vector<std::string> result;
+    std::istringstream       in(text);
+    std::string              line;
+    while (std::getline(in, line))
+    {
+        result.push_back(line);
+    }
+    return result;
+}
+
+// Returns true if a line of JSON contains the given text.
+static bool contains(std::string const & line, std::string const & text)
+{
+    return line.find(text) != std::string::npos;
+}
+
+namespace Nim
+{
+
+TEST(BatchAnalyzer, Constructor)
+{
+    // Nothing to test here, just make sure the constructor executes without error
+    ASSERT_NO_THROW(BatchAnalyzer(NimSearch::Settings{2}, 1));
+    ASSERT_NO_THROW(BatchAnalyzer(NimSearch::Settings{2}, 4));
+}
+
+TEST(BatchAnalyzer, Run)
+{
+    BatchAnalyzer      analyzer(NimSearch::Settings{2}, 2);
+    std::istringstream in("normal first 1 2 3\n"
+                          "# A comment, followed by an empty line\n"
+                          "\n"
+                          "normal second 1 2 4\n"
+                          "misere first 1 1\n"
+                          "subtraction:3 first 21\n"
+                          "misere first 0 0\n"
+                          "subtraction:{1,3,4} first 12 1\n"
+                          "subtraction:{2,5,7} second 1 1\n");
+    std::ostringstream out;
+    EXPECT_EQ(analyzer.run(in, out), 7);
+
+    std::vector<std::string> results = lines(out.str());
+    ASSERT_EQ(results.size(), 7);
+
+    // The nim-sum is 0, so every move loses
+    EXPECT_TRUE(contains(results[0], "\"line\":1"));
+    EXPECT_TRUE(contains(results[0], "\"result\":\"loss\""));
+    EXPECT_TRUE(contains(results[0], "\"winningMoves\":[]"));
+    EXPECT_TRUE(contains(results[0], "\"nodes\":"));
+
+    // The only winning move takes 1 from the heap of 4
+    EXPECT_TRUE(contains(results[1], "\"line\":4"));
+    EXPECT_TRUE(contains(results[1], "\"player\":\"second\""));
+    EXPECT_TRUE(contains(results[1], "\"result\":\"win\""));
+    EXPECT_TRUE(contains(results[1], "\"winningMoves\":[{\"count\":1,\"heap\":2}]"));
+    EXPECT_TRUE(contains(results[1], "\"move\":{\"count\":1,\"heap\":2}"));
+
+    // An even number of heaps with 1 object is a win in the misre variation
+    EXPECT_TRUE(contains(results[2], "\"result\":\"win\""));
+
+    // 21 is 1 more than a multiple of 4, so the winning move removes 1
+    EXPECT_TRUE(contains(results[3], "\"removalLimit\":3"));
+    EXPECT_TRUE(contains(results[3], "\"winningMoves\":[{\"count\":1,\"heap\":0}]"));
+
+    // If the game is over, there is no search
+    EXPECT_TRUE(contains(results[4], "\"result\":\"win\""));
+    EXPECT_FALSE(contains(results[4], "\"move\""));
+
+    // The Grundy values of 12 and 1 with {1, 3, 4} are 3 and 1, so the only winning move leaves 8, whose Grundy value is 1
+    EXPECT_TRUE(contains(results[5], "\"subtractionSet\":[1,3,4]"));
+    EXPECT_TRUE(contains(results[5], "\"winningMoves\":[{\"count\":4,\"heap\":0}]"));
+
+    // The game is over when no heap is large enough for a move
+    EXPECT_TRUE(contains(results[6], "\"result\":\"loss\""));
+    EXPECT_FALSE(contains(results[6], "\"move\""));
+}
+
+TEST(BatchAnalyzer, Run_Errors)
+{
+    // A line that can't be parsed is reported, and the analysis continues
+    BatchAnalyzer      analyzer(NimSearch::Settings{2}, 1);
+    std::istringstream in("chess first 1 2\n"
+                          "normal third 1 2\n"
+                          "normal first 1 two\n"
+                          "normal first 100\n"
+                          "normal first\n"
+                          "subtraction:0 first 5\n"
+                          "subtraction:{} first 5\n"
+                          "subtraction:{1,x} first 5\n"
+                          "subtraction:{1,3,} first 5\n"
+                          "normal first 3\n");
+    std::ostringstream out;
+    EXPECT_EQ(analyzer.run(in, out), 10);
+
+    std::vector<std::string> results = lines(out.str());
+    ASSERT_EQ(results.size(), 10);
+    for (int i = 0; i < 9; ++i)
+    {
+        EXPECT_TRUE(contains(results[i], "\"error\":")) << results[i];
+    }
+    EXPECT_TRUE(contains(results[9], "\"result\":\"win\""));
+}
+
+TEST(BatchAnalyzer, Run_Order)
+{
+    // The results are in the same order as the positions, across blocks and threads
+    std::string input;
+    for (size_t i = 0; i < BatchAnalyzer::BLOCK_SIZE + 100; ++i)
+    {
+        input += "normal first " + std::to_string(i % 10) + " " + std::to_string(i % 7) + "\n";
+    }
+    BatchAnalyzer      analyzer(NimSearch::Settings{2}, 3);
+    std::istringstream in(input);
+    std::ostringstream out;
+    EXPECT_EQ(analyzer.run(in, out), BatchAnalyzer::BLOCK_SIZE + 100);
+
+    std::vector<std::string> results = lines(out.str());
+    ASSERT_EQ(results.size(), BatchAnalyzer::BLOCK_SIZE + 100);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        ASSERT_TRUE(contains(results[i], "\"line\":" + std::to_string(i + 1) + ",")) << results[i];
+    }
+}
+
+TEST(BatchAnalyzer, Run_SharedTable)
+{
+    // The searches of every thread share a table for each variation, which doesn't change the results. Each position is small
+    // enough to be searched to the end, so the move chosen for a win must be a winning move.
+    std::vector<std::string> positions{"normal first 1 2 3",
+                                       "normal second 1 2 4",
+                                       "misere first 1 1",
+                                       "misere first 2 3 1",
+                                       "normal first 3 4",
+                                       "misere second 1 4",
+                                       "subtraction:3 first 7",
+                                       "normal first 2 2 1"};
+    std::string              input;
+    for (int i = 0; i < 50; ++i)
+    {
+        input += positions[i % positions.size()] + "\n";
+    }
+    BatchAnalyzer      analyzer(NimSearch::Settings{10}, 4);
+    std::istringstream in(input);
+    std::ostringstream out;
+    EXPECT_EQ(analyzer.run(in, out), 50);
+
+    std::vector<std::string> results = lines(out.str());
+    ASSERT_EQ(results.size(), 50);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        // The same position, analyzed alone
+        BatchAnalyzer      alone(NimSearch::Settings{10}, 1);
+        std::istringstream aloneIn(positions[i % positions.size()]);
+        std::ostringstream aloneOut;
+        alone.run(aloneIn, aloneOut);
+
+        nlohmann::json shared   = nlohmann::json::parse(results[i]);
+        nlohmann::json expected = nlohmann::json::parse(aloneOut.str());
+        EXPECT_EQ(shared["result"], expected["result"]) << results[i];
+        EXPECT_EQ(shared["winningMoves"], expected["winningMoves"]) << results[i];
+        if (shared["result"] == "win")
+        {
+            nlohmann::json const & winning = shared["winningMoves"];
+            EXPECT_NE(std::find(winning.begin(), winning.end(), shared["move"]), winning.end()) << results[i];
+        }
+    }
+}
+
+} // namespace Nim
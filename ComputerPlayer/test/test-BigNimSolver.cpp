@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+
+#include "Components/BigBoard.h"
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "ComputerPlayer/BigNimSolver.h"
+#include "ComputerPlayer/NimSolver.h"
+
+#include <cstdint>
+#include <vector>
+
+// Checks the solver against NimSolver for every board with heaps up to the given sizes.
+static void checkAllBoards(Rules const & rules, std::vector<int8_t> const & limits)
+{
+    NimSolver           solver(rules);
+    BigNimSolver        bigSolver(rules);
+    std::vector<int8_t> heaps(limits.size(), 0);
+    while (true)
+    {
+        Board    board(heaps);
+        BigBoard bigBoard(std::vector<uint64_t>(heaps.begin(), heaps.end()));
+        auto     move    = solver.winningMove(board);
+        auto     bigMove = bigSolver.winningMove(bigBoard);
+        EXPECT_EQ(bigMove.has_value(), move.has_value());
+        if (bigMove.has_value())
+        {
+            // The move can be a different winning move, so check that it leaves a losing position instead
+            ASSERT_LE(bigMove->n, bigBoard.heap(bigMove->i));
+            EXPECT_TRUE(rules.allows(static_cast<int>(bigMove->i), static_cast<int>(bigMove->n)));
+            Board response = board;
+            response.remove(static_cast<int>(bigMove->i), static_cast<int>(bigMove->n));
+            EXPECT_FALSE(solver.winningMove(response).has_value());
+        }
+
+        // Next board
+        size_t k = 0;
+        while (k < heaps.size() && heaps[k] == limits[k])
+        {
+            heaps[k] = 0;
+            ++k;
+        }
+        if (k == heaps.size())
+            break;
+        ++heaps[k];
+    }
+}
+
+namespace Nim
+{
+
+TEST(BigNimSolver, Constructor)
+{
+    // Nothing to test here, just make sure the constructor executes without error
+    Rules rules;
+    ASSERT_NO_THROW(BigNimSolver{rules});
+}
+
+TEST(BigNimSolver, WinningMove_Normal)
+{
+    checkAllBoards(Rules(Rules::Variation::NORMAL), {3, 4, 5, 2});
+
+    // The heaps can be very large
+    BigNimSolver solver(Rules(Rules::Variation::NORMAL));
+    BigBoard     board({1ull << 40, (1ull << 40) + 3, 1});
+    auto         move = solver.winningMove(board);
+    ASSERT_TRUE(move.has_value());
+    board.remove(move->i, move->n);
+    EXPECT_EQ(board.nimSum(), 0);
+}
+
+TEST(BigNimSolver, WinningMove_Misere)
+{
+    checkAllBoards(Rules(Rules::Variation::MISERE), {3, 4, 5, 2});
+    checkAllBoards(Rules(Rules::Variation::MISERE), {1, 1, 1, 1, 6});
+
+    // With one large heap, the winning move leaves an odd number of heaps with 1 object
+    BigNimSolver solver(Rules(Rules::Variation::MISERE));
+    auto         move = solver.winningMove(BigBoard({1, UINT64_MAX}));
+    ASSERT_TRUE(move.has_value());
+    EXPECT_EQ(move->i, 1);
+    EXPECT_EQ(move->n, UINT64_MAX);
+}
+
+TEST(BigNimSolver, WinningMove_Subtract)
+{
+    checkAllBoards(Rules(Rules::Variation::SUBTRACT, 1), {20});
+    checkAllBoards(Rules(Rules::Variation::SUBTRACT, 4), {30});
+    checkAllBoards(Rules(Rules::Variation::SUBTRACT, 3), {9, 9});
+
+    // A heap of 10^18 + 2 objects with a limit of 4 has a Grundy value of 2 + 0 = 2 (10^18 is a multiple of 5)
+    BigNimSolver solver(Rules(Rules::Variation::SUBTRACT, 4));
+    auto         move = solver.winningMove(BigBoard({1000000000000000002ull}));
+    ASSERT_TRUE(move.has_value());
+    EXPECT_EQ(move->n, 2);
+}
+
+TEST(BigNimSolver, WinningMove_SubtractionSet)
+{
+    checkAllBoards(Rules(std::vector<int>{1, 3, 4}), {30});
+    checkAllBoards(Rules(std::vector<int>{2, 5, 7}), {10, 12});
+
+    // The Grundy values of {2, 5, 7} have a period of 22. 10^18 is 12 more than a multiple of 22, so its Grundy value is 1,
+    // and removing 2 leaves a Grundy value of 0.
+    BigNimSolver solver(Rules(std::vector<int>{2, 5, 7}));
+    auto         move = solver.winningMove(BigBoard({1000000000000000000ull}));
+    ASSERT_TRUE(move.has_value());
+    EXPECT_EQ(move->n, 2);
+}
+
+TEST(BigNimSolver, WinningMove_HeapLimits)
+{
+    checkAllBoards(Rules(Rules::Variation::SUBTRACT, std::vector<int>{2, 3, 1}), {10, 12, 8});
+
+    // The Grundy value of a heap of 10^18 is 10^18 mod 4 = 0 with a limit of 3, and 10^18 mod 8 = 0 with a limit of 7, so
+    // the winning move takes 1 from the heap of 7, whose Grundy value is 7 mod 6 = 1 with a limit of 5
+    BigNimSolver solver(Rules(Rules::Variation::SUBTRACT, std::vector<int>{3, 7, 5}));
+    auto         move = solver.winningMove(BigBoard({1000000000000000000ull, 1000000000000000000ull, 7}));
+    ASSERT_TRUE(move.has_value());
+    EXPECT_EQ(move->i, 2u);
+    EXPECT_EQ(move->n, 1u);
+}
+
+TEST(BigNimSolver, WinningMove_Octal)
+{
+    // In Kayles, two equal heaps are a loss, however large they are, and the winning move from a single heap leaves two heaps
+    // whose Grundy values are equal. Proving that Kayles is periodic takes more values than a Board needs.
+    Rules        rules(Rules::Variation::OCTAL, "0.77", OctalGame::DEFAULT_LIMIT);
+    BigNimSolver solver(rules);
+    EXPECT_FALSE(solver.winningMove(BigBoard({1000000000000000000ull, 1000000000000000000ull})).has_value());
+    auto move = solver.winningMove(BigBoard({1000000000000000001ull}));
+    ASSERT_TRUE(move.has_value());
+    EXPECT_EQ(move->i, 0u);
+    OctalGame const * kayles = rules.octalGame();
+    EXPECT_TRUE(kayles->isLegal(1000000000000000001ull, move->n, move->split));
+    uint64_t rest = 1000000000000000001ull - move->n - move->split;
+    EXPECT_EQ(kayles->value(rest), kayles->value(move->split));
+
+    // The winning move of the small solver also wins on a big board
+    Rules        dawson(Rules::Variation::OCTAL, "0.137");
+    BigNimSolver big(dawson);
+    NimSolver    small(dawson);
+    for (int8_t a = 0; a < 40; ++a)
+    {
+        for (int8_t b = 0; b < 40; ++b)
+        {
+            auto bigMove   = big.winningMove(BigBoard({static_cast<uint64_t>(a), static_cast<uint64_t>(b)}));
+            auto smallMove = small.winningMove(Board({a, b}));
+            ASSERT_EQ(bigMove.has_value(), smallMove.has_value()) << int(a) << " " << int(b);
+        }
+    }
+}
+
+TEST(BigNimSolver, WinningMove_GameOver)
+{
+    BigNimSolver solver(Rules(Rules::Variation::NORMAL));
+    EXPECT_FALSE(solver.winningMove(BigBoard()).has_value()); // There are no moves if the game is over
+    EXPECT_FALSE(solver.winningMove(BigBoard({0, 0, 0})).has_value());
+}
+
+} // namespace Nim
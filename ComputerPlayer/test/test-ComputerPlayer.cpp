@@ -4,7 +4,12 @@
 #include "Components/Rules.h"
 #include "ComputerPlayer/ComputerPlayer.h"
 #include "NimState/NimState.h"
+#include <nlohmann/json.hpp>
+#include <cstdio>
+#include <memory>
 #include <numeric>
+#include <sstream>
+#include <string>
 
 // Helper function to check if two boards have exactly one heap difference
 static bool exactlyOneDifference(Board const & board1, Board const & board2)
@@ -65,4 +70,210 @@ TEST(ComputerPlayer, Move)
     }
 }
 
+TEST(ComputerPlayer, Move_Solver)
+{
+    // The first player has a winning position, so the solver must win every game.
+    Rules          rules(Rules::Variation::MISERE);
+    ComputerPlayer computer1(NimState::PlayerId::FIRST, rules, ComputerPlayer::Engine::SOLVER);
+    ComputerPlayer computer2(NimState::PlayerId::SECOND, rules, ComputerPlayer::Engine::SOLVER);
+    NimState       state(Board({1, 3, 5, 7, 9}), rules);
+    ASSERT_EQ(computer1.engine(), ComputerPlayer::Engine::SOLVER);
+
+    while (!state.isGameOver())
+    {
+        Board board0 = state.board();
+        if (state.whoseTurn() == NimState::PlayerId::FIRST)
+            computer1.move(&state);
+        else
+            computer2.move(&state);
+        ASSERT_TRUE(exactlyOneDifference(board0, state.board())); // Check that exactly one heap has changed
+    }
+    EXPECT_EQ(state.winner(), NimState::PlayerId::FIRST);
+}
+
+TEST(ComputerPlayer, Move_Subtract)
+{
+    // The subtraction variation is played from the Grundy values of the heaps, whatever engine is requested. The first player
+    // has a winning position (the Grundy values are 2, 1 and 4), so it must win every game.
+    Rules          rules(Rules::Variation::SUBTRACT, std::vector<int>{4, 3, 7});
+    ComputerPlayer computer1(NimState::PlayerId::FIRST, rules, ComputerPlayer::Engine::SEARCH);
+    ComputerPlayer computer2(NimState::PlayerId::SECOND, rules, ComputerPlayer::Engine::IN_PLACE);
+    NimState       state(Board({12, 9, 20}), rules);
+    EXPECT_EQ(computer1.engine(), ComputerPlayer::Engine::SOLVER);
+    EXPECT_EQ(computer2.engine(), ComputerPlayer::Engine::SOLVER);
+
+    while (!state.isGameOver())
+    {
+        Board board0 = state.board();
+        if (state.whoseTurn() == NimState::PlayerId::FIRST)
+            computer1.move(&state);
+        else
+            computer2.move(&state);
+        ASSERT_TRUE(exactlyOneDifference(board0, state.board())); // Check that exactly one heap has changed
+        ASSERT_LE(state.lastMove()->n, rules.removalLimit(state.lastMove()->i));
+    }
+    EXPECT_EQ(state.winner(), NimState::PlayerId::FIRST);
+}
+
+TEST(ComputerPlayer, Move_Octal)
+{
+    // In Kayles (0.77), the Grundy values of heaps of 9 and 6 are 4 and 3, so the first player has a winning position and must
+    // win every game, whether it searches or solves. Engine::IN_PLACE doesn't split heaps, so the solver is used instead.
+    Rules          rules(Rules::Variation::OCTAL, "0.77");
+    ComputerPlayer computer1(NimState::PlayerId::FIRST, rules, ComputerPlayer::Engine::SEARCH, NimSearch::Settings{4});
+    ComputerPlayer computer2(NimState::PlayerId::SECOND, rules, ComputerPlayer::Engine::IN_PLACE);
+    NimState       state(Board({9, 6}), rules);
+    EXPECT_EQ(computer1.engine(), ComputerPlayer::Engine::SEARCH);
+    EXPECT_EQ(computer2.engine(), ComputerPlayer::Engine::SOLVER);
+
+    while (!state.isGameOver())
+    {
+        size_t heaps = state.board().size();
+        if (state.whoseTurn() == NimState::PlayerId::FIRST)
+            computer1.move(&state);
+        else
+            computer2.move(&state);
+        NimState::Move move = *state.lastMove();
+        ASSERT_EQ(state.board().size(), heaps + (move.split > 0)); // A split adds a heap
+        ASSERT_LE(move.n, 2);
+    }
+    EXPECT_EQ(state.winner(), NimState::PlayerId::FIRST);
+}
+
+TEST(ComputerPlayer, Move_InPlace)
+{
+    Rules          rules(Rules::Variation::NORMAL);
+    ComputerPlayer computer1(NimState::PlayerId::FIRST, rules, ComputerPlayer::Engine::IN_PLACE);
+    ComputerPlayer computer2(NimState::PlayerId::SECOND, rules, ComputerPlayer::Engine::IN_PLACE);
+    NimState       state(Board({3, 4, 5}), rules);
+
+    // The first player has a winning position and the tree is small enough to search completely
+    while (!state.isGameOver())
+    {
+        Board board0 = state.board();
+        if (state.whoseTurn() == NimState::PlayerId::FIRST)
+            computer1.move(&state);
+        else
+            computer2.move(&state);
+        ASSERT_TRUE(exactlyOneDifference(board0, state.board())); // Check that exactly one heap has changed
+    }
+    EXPECT_EQ(state.winner(), NimState::PlayerId::FIRST);
+}
+
+TEST(ComputerPlayer, Statistics)
+{
+    Rules rules(Rules::Variation::NORMAL);
+    for (auto engine : {ComputerPlayer::Engine::SEARCH, ComputerPlayer::Engine::SOLVER, ComputerPlayer::Engine::IN_PLACE})
+    {
+        ComputerPlayer computer(NimState::PlayerId::FIRST, rules, engine);
+        NimState       state(Board({3, 4, 5}), rules);
+        computer.move(&state);
+
+        // The principal variation starts with the move that was made
+        SearchStatistics const & stats = computer.statistics();
+        ASSERT_FALSE(stats.principalVariation.empty());
+        EXPECT_EQ(stats.principalVariation.front().i, state.lastMove()->i);
+        EXPECT_EQ(stats.principalVariation.front().n, state.lastMove()->n);
+        EXPECT_GE(stats.milliseconds, 0.0);
+        if (engine != ComputerPlayer::Engine::SOLVER)
+        {
+            EXPECT_GT(stats.nodes, 0u);
+            EXPECT_GT(stats.evaluations, 0u);
+            EXPECT_FALSE(stats.iterations.empty());
+        }
+    }
+}
+
+TEST(ComputerPlayer, Telemetry)
+{
+    // Each move writes one line of JSON
+    Rules              rules(Rules::Variation::NORMAL);
+    ComputerPlayer     computer(NimState::PlayerId::FIRST, rules, ComputerPlayer::Engine::IN_PLACE);
+    NimState           state(Board({3, 4, 5}), rules);
+    std::ostringstream out;
+    computer.setTelemetry(&out);
+    computer.move(&state);
+    computer.setTelemetry(nullptr);
+    state.move(0, 1);
+    computer.move(&state);
+
+    std::istringstream in(out.str());
+    std::string        line;
+    ASSERT_TRUE(std::getline(in, line));
+    nlohmann::json json = nlohmann::json::parse(line);
+    EXPECT_EQ(json["player"], "first");
+    EXPECT_EQ(json["engine"], "in-place");
+    EXPECT_EQ(json["board"], nlohmann::json::array({3, 4, 5}));
+    EXPECT_EQ(json["move"], json["principalVariation"][0]);
+    EXPECT_GT(json["nodes"].get<uint64_t>(), 0u);
+    EXPECT_GE(json["probes"].get<uint64_t>(), json["hits"].get<uint64_t>());
+    EXPECT_FALSE(json["iterations"].empty());
+    EXPECT_FALSE(std::getline(in, line)); // Telemetry was turned off for the second move
+}
+
+TEST(ComputerPlayer, Snapshot)
+{
+    Rules       rules(Rules::Variation::NORMAL);
+    std::string path = testing::TempDir() + "test-ComputerPlayer-Snapshot.nimtt";
+
+    ComputerPlayer cold(NimState::PlayerId::FIRST, rules, ComputerPlayer::Engine::IN_PLACE);
+    NimState       state(Board({3, 4, 5}), rules);
+    cold.move(&state);
+    ASSERT_TRUE(cold.saveTranspositionTable(path));
+
+    // A player that loads the snapshot doesn't need to search as much
+    ComputerPlayer warm(NimState::PlayerId::FIRST, rules, ComputerPlayer::Engine::IN_PLACE);
+    ASSERT_TRUE(warm.loadTranspositionTable(path));
+    NimState again(Board({3, 4, 5}), rules);
+    warm.move(&again);
+    EXPECT_LT(warm.nodesSearched(), cold.nodesSearched());
+
+    // Only the in-place search has a table that can be saved
+    ComputerPlayer solver(NimState::PlayerId::FIRST, rules, ComputerPlayer::Engine::SOLVER);
+    EXPECT_FALSE(solver.saveTranspositionTable(path));
+    EXPECT_FALSE(solver.loadTranspositionTable(path));
+
+    // Missing file
+    std::remove(path.c_str());
+    EXPECT_FALSE(warm.loadTranspositionTable(path));
+}
+
+TEST(ComputerPlayer, Tablebase)
+{
+    Rules       rules(Rules::Variation::NORMAL);
+    std::string path = testing::TempDir() + "test-ComputerPlayer-Tablebase.nimtb";
+    ASSERT_TRUE(Tablebase::generate(path, rules, 3, 5));
+    std::shared_ptr<Tablebase const> tablebase = Tablebase::open(path);
+    ASSERT_NE(tablebase, nullptr);
+
+    for (auto engine : {ComputerPlayer::Engine::SEARCH, ComputerPlayer::Engine::IN_PLACE})
+    {
+        ComputerPlayer computer(NimState::PlayerId::FIRST, rules, engine);
+        computer.setTablebase(tablebase);
+
+        // A covered winning position is played from the tablebase without searching
+        NimState state(Board({3, 4, 5}), rules);
+        computer.move(&state);
+        EXPECT_TRUE(computer.statistics().tablebase);
+        EXPECT_EQ(computer.nodesSearched(), 0u);
+        EXPECT_EQ(state.nimSum(), 0);
+
+        // A position that is not covered is searched
+        NimState uncovered(Board({1, 2, 3, 4}), rules);
+        computer.move(&uncovered);
+        EXPECT_FALSE(computer.statistics().tablebase);
+        EXPECT_GT(computer.nodesSearched(), 0u);
+    }
+
+    // A tablebase for a different variation is ignored
+    {
+        ComputerPlayer computer(NimState::PlayerId::FIRST, Rules(Rules::Variation::MISERE), ComputerPlayer::Engine::IN_PLACE);
+        computer.setTablebase(tablebase);
+        NimState state(Board({3, 4, 5}), Rules(Rules::Variation::MISERE));
+        computer.move(&state);
+        EXPECT_FALSE(computer.statistics().tablebase);
+    }
+    std::remove(path.c_str());
+}
+
 } // namespace Nim
@@ -0,0 +1,149 @@
+#include "gtest/gtest.h"
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "ComputerPlayer/MoveOrderer.h"
+#include "NimState/MoveGenerator.h"
+#include "NimState/NimState.h"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Returns all the moves returned by a move orderer
+static std::vector<std::pair<int, int>> allMoves(MoveOrderer & orderer)
+{
+    std::vector<std::pair<int, int>> moves;
+    while (std::optional<NimState::Move> move = orderer.next())
+    {
+        moves.emplace_back(move->i, move->n);
+    }
+    return moves;
+}
+
+// Returns all the moves generated for a board
+static std::vector<std::pair<int, int>> generatedMoves(Board const & board, Rules const & rules)
+{
+    std::vector<std::pair<int, int>> moves;
+    MoveGenerator                    generator(board, rules);
+    while (std::optional<NimState::Move> move = generator.next())
+    {
+        moves.emplace_back(move->i, move->n);
+    }
+    return moves;
+}
+
+namespace Nim
+{
+
+TEST(MoveOrderer, Constructor)
+{
+    // Nothing to test here, just make sure the constructor executes without error
+    Rules rules;
+    Board board({1, 2, 3});
+    ASSERT_NO_THROW(MoveOrderer(board, rules));
+}
+
+TEST(MoveOrderer, Next)
+{
+    // Every generated move is returned exactly once, whatever the hints
+    Rules                rules(Rules::Variation::NORMAL);
+    MoveOrderer::Killers killers{MoveOrderer::Hint{5, 2}, MoveOrderer::Hint{9, 9}};
+    for (Board const & board : {Board({1, 3, 5, 7, 9}), Board({0, 2, 2, 1, 0, 1, 2}), Board({4, 4}), Board({0, 0})})
+    {
+        auto        expected = generatedMoves(board, rules);
+        MoveOrderer orderer(board, rules, MoveOrderer::Hint{3, 1}, &killers);
+        auto        actual = allMoves(orderer);
+        EXPECT_EQ(actual.size(), expected.size());
+        std::sort(expected.begin(), expected.end());
+        std::sort(actual.begin(), actual.end());
+        EXPECT_EQ(actual, expected);
+    }
+
+    // Without hints or killers, the moves are returned in the order generated
+    Board       board({1, 3, 5, 7, 9});
+    MoveOrderer orderer(board, rules);
+    EXPECT_EQ(allMoves(orderer), generatedMoves(board, rules));
+
+    // If the heaps have removal limits of their own, only a heap with the same size and limit as an earlier one is skipped
+    Rules       limits(Rules::Variation::SUBTRACT, std::vector<int>{1, 2, 1, 2});
+    Board       limited({2, 2, 2, 3});
+    MoveOrderer limitedOrderer(limited, limits);
+    auto        expected = generatedMoves(limited, limits);
+    auto        actual   = allMoves(limitedOrderer);
+    EXPECT_EQ(actual.size(), expected.size());
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(MoveOrderer, Next_Order)
+{
+    Rules                rules(Rules::Variation::NORMAL);
+    Board                board({3, 4, 5, 5}); // nim-sum is 7
+    MoveOrderer::Killers killers{MoveOrderer::Hint{5, 5}, MoveOrderer::Hint{7, 1}};
+
+    // The best move comes first, then the winning replies (leaving 3 on the heap of 4 or 2 on a heap of 5), then the killer
+    // moves that are legal
+    MoveOrderer orderer(board, rules, MoveOrderer::Hint{5, 2}, &killers);
+    auto        moves = allMoves(orderer);
+    ASSERT_GE(moves.size(), 4u);
+    EXPECT_EQ(moves[0], std::make_pair(2, 2));
+    EXPECT_EQ(moves[1], std::make_pair(1, 1));
+    EXPECT_EQ(moves[2], std::make_pair(2, 3));
+    EXPECT_EQ(moves[3], std::make_pair(2, 5));
+
+    // Hints refer to heaps by size, so they apply to any heap of that size
+    Board       permuted({5, 4, 3});
+    MoveOrderer permutedOrderer(permuted, rules, MoveOrderer::Hint{3, 2});
+    EXPECT_EQ(permutedOrderer.next()->i, 2);
+}
+
+TEST(MoveOrderer, Next_Subtract)
+{
+    // In the subtraction variation, the winning reply leaves a multiple of (k + 1) objects
+    Rules                         rules(Rules::Variation::SUBTRACT, 4);
+    Board                         board({23});
+    MoveOrderer::Killers          killers{};
+    MoveOrderer                   orderer(board, rules, MoveOrderer::Hint(), &killers);
+    std::optional<NimState::Move> move = orderer.next();
+    ASSERT_TRUE(move.has_value());
+    EXPECT_EQ(move->i, 0);
+    EXPECT_EQ(move->n, 3);
+}
+
+TEST(MoveOrderer, Next_SubtractionSet)
+{
+    // With {1, 3, 4}, the Grundy value of 12 is 3, and the only winning reply leaves 9, whose Grundy value is 0
+    Rules                         rules(std::vector<int>{1, 3, 4});
+    Board                         board({12});
+    MoveOrderer::Killers          killers{};
+    MoveOrderer                   orderer(board, rules, MoveOrderer::Hint(), &killers);
+    std::optional<NimState::Move> move = orderer.next();
+    ASSERT_TRUE(move.has_value());
+    EXPECT_EQ(move->i, 0);
+    EXPECT_EQ(move->n, 3);
+
+    // The remaining moves are the other moves in the set
+    std::vector<int> rest;
+    while ((move = orderer.next()))
+    {
+        rest.push_back(move->n);
+    }
+    EXPECT_EQ(rest, (std::vector<int>{1, 4}));
+}
+
+TEST(MoveOrderer, AddKiller)
+{
+    MoveOrderer::Killers killers{};
+    MoveOrderer::addKiller(killers, MoveOrderer::Hint{5, 2});
+    MoveOrderer::addKiller(killers, MoveOrderer::Hint{7, 1});
+    MoveOrderer::addKiller(killers, MoveOrderer::Hint{7, 1}); // The same move is not added twice
+    EXPECT_EQ(killers[0].heap, 7);
+    EXPECT_EQ(killers[0].n, 1);
+    EXPECT_EQ(killers[1].heap, 5);
+    EXPECT_EQ(killers[1].n, 2);
+}
+
+} // namespace Nim
@@ -24,4 +24,95 @@ TEST(NimEvaluator, Evaluate)
     ASSERT_NO_THROW(evaluator.evaluate(state));
 }
 
+TEST(NimEvaluator, Evaluate_Subtract)
+{
+    // The Grundy values are exact, so a state is a win or a loss for the player who made the last move
+    Rules        rules(Rules::Variation::SUBTRACT, 4);
+    NimEvaluator evaluator(rules);
+    NimState     state(Board({22}), rules);
+
+    state.move(0, 2); // The first player leaves 20 objects, which is a win for the first player
+    EXPECT_EQ(evaluator.evaluate(state), evaluator.firstPlayerWinsValue());
+    state.move(0, 1); // The second player leaves 19 objects, which is a loss for the second player
+    EXPECT_EQ(evaluator.evaluate(state), evaluator.firstPlayerWinsValue());
+    state.move(0, 4); // The first player leaves 15 objects, which is a win for the first player
+    EXPECT_EQ(evaluator.evaluate(state), evaluator.firstPlayerWinsValue());
+}
+
+TEST(NimEvaluator, Evaluate_SubtractionSet)
+{
+    // The Grundy values of {2, 5, 7} are used, and the game ends when no heap has 2 objects
+    Rules        rules(std::vector<int>{2, 5, 7});
+    NimEvaluator evaluator(rules);
+    NimState     state(Board({9, 1}), rules);
+
+    state.move(0, 5); // The first player leaves 4 and 1, whose Grundy values are 0 and 0, which is a win for the first player
+    EXPECT_EQ(evaluator.evaluate(state), evaluator.firstPlayerWinsValue());
+    state.move(0, 2); // The second player leaves 2 and 1, which is a loss for the second player
+    EXPECT_EQ(evaluator.evaluate(state), evaluator.firstPlayerWinsValue());
+    state.move(0, 2); // The first player takes the last move
+    ASSERT_TRUE(state.isGameOver());
+    EXPECT_EQ(evaluator.evaluate(state), evaluator.firstPlayerWinsValue());
+}
+
+TEST(NimEvaluator, Evaluate_HeapLimits)
+{
+    // Each heap's Grundy value is its size mod (its limit + 1)
+    Rules        rules(Rules::Variation::SUBTRACT, std::vector<int>{2, 4});
+    NimEvaluator evaluator(rules);
+    NimState     state(Board({7, 8}), rules);
+
+    state.move(0, 1); // The first player leaves 6 and 8, whose Grundy values are 0 and 3, which is a loss for the first player
+    EXPECT_EQ(evaluator.evaluate(state), evaluator.secondPlayerWinsValue());
+    state.move(1, 3); // The second player leaves 6 and 5, whose Grundy values are both 0, which is a loss for the first player
+    EXPECT_EQ(evaluator.evaluate(state), evaluator.secondPlayerWinsValue());
+}
+
+TEST(NimEvaluator, Evaluate_Octal)
+{
+    // In Kayles (0.77), the Grundy values of heaps of 2, 4 and 9 are 2, 1 and 4
+    Rules        rules(Rules::Variation::OCTAL, "0.77");
+    NimEvaluator evaluator(rules);
+    NimState     state(Board({9}), rules);
+
+    state.move(0, 1, 4); // The first player leaves two heaps of 4, whose Grundy values cancel, which is a win for the first player
+    EXPECT_EQ(evaluator.evaluate(state), evaluator.firstPlayerWinsValue());
+    state.move(0, 2); // The second player leaves 2 and 4, whose Grundy values are 2 and 1, which is a win for the first player
+    EXPECT_EQ(evaluator.evaluate(state), evaluator.firstPlayerWinsValue());
+}
+
+TEST(NimEvaluator, Evaluate_Move)
+{
+    // The value of a state doesn't depend on the move that led to it
+    Rules        rules(Rules::Variation::NORMAL);
+    NimEvaluator evaluator(rules);
+    NimState     state1(Board({1, 2, 3}), rules);
+    NimState     state2(Board({1, 2, 3}), rules);
+    state1.move(1, 1); // 1 1 3
+    state1.move(2, 3); // 1 1 0
+    state2.move(2, 3); // 1 2 0
+    state2.move(1, 1); // 1 1 0
+    EXPECT_EQ(evaluator.evaluate(state1), evaluator.evaluate(state2));
+}
+
+TEST(NimEvaluator, Evaluate_Static)
+{
+    // The evaluation bound to a variation at compile time matches the one chosen at run time
+    Rules        misere(Rules::Variation::MISERE);
+    Rules        normal(Rules::Variation::NORMAL);
+    Rules        subtract(Rules::Variation::SUBTRACT, 3);
+    NimEvaluator misereEvaluator(misere);
+    NimEvaluator normalEvaluator(normal);
+    NimEvaluator subtractEvaluator(subtract);
+    NimState     misereState(Board({1, 2, 3}), misere);
+    NimState     normalState(Board({1, 2, 3}), normal);
+    NimState     subtractState(Board({7, 5}), subtract);
+    misereState.move(2, 2);   // 1 2 1
+    normalState.move(2, 2);   // 1 2 1
+    subtractState.move(0, 3); // 4 5
+    EXPECT_EQ(misereEvaluator.evaluate<Rules::Variation::MISERE>(misereState), misereEvaluator.evaluate(misereState));
+    EXPECT_EQ(normalEvaluator.evaluate<Rules::Variation::NORMAL>(normalState), normalEvaluator.evaluate(normalState));
+    EXPECT_EQ(subtractEvaluator.evaluate<Rules::Variation::SUBTRACT>(subtractState), subtractEvaluator.evaluate(subtractState));
+}
+
 } // namespace Nim
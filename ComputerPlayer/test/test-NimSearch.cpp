@@ -0,0 +1,325 @@
+#include "gtest/gtest.h"
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "ComputerPlayer/NimSearch.h"
+#include "ComputerPlayer/NimSolver.h"
+#include "ComputerPlayer/SharedTranspositionTable.h"
+#include "NimState/NimState.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Number of allocations from the heap
+static int allocations = 0;
+
+void * operator new(size_t size)
+{
+    ++allocations;
+    void * p = std::malloc(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void * p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace Nim
+{
+
+TEST(NimSearch, Constructor)
+{
+    // Nothing to test here, just make sure the constructor executes without error
+    Rules rules;
+    ASSERT_NO_THROW(NimSearch(rules, NimSearch::Settings{10, 1, 1}));
+    ASSERT_NO_THROW(NimSearch(rules, NimSearch::Settings{10, 1, 4}));
+}
+
+TEST(NimSearch, FindBestMove)
+{
+    // With a deep enough search, the best move in a winning position is a winning move
+    Rules     rules(Rules::Variation::NORMAL);
+    NimSearch search(rules, NimSearch::Settings{20, 2, 1});
+    for (NimState::PlayerId player : {NimState::PlayerId::FIRST, NimState::PlayerId::SECOND})
+    {
+        NimState       state(Board({3, 4, 5}), rules, player);
+        NimState::Move move = search.findBestMove(state);
+        state.move(move.i, move.n);
+        EXPECT_EQ(state.board().nimSum(), 0);
+    }
+}
+
+TEST(NimSearch, FindBestMove_Misere)
+{
+    // In the misre variation, the winning move leaves an odd number of heaps of 1
+    Rules          rules(Rules::Variation::MISERE);
+    NimSearch      search(rules, NimSearch::Settings{10, 2, 1});
+    NimState       state(Board({1, 1, 6}), rules);
+    NimState::Move move = search.findBestMove(state);
+    EXPECT_EQ(move.i, 2);
+    EXPECT_EQ(move.n, 5);
+}
+
+TEST(NimSearch, FindBestMove_SubtractionSet)
+{
+    // The search only makes moves in the subtraction set, and with the Grundy values, it finds the winning move at any depth
+    Rules     rules(std::vector<int>{2, 5, 7});
+    NimSearch search(rules, NimSearch::Settings{4, 2, 1});
+    NimSolver solver(rules);
+    for (Board const & board : {Board({40}), Board({9, 1}), Board({20, 13, 6})})
+    {
+        NimState       state(board, rules);
+        NimState::Move move = search.findBestMove(state);
+        EXPECT_TRUE(rules.allows(move.n));
+        Board response = board;
+        response.remove(move.i, move.n);
+        EXPECT_EQ(solver.winningMove(board).has_value(), !solver.winningMove(response).has_value());
+    }
+}
+
+TEST(NimSearch, FindBestMove_Allocations)
+{
+    // The search walks the tree in place, so it doesn't allocate anything
+    Rules     rules(Rules::Variation::NORMAL);
+    NimSearch search(rules, NimSearch::Settings{10, 2, 1});
+    NimState  state(Board({1, 3, 5, 7, 9}), rules);
+    allocations = 0;
+    search.findBestMove(state);
+    EXPECT_EQ(allocations, 0);
+}
+
+TEST(NimSearch, FindBestMove_Threads)
+{
+    // The result of a parallel search is the same as the result of a search on a single thread
+    for (auto variation : {Rules::Variation::NORMAL, Rules::Variation::MISERE})
+    {
+        Rules rules(variation);
+        for (Board const & board : {Board({3, 4, 5}), Board({1, 2, 4, 6}), Board({2, 2, 5, 5}), Board({1, 1, 1, 7})})
+        {
+            for (NimState::PlayerId player : {NimState::PlayerId::FIRST, NimState::PlayerId::SECOND})
+            {
+                NimState       state(board, rules, player);
+                NimSearch      search1(rules, NimSearch::Settings{20, 2, 1});
+                NimState::Move move1 = search1.findBestMove(state);
+                for (int threads : {2, 3, 8})
+                {
+                    NimSearch      searchN(rules, NimSearch::Settings{20, 2, threads});
+                    NimState::Move moveN = searchN.findBestMove(state);
+                    EXPECT_EQ(moveN.i, move1.i);
+                    EXPECT_EQ(moveN.n, move1.n);
+                    EXPECT_GT(searchN.nodesSearched(), 0);
+                }
+            }
+        }
+    }
+}
+
+TEST(NimSearch, FindBestMove_SharedTable)
+{
+    // Searches sharing a table find the same moves as searches with their own tables
+    for (auto variation : {Rules::Variation::NORMAL, Rules::Variation::MISERE})
+    {
+        Rules               rules(variation);
+        NimSearch::Settings shared{20, 2, 1};
+        shared.sharedTable = std::make_shared<SharedTranspositionTable>(1024 * 1024);
+        for (Board const & board : {Board({3, 4, 5}), Board({1, 2, 4, 6}), Board({2, 2, 5, 5}), Board({1, 1, 1, 7})})
+        {
+            NimState       state(board, rules);
+            NimSearch      own(rules, NimSearch::Settings{20, 2, 1});
+            NimState::Move expected = own.findBestMove(state);
+            for (int threads : {1, 3})
+            {
+                shared.threads = threads;
+                NimSearch      search(rules, shared);
+                NimState::Move move = search.findBestMove(state);
+                EXPECT_EQ(move.i, expected.i);
+                EXPECT_EQ(move.n, expected.n);
+            }
+        }
+    }
+
+    // A search finds what another search stored in the shared table
+    Rules               rules(Rules::Variation::MISERE);
+    NimState            state(Board({1, 3, 5, 7}), rules);
+    NimSearch::Settings settings{10, 2, 1};
+    settings.sharedTable = std::make_shared<SharedTranspositionTable>(1024 * 1024);
+    NimSearch first(rules, settings);
+    NimSearch second(rules, settings);
+    first.findBestMove(state);
+    second.findBestMove(state);
+    EXPECT_LT(second.nodesSearched(), first.nodesSearched());
+    EXPECT_FALSE(second.statistics().principalVariation.empty());
+
+    // Clearing a search doesn't clear the shared table
+    second.clearTranspositionTable();
+    second.findBestMove(state);
+    EXPECT_LT(second.nodesSearched(), first.nodesSearched());
+}
+
+TEST(NimSearch, FindBestMove_Depth)
+{
+    // Without a budget, the search deepens until the maximum depth or the end of the game, whichever comes first
+    Rules    rules(Rules::Variation::NORMAL);
+    NimState state(Board({1, 3, 5, 7, 9}), rules);
+    {
+        NimSearch search(rules, NimSearch::Settings{6, 2, 1});
+        search.findBestMove(state);
+        EXPECT_EQ(search.depthSearched(), 6);
+    }
+    {
+        NimSearch search(rules, NimSearch::Settings{40, 2, 1});
+        search.findBestMove(state);
+        EXPECT_EQ(search.depthSearched(), 25);
+    }
+}
+
+TEST(NimSearch, FindBestMove_NodeLimit)
+{
+    // The search stops when the node budget runs out and returns the best move of the last completed iteration
+    Rules               rules(Rules::Variation::NORMAL);
+    NimState            state(Board({11, 12, 13, 14, 15, 16, 17, 18}), rules);
+    NimSearch::Settings settings{20, 2, 1};
+    settings.nodeLimit = 10000;
+    NimSearch      search(rules, settings);
+    NimState::Move move = search.findBestMove(state);
+    EXPECT_GE(search.depthSearched(), 1);
+    EXPECT_LT(search.depthSearched(), 20);
+    EXPECT_LT(search.nodesSearched(), 2 * settings.nodeLimit);
+    ASSERT_GE(move.i, 0);
+    ASSERT_LT(move.i, 8);
+    EXPECT_GE(move.n, 1);
+    EXPECT_LE(move.n, state.board().heap(move.i));
+
+    // The same budget gives the same result
+    NimSearch      again(rules, settings);
+    NimState::Move move2 = again.findBestMove(state);
+    EXPECT_EQ(move2.i, move.i);
+    EXPECT_EQ(move2.n, move.n);
+    EXPECT_EQ(again.depthSearched(), search.depthSearched());
+}
+
+TEST(NimSearch, FindBestMove_TimeLimit)
+{
+    // The search stops soon after the time budget runs out
+    Rules    rules(Rules::Variation::MISERE);
+    NimState state(Board({11, 12, 13, 14, 15, 16, 17, 18}), rules);
+    for (int threads : {1, 4})
+    {
+        NimSearch::Settings settings{20, 2, threads};
+        settings.timeLimit = std::chrono::milliseconds(50);
+        NimSearch search(rules, settings);
+        auto      start = std::chrono::steady_clock::now();
+        search.findBestMove(state);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        EXPECT_LT(elapsed, std::chrono::seconds(1));
+        EXPECT_GE(search.depthSearched(), 1);
+        EXPECT_LT(search.depthSearched(), 20);
+    }
+}
+
+TEST(NimSearch, Statistics)
+{
+    Rules          rules(Rules::Variation::MISERE);
+    NimSearch      search(rules, NimSearch::Settings{8, 2, 1});
+    NimState       state(Board({1, 3, 5, 7, 9}), rules);
+    NimState::Move move = search.findBestMove(state);
+
+    SearchStatistics const & stats = search.statistics();
+    EXPECT_EQ(stats.nodes, search.nodesSearched());
+    EXPECT_GE(stats.probes, stats.hits);
+    EXPECT_GT(stats.stores, 0u);
+    EXPECT_GT(stats.evaluations, 0u);
+    EXPECT_GT(stats.branchingFactor, 0.0);
+
+    // There is one iteration for each depth, and together they account for every node
+    ASSERT_EQ(static_cast<int>(stats.iterations.size()), 8);
+    uint64_t nodes = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(stats.iterations[i].depth, i + 1);
+        EXPECT_TRUE(stats.iterations[i].completed);
+        nodes += stats.iterations[i].nodes;
+    }
+    EXPECT_EQ(nodes, stats.nodes);
+
+    // The principal variation starts with the best move and is a sequence of legal moves
+    ASSERT_FALSE(stats.principalVariation.empty());
+    EXPECT_LE(static_cast<int>(stats.principalVariation.size()), 8);
+    EXPECT_EQ(stats.principalVariation.front().i, move.i);
+    EXPECT_EQ(stats.principalVariation.front().n, move.n);
+    for (auto const & m : stats.principalVariation)
+    {
+        ASSERT_FALSE(state.isGameOver());
+        ASSERT_LE(m.n, state.board().heap(m.i));
+        state.move(m.i, m.n);
+    }
+}
+
+TEST(NimSearch, Snapshot)
+{
+    Rules          rules(Rules::Variation::MISERE);
+    NimState       state(Board({1, 3, 5, 7, 9}), rules);
+    NimSearch      cold(rules, NimSearch::Settings{8, 2, 1});
+    NimState::Move expected  = cold.findBestMove(state);
+    uint64_t       coldNodes = cold.nodesSearched();
+
+    std::stringstream snapshot;
+    ASSERT_TRUE(cold.saveTranspositionTable(snapshot));
+
+    // A search that starts with the snapshot finds the same move with less work
+    {
+        NimSearch          warm(rules, NimSearch::Settings{8, 2, 2});
+        std::istringstream in(snapshot.str());
+        ASSERT_TRUE(warm.loadTranspositionTable(in));
+        NimState::Move move = warm.findBestMove(state);
+        EXPECT_EQ(move.i, expected.i);
+        EXPECT_EQ(move.n, expected.n);
+        EXPECT_LT(warm.nodesSearched(), coldNodes);
+    }
+
+    // A snapshot of a different variation is rejected
+    {
+        Rules              normal(Rules::Variation::NORMAL);
+        NimSearch          other(normal, NimSearch::Settings{8, 2, 1});
+        std::istringstream in(snapshot.str());
+        EXPECT_FALSE(other.loadTranspositionTable(in));
+    }
+
+    // A damaged snapshot is rejected and leaves the table unchanged
+    {
+        std::string              data    = snapshot.str();
+        std::vector<std::string> damaged = {
+            data.substr(0, 20),              // Truncated header
+            data.substr(0, data.size() - 1), // Truncated record
+            "NOTASNAP" + data.substr(8),     // Wrong magic
+        };
+        damaged.push_back(data);
+        damaged.back()[8] = 99; // Wrong version
+        damaged.push_back(data);
+        std::swap(damaged.back()[10], damaged.back()[11]); // Saved with the other byte order
+        for (auto const & d : damaged)
+        {
+            NimSearch          search(rules, NimSearch::Settings{8, 2, 1});
+            std::istringstream in(d);
+            EXPECT_FALSE(search.loadTranspositionTable(in));
+            search.findBestMove(state);
+            EXPECT_EQ(search.nodesSearched(), coldNodes);
+        }
+    }
+}
+
+} // namespace Nim
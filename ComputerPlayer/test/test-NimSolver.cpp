@@ -0,0 +1,232 @@
+#include "gtest/gtest.h"
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "ComputerPlayer/NimSolver.h"
+#include "NimState/MoveGenerator.h"
+#include "NimState/NimState.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+// Returns true if the player to move can force a win, determined by exhaustive search.
+static bool isWin(Board const & board, Rules const & rules)
+{
+    if (board.empty())
+    {
+        // The player to move did not take the last object
+        return rules.variation() == Rules::Variation::MISERE;
+    }
+    for (int i = 0; i < static_cast<int>(board.size()); ++i)
+    {
+        int max = std::min(board.heap(i), rules.removalLimit(i));
+        for (int n = 1; n <= max; ++n)
+        {
+            if (!rules.allows(i, n))
+                continue;
+            Board response = board;
+            response.remove(i, n);
+            if (!isWin(response, rules))
+                return true;
+        }
+    }
+    return false;
+}
+
+// Checks the solver against exhaustive search for every board with heaps up to the given sizes.
+static void checkAllBoards(Rules const & rules, std::vector<int8_t> const & limits)
+{
+    NimSolver           solver(rules);
+    std::vector<int8_t> heaps(limits.size(), 0);
+    while (true)
+    {
+        Board board(heaps);
+        if (!board.empty())
+        {
+            auto move = solver.winningMove(board);
+            EXPECT_EQ(move.has_value(), isWin(board, rules));
+            if (move.has_value())
+            {
+                Board response = board;
+                response.remove(move->i, move->n);
+                EXPECT_FALSE(isWin(response, rules)); // The winning move must leave the opponent in a losing position
+            }
+        }
+
+        // Next board
+        size_t k = 0;
+        while (k < heaps.size() && heaps[k] == limits[k])
+        {
+            heaps[k] = 0;
+            ++k;
+        }
+        if (k == heaps.size())
+            break;
+        ++heaps[k];
+    }
+}
+
+// Returns true if the player to move in an octal game can force a win, determined by exhaustive search. The results are
+// remembered for each set of heap sizes.
+static bool isOctalWin(NimState & state, Rules const & rules, std::map<std::vector<int8_t>, bool> & known)
+{
+    std::vector<int8_t> heaps = state.board().heaps();
+    std::sort(heaps.begin(), heaps.end());
+    auto found = known.find(heaps);
+    if (found != known.end())
+        return found->second;
+
+    bool          win = false;
+    MoveGenerator moves(state.board(), rules);
+    while (std::optional<NimState::Move> move = moves.next())
+    {
+        NimState::Undo undo = state.move(move->i, move->n, move->split);
+        win                 = !isOctalWin(state, rules, known);
+        state.undo(undo);
+        if (win)
+            break;
+    }
+    known[heaps] = win;
+    return win;
+}
+
+// Checks the solver against exhaustive search for every board reached from the given board in an octal game.
+static void checkOctalBoards(Rules const & rules, Board const & board)
+{
+    NimSolver                           solver(rules);
+    std::map<std::vector<int8_t>, bool> known;
+    NimState                            start(board, rules);
+    isOctalWin(start, rules, known);
+    for (auto const & [heaps, win] : known)
+    {
+        Board                         position(heaps);
+        std::optional<NimState::Move> move = solver.winningMove(position);
+        EXPECT_EQ(move.has_value(), win);
+        if (move.has_value())
+        {
+            // The winning move must be legal and leave the opponent in a losing position
+            EXPECT_TRUE(rules.octalGame()->isLegal(position.heap(move->i), move->n, move->split));
+            NimState response(position, rules);
+            response.move(move->i, move->n, move->split);
+            EXPECT_FALSE(isOctalWin(response, rules, known));
+        }
+    }
+}
+
+namespace Nim
+{
+
+TEST(NimSolver, Constructor)
+{
+    // Nothing to test here, just make sure the constructor executes without error
+    Rules rules;
+    ASSERT_NO_THROW(NimSolver{rules});
+}
+
+TEST(NimSolver, WinningMove_Normal)
+{
+    checkAllBoards(Rules(Rules::Variation::NORMAL), {3, 4, 5, 2});
+}
+
+TEST(NimSolver, WinningMove_Misere)
+{
+    checkAllBoards(Rules(Rules::Variation::MISERE), {3, 4, 5, 2});
+    checkAllBoards(Rules(Rules::Variation::MISERE), {1, 1, 1, 1, 6});
+}
+
+TEST(NimSolver, WinningMove_Subtract)
+{
+    checkAllBoards(Rules(Rules::Variation::SUBTRACT, 1), {20});
+    checkAllBoards(Rules(Rules::Variation::SUBTRACT, 4), {30});
+    checkAllBoards(Rules(Rules::Variation::SUBTRACT, 3), {5, 6, 4});
+}
+
+TEST(NimSolver, WinningMove_HeapLimits)
+{
+    checkAllBoards(Rules(Rules::Variation::SUBTRACT, std::vector<int>{2, 3, 1}), {5, 6, 4});
+    checkAllBoards(Rules(Rules::Variation::SUBTRACT, std::vector<int>{4, 4, 2}), {5, 5, 5});
+}
+
+TEST(NimSolver, WinningMove_SubtractionSet)
+{
+    checkAllBoards(Rules(std::vector<int>{1, 3, 4}), {30});
+    checkAllBoards(Rules(std::vector<int>{2, 5, 7}), {30});
+    checkAllBoards(Rules(std::vector<int>{2, 5, 7}), {10, 12});
+}
+
+TEST(NimSolver, WinningMove_Octal)
+{
+    checkOctalBoards(Rules(Rules::Variation::OCTAL, "0.77"), Board({14}));
+    checkOctalBoards(Rules(Rules::Variation::OCTAL, "0.77"), Board({7, 6, 3}));
+    checkOctalBoards(Rules(Rules::Variation::OCTAL, "0.137"), Board({16}));
+    checkOctalBoards(Rules(Rules::Variation::OCTAL, "0.4"), Board({9, 8}));
+    checkOctalBoards(Rules(Rules::Variation::OCTAL, "0.6"), Board({15}));
+}
+
+TEST(NimSolver, WinningMove_GameOver)
+{
+    NimSolver solver(Rules(Rules::Variation::NORMAL));
+    EXPECT_FALSE(solver.winningMove(Board({0, 0, 0})).has_value()); // There are no moves if the game is over
+}
+
+TEST(NimSolver, BestMove)
+{
+    // In a losing position of a subtraction game, the best move removes the smallest number in the set
+    {
+        NimSolver solver(Rules(std::vector<int>{2, 5, 7}));
+        Board     board({1, 4});
+        ASSERT_FALSE(solver.winningMove(board).has_value());
+        NimState::Move move = solver.bestMove(board);
+        EXPECT_EQ(move.i, 1);
+        EXPECT_EQ(move.n, 2);
+    }
+
+    // In a losing position of an octal game, the best move must still be legal, even if it has to split a heap
+    {
+        Rules     rules(Rules::Variation::OCTAL, "0.04");
+        NimSolver solver(rules);
+        Board     board({2, 9});
+        ASSERT_FALSE(solver.winningMove(board).has_value());
+        NimState::Move move = solver.bestMove(board);
+        EXPECT_EQ(move.i, 1);
+        EXPECT_TRUE(rules.octalGame()->isLegal(9, move.n, move.split));
+    }
+
+    // In a losing position, the best move must still be legal
+    NimSolver solver(Rules(Rules::Variation::NORMAL));
+    Board     board({0, 5, 0, 5});
+    ASSERT_FALSE(solver.winningMove(board).has_value());
+    for (int k = 0; k < 100; ++k)
+    {
+        NimState::Move move = solver.bestMove(board);
+        EXPECT_TRUE(move.i == 1 || move.i == 3);
+        EXPECT_TRUE(1 <= move.n && move.n <= board.heap(move.i));
+    }
+
+    // In a winning position, the best move is the winning move
+    Board winning({1, 2, 4});
+    auto  move = solver.bestMove(winning);
+    EXPECT_EQ(move.i, 2);
+    EXPECT_EQ(move.n, 1);
+}
+
+TEST(NimSolver, BestMove_Seed)
+{
+    // Solvers with the same seed choose the same moves in losing positions, and different seeds choose differently
+    NimSolver a(Rules(Rules::Variation::NORMAL), 12345);
+    NimSolver b(Rules(Rules::Variation::NORMAL), 12345);
+    NimSolver c(Rules(Rules::Variation::NORMAL), 54321);
+    Board     board({3, 3, 5, 5, 7, 7});
+    ASSERT_FALSE(a.winningMove(board).has_value());
+    bool different = false;
+    for (int k = 0; k < 100; ++k)
+    {
+        NimState::Move move = a.bestMove(board);
+        EXPECT_EQ(b.bestMove(board).i, move.i);
+        different = different || c.bestMove(board).i != move.i;
+    }
+    EXPECT_TRUE(different);
+}
+
+} // namespace Nim
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+
+#include "ComputerPlayer/NimTranspositionTable.h"
+
+#include <cstdint>
+#include <utility>
+
+using Bound = NimTranspositionTable::Bound;
+
+TEST(NimTranspositionTable, Constructor)
+{
+    // The number of buckets is the largest power of 2 that fits
+    {
+        NimTranspositionTable table(1024 * 1024);
+        EXPECT_EQ(table.bytes(), 1024u * 1024u);
+        EXPECT_EQ(table.capacity(), 1024u * 1024u / sizeof(NimTranspositionTable::Entry));
+    }
+    {
+        NimTranspositionTable table(1000);
+        EXPECT_EQ(table.bytes(), 512u);
+    }
+
+    // There is always at least one bucket
+    {
+        NimTranspositionTable table(0);
+        EXPECT_EQ(table.capacity(), NimTranspositionTable::ENTRIES_PER_BUCKET);
+    }
+
+    // Huge pages are optional, so the table works either way
+    {
+        NimTranspositionTable table(4 * 1024 * 1024, true);
+        EXPECT_EQ(table.bytes(), 4u * 1024u * 1024u);
+        table.store(1, 0.5f, 3, Bound::EXACT, 5, 2);
+        EXPECT_NE(table.probe(1), nullptr);
+    }
+}
+
+TEST(NimTranspositionTable, Store)
+{
+    NimTranspositionTable table(64 * 1024);
+    EXPECT_EQ(table.probe(12345), nullptr);
+
+    EXPECT_FALSE(table.store(12345, 0.25f, 7, Bound::LOWER, 99, 42));
+    NimTranspositionTable::Entry const * entry = table.probe(12345);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->fingerprint, 12345u);
+    EXPECT_EQ(entry->value, 0.25f);
+    EXPECT_EQ(entry->depth, 7);
+    EXPECT_EQ(entry->bound(), Bound::LOWER);
+    EXPECT_EQ(entry->heap(), 99);
+    EXPECT_EQ(entry->n(), 42);
+
+    // Storing the same state again replaces its entry, even if it is shallower
+    EXPECT_FALSE(table.store(12345, -0.5f, 2, Bound::UPPER, 0, 0));
+    entry = table.probe(12345);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->value, -0.5f);
+    EXPECT_EQ(entry->depth, 2);
+    EXPECT_EQ(entry->bound(), Bound::UPPER);
+    EXPECT_EQ(entry->heap(), 0);
+}
+
+TEST(NimTranspositionTable, Replacement)
+{
+    // With a single bucket, every state competes for the same entries
+    NimTranspositionTable table(0);
+    int                   count = static_cast<int>(NimTranspositionTable::ENTRIES_PER_BUCKET);
+    for (int i = 0; i < count; ++i)
+    {
+        EXPECT_FALSE(table.store(100 + i, 0.0f, 10 + i, Bound::EXACT, 1, 1));
+    }
+
+    // The shallowest entry is replaced
+    EXPECT_TRUE(table.store(200, 0.0f, 20, Bound::EXACT, 1, 1));
+    EXPECT_EQ(table.probe(100), nullptr);
+    for (int i = 1; i < count; ++i)
+    {
+        EXPECT_NE(table.probe(100 + i), nullptr);
+    }
+    EXPECT_NE(table.probe(200), nullptr);
+
+    // Entries from earlier generations are replaced before shallower entries from the current one, unless they are much deeper
+    table.age();
+    table.age();
+    table.store(300, 0.0f, 1, Bound::EXACT, 1, 1);
+    table.store(301, 0.0f, 1, Bound::EXACT, 1, 1);
+    EXPECT_NE(table.probe(300), nullptr);
+    EXPECT_NE(table.probe(301), nullptr);
+    EXPECT_NE(table.probe(200), nullptr); // The deepest of the earlier entries survives
+}
+
+TEST(NimTranspositionTable, Age)
+{
+    NimTranspositionTable table(64 * 1024);
+    table.store(1, 0.5f, 3, Bound::EXACT, 5, 2);
+
+    // Entries from earlier generations can still be found
+    table.age();
+    EXPECT_NE(table.probe(1), nullptr);
+
+    // When the generation counter wraps around, the table starts over
+    for (int i = 0; i < 255; ++i)
+    {
+        table.age();
+    }
+    EXPECT_EQ(table.probe(1), nullptr);
+    table.store(2, 0.5f, 3, Bound::EXACT, 5, 2);
+    EXPECT_NE(table.probe(2), nullptr);
+}
+
+TEST(NimTranspositionTable, Clear)
+{
+    NimTranspositionTable table(64 * 1024);
+    for (uint64_t i = 1; i <= 100; ++i)
+    {
+        table.store(i, 0.0f, 1, Bound::EXACT, 1, 1);
+    }
+    table.clear();
+    for (uint64_t i = 1; i <= 100; ++i)
+    {
+        EXPECT_EQ(table.probe(i), nullptr);
+    }
+
+    // Entries stored after a clear are kept, and replace the discarded ones without counting as replacements
+    EXPECT_FALSE(table.store(1, 0.0f, 1, Bound::EXACT, 1, 1));
+    EXPECT_NE(table.probe(1), nullptr);
+    table.age();
+    EXPECT_NE(table.probe(1), nullptr);
+
+    // Clearing many times doesn't bring back old entries
+    for (int i = 0; i < 600; ++i)
+    {
+        table.clear();
+        EXPECT_EQ(table.probe(1), nullptr);
+        table.store(1, 0.0f, 1, Bound::EXACT, 1, 1);
+        EXPECT_NE(table.probe(1), nullptr);
+    }
+}
+
+TEST(NimTranspositionTable, Move)
+{
+    NimTranspositionTable table(64 * 1024);
+    table.store(1, 0.5f, 3, Bound::EXACT, 5, 2);
+
+    NimTranspositionTable moved(std::move(table));
+    EXPECT_NE(moved.probe(1), nullptr);
+
+    NimTranspositionTable assigned(0);
+    assigned = std::move(moved);
+    EXPECT_NE(assigned.probe(1), nullptr);
+    EXPECT_EQ(assigned.bytes(), 64u * 1024u);
+}
@@ -0,0 +1,175 @@
+#include "gtest/gtest.h"
+
+#include "ComputerPlayer/SharedTranspositionTable.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using Bound = SharedTranspositionTable::Bound;
+
+TEST(SharedTranspositionTable, Constructor)
+{
+    // The number of buckets is the largest power of 2 that fits
+    {
+        SharedTranspositionTable table(1024 * 1024);
+        EXPECT_EQ(table.bytes(), 1024u * 1024u);
+        EXPECT_EQ(table.capacity(), 1024u * 1024u / 16u);
+    }
+    {
+        SharedTranspositionTable table(1000);
+        EXPECT_EQ(table.bytes(), 512u);
+    }
+
+    // There is always at least one bucket
+    {
+        SharedTranspositionTable table(0);
+        EXPECT_EQ(table.capacity(), SharedTranspositionTable::ENTRIES_PER_BUCKET);
+    }
+
+    // Huge pages are optional, so the table works either way
+    {
+        SharedTranspositionTable table(4 * 1024 * 1024, true);
+        EXPECT_EQ(table.bytes(), 4u * 1024u * 1024u);
+        table.store(1, 0.5f, 3, Bound::EXACT, 5, 2);
+        EXPECT_TRUE(table.probe(1).has_value());
+    }
+}
+
+TEST(SharedTranspositionTable, Store)
+{
+    SharedTranspositionTable table(64 * 1024);
+    EXPECT_FALSE(table.probe(12345).has_value());
+
+    EXPECT_FALSE(table.store(12345, 0.25f, 7, Bound::LOWER, 99, 42));
+    auto entry = table.probe(12345);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->fingerprint, 12345u);
+    EXPECT_EQ(entry->value, 0.25f);
+    EXPECT_EQ(entry->depth, 7);
+    EXPECT_EQ(entry->bound(), Bound::LOWER);
+    EXPECT_EQ(entry->heap(), 99);
+    EXPECT_EQ(entry->n(), 42);
+
+    // Storing the same state again replaces its entry, even if it is shallower
+    EXPECT_FALSE(table.store(12345, -0.5f, 2, Bound::UPPER, 0, 0));
+    entry = table.probe(12345);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->value, -0.5f);
+    EXPECT_EQ(entry->depth, 2);
+    EXPECT_EQ(entry->bound(), Bound::UPPER);
+    EXPECT_EQ(entry->heap(), 0);
+
+    // An entry whose packed data is all zeros is still found, and 0 is a valid fingerprint
+    table.store(0, 0.0f, 0, Bound::EXACT, 0, 0);
+    EXPECT_TRUE(table.probe(0).has_value());
+}
+
+TEST(SharedTranspositionTable, Replacement)
+{
+    // With a single bucket, every state competes for the same entries
+    SharedTranspositionTable table(0);
+    int                      count = static_cast<int>(SharedTranspositionTable::ENTRIES_PER_BUCKET);
+    for (int i = 0; i < count; ++i)
+    {
+        EXPECT_FALSE(table.store(100 + i, 0.0f, 10 + i, Bound::EXACT, 1, 1));
+    }
+
+    // The shallowest entry is replaced
+    EXPECT_TRUE(table.store(200, 0.0f, 20, Bound::EXACT, 1, 1));
+    EXPECT_FALSE(table.probe(100).has_value());
+    for (int i = 1; i < count; ++i)
+    {
+        EXPECT_TRUE(table.probe(100 + i).has_value());
+    }
+    EXPECT_TRUE(table.probe(200).has_value());
+
+    // Entries from earlier generations are replaced before shallower entries from the current one, unless they are much deeper
+    table.age();
+    table.age();
+    table.store(300, 0.0f, 1, Bound::EXACT, 1, 1);
+    table.store(301, 0.0f, 1, Bound::EXACT, 1, 1);
+    EXPECT_TRUE(table.probe(300).has_value());
+    EXPECT_TRUE(table.probe(301).has_value());
+    EXPECT_TRUE(table.probe(200).has_value()); // The deepest of the earlier entries survives
+}
+
+TEST(SharedTranspositionTable, Clear)
+{
+    SharedTranspositionTable table(64 * 1024);
+    for (uint64_t i = 1; i <= 100; ++i)
+    {
+        table.store(i, 0.0f, 1, Bound::EXACT, 1, 1);
+    }
+    int count = 0;
+    table.forEach([&count](SharedTranspositionTable::Entry const &) { ++count; });
+    EXPECT_EQ(count, 100);
+
+    table.clear();
+    for (uint64_t i = 1; i <= 100; ++i)
+    {
+        EXPECT_FALSE(table.probe(i).has_value());
+    }
+    count = 0;
+    table.forEach([&count](SharedTranspositionTable::Entry const &) { ++count; });
+    EXPECT_EQ(count, 0);
+
+    // Entries stored after a clear are kept, and replace the discarded ones without counting as replacements
+    EXPECT_FALSE(table.store(1, 0.0f, 1, Bound::EXACT, 1, 1));
+    EXPECT_TRUE(table.probe(1).has_value());
+}
+
+TEST(SharedTranspositionTable, Stress)
+{
+    // Many threads store and probe the same small table at once. Each state is always stored with the same contents, so an entry
+    // that a probe returns must have them, even if a store raced with it. Build with SANITIZE_THREADS to check the accesses too.
+    SharedTranspositionTable table(16 * 1024);
+    int const                threads    = 8;
+    int const                operations = 100000;
+    uint64_t const           states     = 4096;
+    std::atomic<int>         wrong(0);
+    std::atomic<int>         hits(0);
+
+    auto value = [](uint64_t fingerprint) { return static_cast<float>(fingerprint) * 0.5f; };
+    auto depth = [](uint64_t fingerprint) { return static_cast<int>(fingerprint % 100); };
+    auto heap  = [](uint64_t fingerprint) { return static_cast<int>(fingerprint % 127); };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(
+            [&, t]()
+            {
+                uint64_t random = 0x9e3779b97f4a7c15ull * (t + 1);
+                int      found  = 0;
+                for (int i = 0; i < operations; ++i)
+                {
+                    random ^= random << 13;
+                    random ^= random >> 7;
+                    random ^= random << 17;
+                    uint64_t fingerprint = (random % states) * 0x100000001b3ull; // Spread over the buckets and the high bits
+                    if (random & 0x100000)
+                    {
+                        table.store(fingerprint, value(fingerprint), depth(fingerprint), Bound::EXACT, heap(fingerprint), 1);
+                        continue;
+                    }
+                    auto entry = table.probe(fingerprint);
+                    if (!entry)
+                        continue;
+                    ++found;
+                    if (entry->value != value(fingerprint) || entry->depth != depth(fingerprint) ||
+                        entry->bound() != Bound::EXACT || entry->heap() != heap(fingerprint) || entry->n() != 1)
+                        ++wrong;
+                }
+                hits += found;
+            });
+    }
+    for (std::thread & worker : workers)
+    {
+        worker.join();
+    }
+
+    EXPECT_EQ(wrong, 0);
+    EXPECT_GT(hits, 0);
+}
@@ -0,0 +1,47 @@
+#include "gtest/gtest.h"
+
+#include "ComputerPlayer/TableMemory.h"
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+TEST(TableMemory, Constructor)
+{
+    // Ordinary memory is aligned to a cache line
+    {
+        TableMemory memory(1000, false);
+        ASSERT_NE(memory.data(), nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(memory.data()) % TableMemory::CACHE_LINE_SIZE, 0u);
+        EXPECT_EQ(memory.length(), 1024u);
+        EXPECT_FALSE(memory.hugePages());
+    }
+
+    // Memory for huge pages is a whole number of huge pages and starts on a huge page, whether or not the system has any
+    {
+        TableMemory memory(512 * 1024, true);
+        ASSERT_NE(memory.data(), nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(memory.data()) % TableMemory::HUGE_PAGE_SIZE, 0u);
+        EXPECT_EQ(memory.length(), TableMemory::HUGE_PAGE_SIZE);
+        std::memset(memory.data(), 0xff, memory.length());
+    }
+    {
+        TableMemory memory(3 * TableMemory::HUGE_PAGE_SIZE + 1, true);
+        EXPECT_EQ(memory.length(), 4 * TableMemory::HUGE_PAGE_SIZE);
+        std::memset(memory.data(), 0xff, memory.length());
+    }
+}
+
+TEST(TableMemory, Move)
+{
+    TableMemory a(4096, true);
+    void *      data = a.data();
+    TableMemory b(std::move(a));
+    EXPECT_EQ(b.data(), data);
+    EXPECT_EQ(a.data(), nullptr);
+
+    TableMemory c(64, false);
+    c = std::move(b);
+    EXPECT_EQ(c.data(), data);
+    EXPECT_EQ(c.length(), TableMemory::HUGE_PAGE_SIZE);
+}
@@ -0,0 +1,191 @@
+#include "gtest/gtest.h"
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "ComputerPlayer/NimSolver.h"
+#include "ComputerPlayer/Tablebase.h"
+#include "NimState/NimState.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Generates a tablebase in the test's temporary directory and returns its path.
+static std::string generateTablebase(Rules const & rules, int maxHeaps, int maxObjects)
+{
+    std::string path = testing::TempDir() + "test-Tablebase-" +
+                       testing::UnitTest::GetInstance()->current_test_info()->name() + ".nimtb";
+    EXPECT_TRUE(Tablebase::generate(path, rules, maxHeaps, maxObjects));
+    return path;
+}
+
+// Checks the tablebase against the solver for every board with heaps up to the given sizes.
+static void checkAllBoards(Tablebase const & tablebase, Rules const & rules, std::vector<int8_t> const & limits)
+{
+    NimSolver           solver(rules);
+    std::vector<int8_t> heaps(limits.size(), 0);
+    while (true)
+    {
+        Board board(heaps);
+        if (!board.empty())
+        {
+            auto result = tablebase.probe(board);
+            ASSERT_TRUE(result.has_value());
+            auto expected = solver.winningMove(board);
+            EXPECT_EQ(result->win, expected.has_value());
+            EXPECT_EQ(result->move.has_value(), expected.has_value());
+            if (result->move.has_value())
+            {
+                ASSERT_GE(result->move->n, 1);
+                ASSERT_LE(result->move->n, board.heap(result->move->i));
+                Board response = board;
+                response.remove(result->move->i, result->move->n);
+                if (!response.empty())
+                    EXPECT_FALSE(solver.winningMove(response).has_value()); // The move must leave the opponent losing
+                else
+                    EXPECT_EQ(rules.variation(), Rules::Variation::NORMAL); // Only a normal game is won by taking the last one
+            }
+        }
+
+        // Next board
+        size_t k = 0;
+        while (k < heaps.size() && heaps[k] == limits[k])
+        {
+            heaps[k] = 0;
+            ++k;
+        }
+        if (k == heaps.size())
+            break;
+        ++heaps[k];
+    }
+}
+
+TEST(Tablebase, Generate)
+{
+    {
+        Rules       rules(Rules::Variation::MISERE);
+        std::string path      = generateTablebase(rules, 5, 9);
+        auto        tablebase = Tablebase::open(path);
+        ASSERT_NE(tablebase, nullptr);
+        EXPECT_EQ(tablebase->variation(), Rules::Variation::MISERE);
+        EXPECT_EQ(tablebase->maxHeaps(), 5);
+        EXPECT_EQ(tablebase->maxObjects(), 9);
+        std::remove(path.c_str());
+    }
+
+    // The subtraction variation is not supported
+    {
+        std::string path = testing::TempDir() + "test-Tablebase-Subtract.nimtb";
+        EXPECT_FALSE(Tablebase::generate(path, Rules(Rules::Variation::SUBTRACT, 3), 1, 20));
+    }
+
+    // Limits out of range
+    {
+        std::string path = testing::TempDir() + "test-Tablebase-Limits.nimtb";
+        EXPECT_FALSE(Tablebase::generate(path, Rules(Rules::Variation::NORMAL), 0, 9));
+        EXPECT_FALSE(Tablebase::generate(path, Rules(Rules::Variation::NORMAL), 5, 0));
+        EXPECT_FALSE(Tablebase::generate(path, Rules(Rules::Variation::NORMAL), Board::MAX_HEAPS + 1, 9));
+        EXPECT_FALSE(Tablebase::generate(path, Rules(Rules::Variation::NORMAL), 5, Board::MAX_OBJECTS + 1));
+    }
+}
+
+TEST(Tablebase, Open)
+{
+    // Missing file
+    EXPECT_EQ(Tablebase::open(testing::TempDir() + "test-Tablebase-Missing.nimtb"), nullptr);
+
+    // Not a tablebase
+    {
+        std::string path = testing::TempDir() + "test-Tablebase-Invalid.nimtb";
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << "This is not a tablebase, although it is long enough to have a header.";
+        }
+        EXPECT_EQ(Tablebase::open(path), nullptr);
+        std::remove(path.c_str());
+    }
+
+    // Truncated
+    {
+        Rules       rules(Rules::Variation::NORMAL);
+        std::string path = generateTablebase(rules, 3, 5);
+        std::string contents;
+        {
+            std::ifstream in(path, std::ios::binary);
+            contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(contents.data(), static_cast<std::streamsize>(contents.size() - 2));
+        }
+        EXPECT_EQ(Tablebase::open(path), nullptr);
+        std::remove(path.c_str());
+    }
+
+    // Written with the other byte order
+    {
+        Rules       rules(Rules::Variation::NORMAL);
+        std::string path = generateTablebase(rules, 3, 5);
+        std::string contents;
+        {
+            std::ifstream in(path, std::ios::binary);
+            contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        std::reverse(contents.begin() + 24, contents.begin() + 28);
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        }
+        EXPECT_EQ(Tablebase::open(path), nullptr);
+        std::remove(path.c_str());
+    }
+}
+
+TEST(Tablebase, Probe_Misere)
+{
+    Rules       rules(Rules::Variation::MISERE);
+    std::string path      = generateTablebase(rules, 4, 7);
+    auto        tablebase = Tablebase::open(path);
+    ASSERT_NE(tablebase, nullptr);
+    checkAllBoards(*tablebase, rules, {7, 5, 3, 6});
+    std::remove(path.c_str());
+}
+
+TEST(Tablebase, Probe_Normal)
+{
+    Rules       rules(Rules::Variation::NORMAL);
+    std::string path      = generateTablebase(rules, 4, 7);
+    auto        tablebase = Tablebase::open(path);
+    ASSERT_NE(tablebase, nullptr);
+    checkAllBoards(*tablebase, rules, {7, 5, 3, 6});
+    std::remove(path.c_str());
+}
+
+TEST(Tablebase, Probe_Coverage)
+{
+    Rules       rules(Rules::Variation::MISERE);
+    std::string path      = generateTablebase(rules, 3, 5);
+    auto        tablebase = Tablebase::open(path);
+    ASSERT_NE(tablebase, nullptr);
+
+    // Empty heaps and the order of the heaps don't matter
+    EXPECT_TRUE(tablebase->probe(Board({0, 5, 0, 3, 1, 0})).has_value());
+    auto a = tablebase->probe(Board({1, 3, 5}));
+    auto b = tablebase->probe(Board({5, 1, 3}));
+    ASSERT_TRUE(a.has_value());
+    ASSERT_TRUE(b.has_value());
+    EXPECT_EQ(a->win, b->win);
+
+    // Too many heaps or objects
+    EXPECT_FALSE(tablebase->probe(Board({1, 2, 3, 4})).has_value());
+    EXPECT_FALSE(tablebase->probe(Board({6})).has_value());
+
+    // A finished misre game is a win for the player to move, with no move
+    auto finished = tablebase->probe(Board({0, 0}));
+    ASSERT_TRUE(finished.has_value());
+    EXPECT_TRUE(finished->win);
+    EXPECT_FALSE(finished->move.has_value());
+    std::remove(path.c_str());
+}
@@ -1,11 +1,55 @@
 #include "HumanPlayer.h"
 
 #include "Components/Board.h"
+#include "Components/OctalGame.h"
 #include "Components/Rules.h"
 #include "NimState/NimState.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <string>
+
+// Tells the human which numbers of objects can be removed from a heap of `size` objects, when there are at most `most` of them
+static void showAllowed(Rules const & rules, int size, int most)
+{
+    if (rules.isRange())
+    {
+        std::cout << "Invalid number. Enter a number between 1 and " << most << "." << std::endl;
+        return;
+    }
+
+    // In an octal game, a number is listed only if some move on the heap removes it, with or without a split
+    OctalGame const * octal = rules.octalGame();
+    std::cout << "Invalid number. Enter one of";
+    for (int s = 1; s <= most; ++s)
+    {
+        if (octal ? octal->isLegal(size, s, 0) || octal->isLegal(size, s, 1) : rules.allows(s))
+            std::cout << " " << s;
+    }
+    std::cout << "." << std::endl;
+}
+
+// Tells the human what a move that removes `n` objects may leave in an octal game
+static void showOctalMove(OctalGame const & octal, int n)
+{
+    static char const * const LEAVES[] = {"nothing", "one heap", "two heaps"};
+
+    std::cout << "Invalid move. Removing " << n << " may leave";
+    char const * separator = " ";
+    for (int bit = 0; bit < 3; ++bit)
+    {
+        if ((octal.digit(n) >> bit) & 1)
+        {
+            std::cout << separator << LEAVES[bit];
+            separator = " or ";
+        }
+    }
+    if ((octal.digit(n) >> 2) & 1)
+        std::cout << ", and both heaps left by a split must be non-empty";
+    std::cout << "." << std::endl;
+}
 
 HumanPlayer::HumanPlayer(NimState::PlayerId playerId, Rules const & rules)
     : Player(playerId, rules)
@@ -16,21 +60,31 @@ void HumanPlayer::move(NimState * pState)
 {
     Board const & board = pState->board();
 
-    char heapLetter = 'A';
-    int  n;
-    int  i;
+    OctalGame const * octal      = rules_.octalGame();
+    char              heapLetter = 'A';
+    int               n;
+    int               i;
+    int               split = 0; // Number of objects split off in an octal game
+
+    // Returns true if the move entered is legal
+    auto isLegal = [&]()
+    {
+        if (!(0 <= i && i < static_cast<int>(board.size())) || !(1 <= n && n <= board.heap(i)))
+            return false;
+        return octal ? octal->isLegal(board.heap(i), n, split) : rules_.allows(i, n);
+    };
 
     // Get heap selection from user
     do
     {
-        if (rules_.variation() == Rules::Variation::SUBTRACT)
+        if (rules_.variation() == Rules::Variation::SUBTRACT && board.size() == 1)
         {
             std::cout << "Enter the number of objects to remove: " << std::endl;
-            i = 0; // Only one heap in subtraction variation
+            i = 0; // There is only one heap
             std::cin >> n;
-            if (n < 1 || n > rules_.removalLimit())
+            if (!rules_.allows(i, n))
             {
-                std::cout << "Invalid number. Enter a number between 1 and " << rules_.removalLimit() << "." << std::endl;
+                showAllowed(rules_, board.heap(i), rules_.removalLimit(i));
             }
             else if (n > board.heap(i))
             {
@@ -39,9 +93,26 @@ void HumanPlayer::move(NimState * pState)
         }
         else
         {
-            std::cout << "Select heap (A-" << char('A' + board.size() - 1) << ") and the number to remove: ";
+            if (octal)
+            {
+                std::cout << "Select heap (A-" << char('A' + board.size() - 1)
+                          << "), the number to remove, and the number to split off (if any): ";
+            }
+            else
+            {
+                std::cout << "Select heap (A-" << char('A' + board.size() - 1) << ") and the number to remove: ";
+            }
             std::cin >> heapLetter >> n;
 
+            // In an octal game, the number to split off is optional, so the rest of the line is read
+            split = 0;
+            if (octal)
+            {
+                std::string rest;
+                std::getline(std::cin, rest);
+                std::istringstream(rest) >> split;
+            }
+
             // Convert to uppercase if lowercase
             heapLetter = std::toupper(heapLetter);
             i          = heapLetter - 'A';
@@ -55,20 +126,32 @@ void HumanPlayer::move(NimState * pState)
             {
                 std::cout << "Heap " << heapLetter << " is empty. Please choose a non-empty heap." << std::endl;
             }
-            else if (n < 1 || n > board.heap(i))
+            else if (!rules_.hasMove(board.heap(i)))
+            {
+                std::cout << "Heap " << heapLetter << " is too small. Please choose a larger heap." << std::endl;
+            }
+            else if (n < 1 || n > board.heap(i) || !rules_.allows(i, n))
             {
-                std::cout << "Invalid number. Enter a number between 1 and " << board.heap(i) << "." << std::endl;
+                showAllowed(rules_, board.heap(i), std::min(board.heap(i), rules_.removalLimit(i)));
+            }
+            else if (octal && !octal->isLegal(board.heap(i), n, split))
+            {
+                showOctalMove(*octal, n);
             }
         }
-    } while (!(0 <= i && i < static_cast<int>(board.size())) || !(1 <= n && n <= board.heap(i)));
+    } while (!isLegal());
 
     // Apply the move
-    pState->move(i, n);
+    pState->move(i, n, split);
 
-    if (rules_.variation() == Rules::Variation::SUBTRACT)
+    if (rules_.variation() == Rules::Variation::SUBTRACT && board.size() == 1)
     {
         std::cout << "You removed " << n << "." << std::endl;
     }
+    else if (split > 0)
+    {
+        std::cout << "You removed " << n << " from heap " << heapLetter << " and split off " << split << "." << std::endl;
+    }
     else
     {
         std::cout << "You removed " << n << " from heap " << heapLetter << "." << std::endl;
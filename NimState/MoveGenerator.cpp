@@ -0,0 +1,106 @@
+#include "MoveGenerator.h"
+
+#include "Components/Board.h"
+#include "Components/OctalGame.h"
+#include "Components/Rules.h"
+#include "NimState.h"
+
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <vector>
+
+static_assert(Board::MAX_OBJECTS < 128, "The sizes of the heaps and the numbers removed must fit in the bit sets");
+
+MoveGenerator::MoveGenerator(Board const & board, Rules const & rules)
+    : board_(board)
+    , heapLimits_(rules.heapLimits())
+    , limit_((rules.variation() == Rules::Variation::SUBTRACT || rules.octalGame()) ? rules.removalLimit() : Board::MAX_OBJECTS)
+    , i_(0)
+    , n_(0)
+    , split_(0)
+    , octal_(rules.octalGame())
+    , sizes_{0, 0}
+    , removals_{0, 0}
+{
+    // In the subtraction variation, only the numbers in the subtraction set can be removed
+    for (int n = 1; n <= std::min(limit_, Board::MAX_OBJECTS); ++n)
+    {
+        if (rules.allows(n))
+            removals_[n / 64] |= uint64_t(1) << (n % 64);
+    }
+}
+
+std::optional<NimState::Move> MoveGenerator::next()
+{
+    while (i_ < static_cast<int>(board_.size()))
+    {
+        int size = board_.heap(i_);
+
+        // When starting a heap, skip it if it is empty or if a heap of the same size and limit has already been seen
+        if (n_ == 0 && (size == 0 || seen(i_)))
+        {
+            ++i_;
+            continue;
+        }
+
+        int limit = heapLimits_.empty() ? limit_ : heapLimits_[i_];
+        if (octal_)
+        {
+            // Splitting off a objects leaves the same heaps as splitting off (rest - a), so only a <= rest / 2 is tried
+            while (true)
+            {
+                if (n_ > 0 && split_ < (size - n_) / 2 && octal_->isLegal(size, n_, split_ + 1))
+                {
+                    ++split_;
+                    return NimState::Move{static_cast<int8_t>(i_), static_cast<int8_t>(n_), static_cast<int8_t>(split_)};
+                }
+                if (n_ >= std::min(size, limit))
+                    break;
+                ++n_;
+                split_ = 0;
+                if (octal_->isLegal(size, n_, 0))
+                    return NimState::Move{static_cast<int8_t>(i_), static_cast<int8_t>(n_)};
+            }
+        }
+        else
+        {
+            while (n_ < std::min(size, limit))
+            {
+                ++n_;
+                if ((removals_[n_ / 64] >> (n_ % 64)) & 1)
+                    return NimState::Move{static_cast<int8_t>(i_), static_cast<int8_t>(n_)};
+            }
+        }
+
+        // Go to the next heap
+        ++i_;
+        n_     = 0;
+        split_ = 0;
+    }
+    return std::nullopt;
+}
+
+bool MoveGenerator::repeatsEarlierHeap(Board const & board, std::vector<int> const & heapLimits, int i)
+{
+    for (int j = 0; j < i; ++j)
+    {
+        if (board.heap(j) == board.heap(i) && heapLimits[j] == heapLimits[i])
+            return true;
+    }
+    return false;
+}
+
+bool MoveGenerator::seen(int i)
+{
+    // If the heaps have limits of their own, there are few of them, so the earlier heaps are simply compared
+    if (!heapLimits_.empty())
+        return repeatsEarlierHeap(board_, heapLimits_, i);
+
+    int        n    = board_.heap(i);
+    uint64_t & word = sizes_[n / 64];
+    uint64_t   bit  = uint64_t(1) << (n % 64);
+    bool       was  = (word & bit) != 0;
+    word |= bit;
+    return was;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Components/Rules.h"
+#include "NimState.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+class Board;
+
+// Generates the legal moves for a board one at a time, without creating the resulting states.
+//
+// A search can use this with NimState::move() and NimState::undo() to walk the game tree in place on a single state. Moves on a
+// heap of the same size and removal limit as an earlier heap are skipped because they lead to the same game. In an octal game,
+// each number of objects removed is followed by the ways of splitting the rest, without the splits that mirror earlier ones.
+// The board must not change while moves are being generated, except by moves that have been undone.
+class MoveGenerator
+{
+public:
+    // Constructor
+    MoveGenerator(Board const & board, Rules const & rules);
+
+    // Returns the next move, or std::nullopt if there are no more moves.
+    std::optional<NimState::Move> next();
+
+    // Returns true if a heap before heap `i` has the same size and the same removal limit, given the limit of each heap.
+    static bool repeatsEarlierHeap(Board const & board, std::vector<int> const & heapLimits, int i);
+
+private:
+    // Returns true if heap `i` has the same size and limit as a heap that has been seen, and marks its size as seen.
+    bool seen(int i);
+
+    Board const &            board_;       // The board
+    std::vector<int> const & heapLimits_;  // Removal limit of each heap, if they have their own
+    int                      limit_;       // Maximum number of objects that can be removed from a heap
+    int                      i_;           // Index of the current heap
+    int                      n_;           // Number of objects removed by the last move from the current heap (0 if none yet)
+    int                      split_;       // Number of objects split off by the last move from the current heap
+    OctalGame const *        octal_;       // The octal game, or nullptr for other variations
+    uint64_t                 sizes_[2];    // Bit set of the sizes of heaps seen so far
+    uint64_t                 removals_[2]; // Bit set of the numbers of objects that can be removed from a heap
+};
@@ -5,16 +5,120 @@
 #include "Components/Board.h"
 #include "Components/Rules.h"
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <optional>
+#include <vector>
 
-NimState::NimState(Board const & board, Rules rules, PlayerId nextPlayer /* = PlayerId::FIRST*/)
+namespace
+{
+// A free list of blocks of memory for NimState objects.
+//
+// Each thread has its own free list, so allocation requires no locking. The memory for the blocks is allocated in large chunks
+// that are owned by a single global list and released only when the program exits. As a result, a block can be safely freed by a
+// thread other than the one that allocated it, or after that thread has exited.
+class NimStatePool
+{
+public:
+    // Returns a block from the free list, allocating a new chunk of blocks if the list is empty.
+    void * allocate()
+    {
+        if (!free_)
+            grow();
+        Block * block = free_;
+        free_         = block->next;
+        return block;
+    }
+
+    // Returns a block to the free list.
+    void deallocate(void * p)
+    {
+        Block * block = static_cast<Block *>(p);
+        block->next   = free_;
+        free_         = block;
+    }
+
+private:
+    union Block
+    {
+        Block *                         next;                      // Next block in the free list
+        alignas(NimState) unsigned char storage[sizeof(NimState)]; // Storage for a NimState
+    };
+
+    static int constexpr BLOCKS_PER_CHUNK = 1024;
+
+    // Allocates a new chunk of blocks and adds them to the free list.
+    void grow()
+    {
+        auto    chunk  = std::make_unique<Block[]>(BLOCKS_PER_CHUNK);
+        Block * blocks = chunk.get();
+        {
+            std::lock_guard<std::mutex> lock(chunksMutex_);
+            chunks_.push_back(std::move(chunk));
+        }
+        for (int i = 0; i < BLOCKS_PER_CHUNK; ++i)
+        {
+            deallocate(&blocks[i]);
+        }
+    }
+
+    Block * free_ = nullptr; // Head of this thread's free list
+
+    static std::mutex                            chunksMutex_; // Guards chunks_
+    static std::vector<std::unique_ptr<Block[]>> chunks_;      // All chunks allocated by every thread
+};
+
+std::mutex                                          NimStatePool::chunksMutex_;
+std::vector<std::unique_ptr<NimStatePool::Block[]>> NimStatePool::chunks_;
+
+thread_local NimStatePool nimStatePool;
+} // namespace
+
+NimState::NimState(Board const & board,
+                   Rules const & rules,
+                   PlayerId      nextPlayer /* = PlayerId::FIRST*/,
+                   ZHash::Mode   hashMode /* = ZHash::Mode::DEFAULT*/)
     : board_(board)
-    , rules_(std::move(rules))
+    , variation_(rules.variation())
     , nextPlayer_(nextPlayer)
-    , zHash_(board, nextPlayer)
+    , zHash_(board, nextPlayer, hashMode)
     , lastMove_(std::nullopt)
+    , playable_{0, 0}
+    , nimSum_(static_cast<int8_t>(board.nimSum()))
+    , nonEmptyHeaps_(static_cast<int8_t>(board.count()))
+    , significantHeaps_(static_cast<int8_t>(std::count_if(board.begin(), board.end(), [](int n) { return n > 1; })))
+    , playableHeaps_(0)
+{
+    assert(rules.heapLimits().empty() || rules.heapLimits().size() == board.size()); // Each heap has its own limit, or none do
+    assert(!rules.octalGame() || rules.octalGame()->maxHeaps(board) <= Board::MAX_HEAPS); // Every split heap fits on the board
+
+    for (int n = 1; n <= Board::MAX_OBJECTS; ++n)
+    {
+        if (rules.hasMove(n))
+            playable_[n / 64] |= uint64_t(1) << (n % 64);
+    }
+    playableHeaps_ = static_cast<int8_t>(std::count_if(board.begin(), board.end(), [this](int n) { return isPlayable(n); }));
+}
+
+void * NimState::operator new(size_t size)
+{
+    // Classes derived from NimState are too big for the pool
+    if (size != sizeof(NimState))
+        return ::operator new(size, std::align_val_t(alignof(NimState)));
+    return nimStatePool.allocate();
+}
+
+void NimState::operator delete(void * p, size_t size)
 {
+    if (!p)
+        return;
+    if (size != sizeof(NimState))
+        ::operator delete(p, std::align_val_t(alignof(NimState)));
+    else
+        nimStatePool.deallocate(p);
 }
 
 std::optional<NimState::PlayerId> NimState::winner() const
@@ -23,12 +127,13 @@ std::optional<NimState::PlayerId> NimState::winner() const
     if (!isGameOver())
         return std::nullopt;
 
-    switch (rules_.variation())
+    switch (variation_)
     {
     case Rules::Variation::MISERE: // The player who makes the last move loses
         return nextPlayer_;
     case Rules::Variation::NORMAL: // The player who made the last move wins
     case Rules::Variation::SUBTRACT:
+    case Rules::Variation::OCTAL:
         return (nextPlayer_ == PlayerId::FIRST) ? PlayerId::SECOND : PlayerId::FIRST;
     default:
         assert(false && "Unknown variation of the game rules");
@@ -37,17 +142,68 @@ std::optional<NimState::PlayerId> NimState::winner() const
 }
 
 // Makes a move on the board by removeing `n` objects from heap `i`.
-void NimState::move(int i, int n)
+NimState::Undo NimState::move(int i, int n, int split /* = 0*/)
 {
-    assert(0 <= i && i < board_.size() && 0 < n && n <= board_.heap(i)); // Ensure the move is valid
+    assert(0 <= i && i < static_cast<int>(board_.size()) && 0 < n && n <= board_.heap(i)); // Ensure the move is valid
+    assert(split == 0 || (variation_ == Rules::Variation::OCTAL && 0 < split && n + split < board_.heap(i)));
+
+    Undo undo{Move{static_cast<int8_t>(i), static_cast<int8_t>(n), static_cast<int8_t>(split)}, lastMove_};
 
     int from = board_.heap(i);      // Get the current number of objects in heap `i`
-    int to   = from - n;            // Get the new number of objects in heap `i`
-    board_.remove(i, n);            // Update the heap
+    int to   = from - n - split;    // Get the new number of objects in heap `i`
+    board_.remove(i, n + split);    // Update the heap
     zHash_.changeHeap(i, from, to); // Update the Zobrist hash for the heap change
+    updateCounts(from, to);         // Update the nim-sum and heap counts
+
+    // The objects split from the heap become a new heap
+    if (split > 0)
+    {
+        int j = board_.append(split);
+        zHash_.changeHeap(j, 0, split);
+        updateCounts(0, split);
+    }
 
     nextPlayer_ = (nextPlayer_ == PlayerId::FIRST) ? PlayerId::SECOND : PlayerId::FIRST; // Switch players
     zHash_.changeNextPlayer(); // Update the Zobrist hash for the player change
 
-    lastMove_ = Move{static_cast<int8_t>(i), static_cast<int8_t>(n)}; // Store the last move made
+    lastMove_ = undo.move; // Store the last move made
+    return undo;
+}
+
+void NimState::undo(Undo const & undo)
+{
+    assert(lastMove_.has_value() && lastMove_->i == undo.move.i && lastMove_->n == undo.move.n &&
+           lastMove_->split == undo.move.split); // Ensure it is the last move
+
+    // The heap split by the move is the last one
+    int split = undo.move.split;
+    if (split > 0)
+    {
+        int j = static_cast<int>(board_.size()) - 1;
+        assert(board_.heap(j) == split);
+        board_.remove(j, split);
+        zHash_.changeHeap(j, split, 0);
+        updateCounts(split, 0);
+        board_.pop();
+    }
+
+    int i    = undo.move.i;
+    int from = board_.heap(i);
+    int to   = from + undo.move.n + split;
+    board_.add(i, undo.move.n + split); // Restore the heap
+    zHash_.changeHeap(i, from, to);     // Update the Zobrist hash for the heap change
+    updateCounts(from, to);             // Update the nim-sum and heap counts
+
+    nextPlayer_ = (nextPlayer_ == PlayerId::FIRST) ? PlayerId::SECOND : PlayerId::FIRST; // Switch players back
+    zHash_.changeNextPlayer(); // Update the Zobrist hash for the player change
+
+    lastMove_ = undo.lastMove; // Restore the previous last move
+}
+
+void NimState::updateCounts(int from, int to)
+{
+    nimSum_ ^= static_cast<int8_t>(from ^ to);
+    nonEmptyHeaps_ += static_cast<int8_t>((to > 0) - (from > 0));
+    significantHeaps_ += static_cast<int8_t>((to > 1) - (from > 1));
+    playableHeaps_ += static_cast<int8_t>(isPlayable(to) - isPlayable(from));
 }
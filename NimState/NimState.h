@@ -5,27 +5,45 @@
 #include "GamePlayer/GameState.h"
 #include "ZHash.h"
 
+#include <cstddef>
 #include <optional>
 
 // A Nim game state.
-
-class NimState : public GamePlayer::GameState
+//
+// The class is final, so that calls to its overrides through a NimState (rather than a GameState) are not virtual.
+class NimState final : public GamePlayer::GameState
 {
 public:
     using PlayerId = GamePlayer::GameState::PlayerId;
 
     struct Move
     {
-        int8_t i; // Index of the heap from which objects are removed
-        int8_t n; // Number of objects removed from the heap
+        int8_t i;         // Index of the heap from which objects are removed
+        int8_t n;         // Number of objects removed from the heap
+        int8_t split = 0; // Number of objects of the rest moved to a new heap, in an octal game (0 if the heap is not split)
+    };
+
+    // Information needed to undo a move
+    struct Undo
+    {
+        Move                move;     // The move that was made
+        std::optional<Move> lastMove; // The last move made before it
     };
 
     // Constructor
-    explicit NimState(Board const & board, Rules rules, PlayerId nextPlayer = PlayerId::FIRST);
+    explicit NimState(Board const & board,
+                      Rules const & rules,
+                      PlayerId      nextPlayer = PlayerId::FIRST,
+                      ZHash::Mode   hashMode   = ZHash::Mode::DEFAULT);
 
     // Destructor
     virtual ~NimState() = default;
 
+    // Allocation functions. NimState objects are allocated from a per-thread free list instead of the heap, because the search
+    // allocates and frees one for every node it visits. Blocks are recycled by the free list and never returned to the heap.
+    static void * operator new(size_t size);
+    static void   operator delete(void * p, size_t size);
+
     // Returns a fingerprint for this state. Overrides GameState::fingerprint().
     virtual uint64_t fingerprint() const override { return zHash_.value(); }
 
@@ -35,8 +53,17 @@ public:
     // Returns the board.
     Board const & board() const { return board_; }
 
-    // Returns true if the game is over.
-    bool isGameOver() const { return board_.empty(); }
+    // Returns true if the game is over, which is when there is no move on any heap.
+    bool isGameOver() const { return playableHeaps_ == 0; }
+
+    // Returns the nim-sum of the board. This is maintained incrementally, so it doesn't scan the heaps.
+    int nimSum() const { return nimSum_; }
+
+    // Returns the number of non-empty heaps. This is maintained incrementally, so it doesn't scan the heaps.
+    int nonEmptyHeaps() const { return nonEmptyHeaps_; }
+
+    // Returns the number of heaps with more than one object. This is maintained incrementally, so it doesn't scan the heaps.
+    int significantHeaps() const { return significantHeaps_; }
 
     // Returns the winner of the game, if any.
     std::optional<PlayerId> winner() const;
@@ -44,13 +71,30 @@ public:
     // Returns the last move made, if any.
     std::optional<Move> lastMove() const { return lastMove_; }
 
-    // Makes a move on the board by removing `n` objects from heap `i`.
-    void move(int i, int n);
+    // Makes a move on the board by removing `n` objects from heap `i`, and then, in an octal game, moving `split` of the objects
+    // left to a new heap after the last one. Returns the information needed to undo the move.
+    Undo move(int i, int n, int split = 0);
+
+    // Undoes a move, restoring the board, the fingerprint, the next player, and the last move. Moves must be undone in the reverse
+    // order that they were made.
+    void undo(Undo const & undo);
 
 private:
+    // Updates the nim-sum and the heap counts when a heap changes from `from` objects to `to` objects.
+    void updateCounts(int from, int to);
+
+    // Returns true if there is a move on a heap of `n` objects.
+    bool isPlayable(int n) const { return (playable_[n / 64] >> (n % 64)) & 1; }
+
     Board               board_;      // Board stored in row-major order
-    Rules               rules_;      // The rules for the game being played
+    Rules::Variation    variation_;  // The variation of the game being played
     PlayerId            nextPlayer_; // Next player to move
     ZHash               zHash_;      // Zobrist hash for the game state
     std::optional<Move> lastMove_;   // Last move made (heap index and number of objects removed)
+
+    uint64_t playable_[2];      // Bit set of the sizes of heaps on which there is a move
+    int8_t   nimSum_;           // Nim-sum of the board
+    int8_t   nonEmptyHeaps_;    // Number of non-empty heaps
+    int8_t   significantHeaps_; // Number of heaps with more than one object
+    int8_t   playableHeaps_;    // Number of heaps on which there is a move
 };
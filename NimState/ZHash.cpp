@@ -4,24 +4,30 @@
 #include "GamePlayer/GameState.h"
 
 #include <cassert>
-#include <random>
 
-ZHash::ZValueTable const ZHash::zValueTable_;
+// The table is a constant expression, so it is built by the compiler rather than by a static initializer
+constexpr ZHash::ZValueTable ZHash::zValueTable_;
 
-ZHash::ZHash(Board const & board, GamePlayer::GameState::PlayerId nextPlayer)
+ZHash::ZHash(Board const & board, GamePlayer::GameState::PlayerId nextPlayer, Mode mode /* = Mode::DEFAULT*/)
     : value_(ZHash::EMPTY)
+    , mode_(mode)
 {
     // Initialize the hash value based on the current board state
     for (int i = 0; i < board.size(); ++i)
     {
         // Assumes that the hash value for an empty heap is always 0
         int n = board.heap(i);
-        value_ ^= zValueTable_.heap_[i][n];
+        if (mode_ == Mode::CANONICAL)
+            value_ += zValueTable_.canonicalHeap_[n];
+        else if (mode_ == Mode::COMPACT)
+            value_ ^= zValueTable_.compactHeap(i, n);
+        else
+            value_ ^= zValueTable_.heap_[i][n];
     }
 
     // The hash for the first player is 0.
     if (nextPlayer == GamePlayer::GameState::PlayerId::SECOND)
-        value_ ^= zValueTable_.nextPlayer_;
+        changeNextPlayer();
 }
 
 // Updates the hash value when changing the number of objects in heap 'i' from 'from' to 'to'.
@@ -30,30 +36,57 @@ ZHash ZHash::changeHeap(int i, int from, int to)
     assert(0 <= i && i < Board::MAX_HEAPS);
     assert(0 <= from && from <= Board::MAX_OBJECTS);
     assert(0 <= to && to <= Board::MAX_OBJECTS);
-    value_ ^= zValueTable_.heap_[i][from];
-    value_ ^= zValueTable_.heap_[i][to];
+    if (mode_ == Mode::CANONICAL)
+    {
+        value_ -= zValueTable_.canonicalHeap_[from];
+        value_ += zValueTable_.canonicalHeap_[to];
+    }
+    else if (mode_ == Mode::COMPACT)
+    {
+        value_ ^= zValueTable_.compactHeap(i, from);
+        value_ ^= zValueTable_.compactHeap(i, to);
+    }
+    else
+    {
+        value_ ^= zValueTable_.heap_[i][from];
+        value_ ^= zValueTable_.heap_[i][to];
+    }
     return *this; // Return the updated ZHash object
 }
 
 ZHash ZHash::changeNextPlayer()
 {
-    value_ ^= zValueTable_.nextPlayer_;
+    value_ ^= (mode_ == Mode::CANONICAL) ? ZValueTable::CANONICAL_NEXT_PLAYER : zValueTable_.nextPlayer_;
     return *this; // Return the updated ZHash object
 }
 
-ZHash::ZValueTable::ZValueTable()
+ZHash::Z ZHash::signature()
 {
-    std::mt19937_64 rng;
-    static_assert(sizeof(std::mt19937_64::result_type) == 8, "The random number generator must generate 64 bits.");
-    // Note: We don't seed the generator. This means that the same values are generated each time the program is run.
-
-    for (int i = 0; i < Board::MAX_HEAPS; ++i)
+    // FNV-1a over the values, a byte at a time
+    Z    digest = 0xcbf29ce484222325;
+    auto add    = [&digest](Z z)
     {
-        heap_[i][0] = ZHash::EMPTY; // The hash value for an empty heap is always 0
-        for (int j = 1; j <= Board::MAX_OBJECTS; ++j)
+        for (int i = 0; i < 8; ++i)
         {
-            heap_[i][j] = rng(); // Generate a random hash value for each heap and number of objects
+            digest ^= (z >> (8 * i)) & 0xff;
+            digest *= 0x100000001b3;
         }
+    };
+    for (auto const & heap : zValueTable_.heap_)
+    {
+        for (Z z : heap)
+        {
+            add(z);
+        }
+    }
+    add(zValueTable_.nextPlayer_);
+    for (Z z : zValueTable_.canonicalHeap_)
+    {
+        add(z);
+    }
+    for (Z z : zValueTable_.compactHeap_)
+    {
+        add(z);
     }
-    nextPlayer_ = rng(); // Generate a random hash value for the next player
+    return digest;
 }
@@ -13,30 +13,57 @@
 // is 2.710502×10<sup>-8</sup>, but with 1 billion values, it rises to 1 in 40.
 //
 // An important characteristic of a Zorbrist hash is that it is independent of the order of the changes made to reach the state.
+//
+// In the canonical mode, the value depends only on the sizes of the heaps and not on their order, so that boards which are
+// permutations of each other (which are the same game) have the same value. The values of the heaps are added rather than
+// XOR'd, because XOR'ing the values of two heaps of the same size would cancel them out.
+//
+// In the compact mode, the value depends on the size and the position of each heap like the positional mode, but the value of
+// a heap is the value of its size rotated by an amount that depends on its position. Only one value is stored for each size,
+// so the table is small enough to stay in the L1 cache.
+//
+// The random values are generated at compile time by splitmix64, so they cost nothing at startup and are the same in every
+// build. The k-th value depends only on the seed and k.
 class ZHash
 {
 public:
     // Type of a hash value
     using Z = std::uint64_t;
 
+    // Ways of computing the hash value
+    enum class Mode
+    {
+        POSITIONAL = 0,      // The value depends on the size and the position of each heap
+        CANONICAL,           // The value depends only on the sizes of the heaps
+        COMPACT,             // The value depends on the size and the position of each heap, using a smaller table
+        DEFAULT = POSITIONAL // Default mode
+    };
+
     // The value of an empty board
     static Z constexpr EMPTY = 0;
 
     // A value which represents an "undefined" state
     static Z constexpr UNDEFINED = ~EMPTY;
 
+    // The seed of the random values. Values saved with a different seed can't be compared.
+    static uint64_t constexpr SEED = 5489;
+
     // Constructor
-    explicit ZHash(Z z = EMPTY)
+    explicit ZHash(Z z = EMPTY, Mode mode = Mode::DEFAULT)
         : value_(z)
+        , mode_(mode)
     {
     }
 
     // Constructor
-    ZHash(Board const & board, GamePlayer::GameState::PlayerId currentPlayer);
+    ZHash(Board const & board, GamePlayer::GameState::PlayerId currentPlayer, Mode mode = Mode::DEFAULT);
 
     // Returns the current value.
     Z value() const { return value_; }
 
+    // Returns the mode used to compute the value.
+    Mode mode() const { return mode_; }
+
     // Returns true if the value is undefined (i.e. not a legal Z value)
     bool isUndefined() const { return value_ == UNDEFINED; }
 
@@ -47,13 +74,17 @@ public:
     // Updates the hash value when changing the next player. Returns the updated ZHash object.
     ZHash changeNextPlayer();
 
+    // Returns a digest of the random values, which changes if they do. Used to check hash values that were saved.
+    static Z signature();
+
 private:
     friend bool operator==(ZHash const & x, ZHash const & y);
     friend bool operator<(ZHash const & x, ZHash const & y);
 
     class ZValueTable; // declared below
 
-    Z value_; // The hash value
+    Z    value_; // The hash value
+    Mode mode_;  // The way the value is computed
 
     static ZValueTable const zValueTable_; // The hash values for each incremental state change
 };
@@ -73,8 +104,65 @@ inline bool operator<(ZHash const & x, ZHash const & y)
 class ZHash::ZValueTable
 {
 public:
-    ZValueTable();
+    // Constructor
+    constexpr ZValueTable()
+        : heap_{}
+        , nextPlayer_(0)
+        , canonicalHeap_{}
+        , compactHeap_{}
+    {
+        // Each value is numbered, so that adding values never changes the existing ones
+        uint64_t k = 0;
+        for (int i = 0; i < Board::MAX_HEAPS; ++i)
+        {
+            heap_[i][0] = ZHash::EMPTY; // The hash value for an empty heap is always 0
+            for (int j = 1; j <= Board::MAX_OBJECTS; ++j)
+            {
+                heap_[i][j] = random(k++);
+            }
+        }
+        nextPlayer_ = random(k++);
+
+        canonicalHeap_[0] = ZHash::EMPTY; // The hash value for an empty heap is always 0
+        for (int j = 1; j <= Board::MAX_OBJECTS; ++j)
+        {
+            canonicalHeap_[j] = random(k++) & ~CANONICAL_NEXT_PLAYER; // The canonical values are even
+        }
+
+        compactHeap_[0] = ZHash::EMPTY; // The hash value for an empty heap is always 0
+        for (int j = 1; j <= Board::MAX_OBJECTS; ++j)
+        {
+            compactHeap_[j] = random(k++);
+        }
+    }
+
+    // Returns the k-th random value (splitmix64).
+    static constexpr Z random(uint64_t k)
+    {
+        Z z = SEED + (k + 1) * 0x9e3779b97f4a7c15;
+        z   = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z   = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+    // Returns the compact hash value for heap i with j objects.
+    constexpr Z compactHeap(int i, int j) const
+    {
+        // The rotations of the heaps are distinct, because 5 and 64 are coprime and there are fewer than 64 heaps
+        int r = (COMPACT_ROTATION * i) & 63;
+        Z   z = compactHeap_[j];
+        return (z << r) | (z >> ((64 - r) & 63));
+    }
+
+    alignas(64) Z heap_[Board::MAX_HEAPS][Board::MAX_OBJECTS + 1]; // The hash value for heap i with j objects
+    Z nextPlayer_;                                                 // The hash value for the next player
+    alignas(64) Z canonicalHeap_[Board::MAX_OBJECTS + 1];          // The canonical hash value for a heap with j objects (even)
+    alignas(64) Z compactHeap_[Board::MAX_OBJECTS + 1];            // The compact hash value for a heap with j objects
+
+    // The canonical hash value for the next player. The canonical heap values are even, so their sum never affects this bit.
+    static Z constexpr CANONICAL_NEXT_PLAYER = 1;
 
-    Z heap_[Board::MAX_HEAPS][Board::MAX_OBJECTS + 1]; // The hash value for heap i with j objects
-    Z nextPlayer_;                                     // The hash value for the next player
+    // Number of bits by which the compact value of a heap is rotated for each position
+    static int constexpr COMPACT_ROTATION = 5;
+    static_assert(Board::MAX_HEAPS <= 64, "The compact values of the heaps must have distinct rotations");
 };
@@ -0,0 +1,140 @@
+#include "gtest/gtest.h"
+
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "NimState/MoveGenerator.h"
+#include "NimState/NimState.h"
+
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Returns all the moves generated for a board
+static std::vector<std::pair<int, int>> allMoves(Board const & board, Rules const & rules)
+{
+    std::vector<std::pair<int, int>> moves;
+    MoveGenerator                    generator(board, rules);
+    while (std::optional<NimState::Move> move = generator.next())
+    {
+        moves.emplace_back(move->i, move->n);
+    }
+    return moves;
+}
+
+namespace Nim
+{
+
+TEST(MoveGenerator, Constructor)
+{
+    // Nothing to test here, just make sure the constructor executes without error
+    Rules rules;
+    Board board({1, 2, 3});
+    ASSERT_NO_THROW(MoveGenerator(board, rules));
+}
+
+TEST(MoveGenerator, Next)
+{
+    Rules rules(Rules::Variation::NORMAL);
+
+    // Every move on every heap is generated
+    std::vector<std::pair<int, int>> expected = {{0, 1}, {1, 1}, {1, 2}, {2, 1}, {2, 2}, {2, 3}};
+    EXPECT_EQ(allMoves(Board({1, 2, 3}), rules), expected);
+
+    // Empty heaps and heaps with the same size as an earlier heap are skipped
+    expected = {{1, 1}, {1, 2}, {3, 1}};
+    EXPECT_EQ(allMoves(Board({0, 2, 2, 1, 0, 1, 2}), rules), expected);
+
+    // There are no moves if the game is over
+    EXPECT_TRUE(allMoves(Board({0, 0, 0}), rules).empty());
+
+    // Once the moves are exhausted, there are no more
+    Board         board({1});
+    MoveGenerator generator(board, rules);
+    EXPECT_TRUE(generator.next().has_value());
+    EXPECT_FALSE(generator.next().has_value());
+    EXPECT_FALSE(generator.next().has_value());
+}
+
+TEST(MoveGenerator, Next_Subtract)
+{
+    // In the subtraction variation, the number of objects removed is limited
+    Rules                            rules(Rules::Variation::SUBTRACT, 3);
+    std::vector<std::pair<int, int>> expected = {{0, 1}, {0, 2}, {0, 3}};
+    EXPECT_EQ(allMoves(Board({10}), rules), expected);
+    expected = {{0, 1}, {0, 2}};
+    EXPECT_EQ(allMoves(Board({2}), rules), expected);
+}
+
+TEST(MoveGenerator, Next_SubtractionSet)
+{
+    // Only the numbers of objects in the subtraction set are removed
+    Rules                            rules(std::vector<int>{1, 3, 4});
+    std::vector<std::pair<int, int>> expected = {{0, 1}, {0, 3}, {0, 4}, {1, 1}};
+    EXPECT_EQ(allMoves(Board({10, 2}), rules), expected);
+
+    // There are no moves if every heap is too small
+    EXPECT_TRUE(allMoves(Board({1, 1}), Rules(std::vector<int>{2, 5, 7})).empty());
+}
+
+TEST(MoveGenerator, Next_HeapLimits)
+{
+    // Heaps of the same size with different limits are not the same, and each one has its own limit
+    Rules                            rules(Rules::Variation::SUBTRACT, std::vector<int>{1, 2, 3});
+    std::vector<std::pair<int, int>> expected = {{0, 1}, {1, 1}, {1, 2}, {2, 1}};
+    EXPECT_EQ(allMoves(Board({2, 2, 1}), rules), expected);
+
+    // Heaps of the same size with the same limit are the same, so only the first one is used
+    Rules                            same(Rules::Variation::SUBTRACT, std::vector<int>{1, 2, 1, 2});
+    std::vector<std::pair<int, int>> expectedSame = {{0, 1}, {1, 1}, {1, 2}, {3, 1}, {3, 2}};
+    EXPECT_EQ(allMoves(Board({2, 2, 2, 3}), same), expectedSame);
+}
+
+TEST(MoveGenerator, Next_Octal)
+{
+    // In Dawson's chess (0.137), 1 is removed only from a heap of 1, 2 only without splitting the heap, and 3 in any way
+    Rules                                  rules(Rules::Variation::OCTAL, "0.137");
+    std::vector<std::tuple<int, int, int>> moves;
+    MoveGenerator                          generator(Board({8, 1, 8}), rules);
+    while (std::optional<NimState::Move> move = generator.next())
+    {
+        moves.emplace_back(move->i, move->n, move->split);
+    }
+    std::vector<std::tuple<int, int, int>> expected = {{0, 2, 0}, {0, 3, 0}, {0, 3, 1}, {0, 3, 2}, {1, 1, 0}};
+    EXPECT_EQ(moves, expected);
+
+    // Making and undoing each move leaves the board unchanged
+    NimState state(Board({9, 4}), rules);
+    NimState original = state;
+    int      count    = 0;
+    for (MoveGenerator all(state.board(), rules); std::optional<NimState::Move> move = all.next(); ++count)
+    {
+        NimState::Undo undo = state.move(move->i, move->n, move->split);
+        state.undo(undo);
+    }
+    EXPECT_EQ(count, 7);
+    EXPECT_EQ(state.board(), original.board());
+    EXPECT_EQ(state.fingerprint(), original.fingerprint());
+}
+
+TEST(MoveGenerator, Next_MakeUndo)
+{
+    // Making and undoing each move while generating moves leaves the state unchanged and generates the same moves
+    Rules    rules(Rules::Variation::MISERE);
+    NimState state(Board({3, 1, 4, 1, 5}), rules);
+    NimState original = state;
+
+    std::vector<std::pair<int, int>> moves;
+    MoveGenerator                    generator(state.board(), rules);
+    while (std::optional<NimState::Move> move = generator.next())
+    {
+        NimState::Undo undo = state.move(move->i, move->n);
+        state.undo(undo);
+        moves.emplace_back(move->i, move->n);
+    }
+    EXPECT_EQ(moves, allMoves(original.board(), rules));
+    EXPECT_EQ(state.board(), original.board());
+    EXPECT_EQ(state.fingerprint(), original.fingerprint());
+}
+
+} // namespace Nim
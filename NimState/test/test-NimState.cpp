@@ -2,6 +2,34 @@
 
 #include "NimState/NimState.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Number of allocations from the heap
+static int allocations = 0;
+
+void * operator new(size_t size)
+{
+    ++allocations;
+    void * p = std::malloc(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void * p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+    std::free(p);
+}
+
 namespace Nim
 {
 
@@ -52,6 +80,16 @@ TEST(NimState, IsGameOver)
     Rules rules;
     EXPECT_TRUE(NimState(Board({0}), rules).isGameOver());  // An empty board is game over
     EXPECT_FALSE(NimState(Board({1}), rules).isGameOver()); // A non-empty board is not game over
+
+    // In the subtraction variation, the game is over when every heap is smaller than the smallest move
+    Rules    subtractRules(std::vector<int>{2, 5, 7});
+    NimState state(Board({1, 3, 1}), subtractRules);
+    EXPECT_FALSE(state.isGameOver());
+    NimState::Undo undo = state.move(1, 2);
+    EXPECT_TRUE(state.isGameOver());
+    EXPECT_EQ(state.winner(), NimState::PlayerId::FIRST);
+    state.undo(undo);
+    EXPECT_FALSE(state.isGameOver());
 }
 
 TEST(NimState, Winner)
@@ -109,4 +147,154 @@ TEST(NimState, Move)
     EXPECT_EQ(state.fingerprint(), 0);                       // The fingerprint should be 0
 }
 
+TEST(NimState, Counts)
+{
+    // The incrementally maintained counts must always match the board
+    Rules    rules(Rules::Variation::MISERE);
+    NimState state(Board({0, 1, 2, 3, 9}), rules);
+    auto     check = [](NimState const & s)
+    {
+        Board const & board = s.board();
+        EXPECT_EQ(s.nimSum(), board.nimSum());
+        EXPECT_EQ(s.nonEmptyHeaps(), board.count());
+        EXPECT_EQ(s.significantHeaps(), std::count_if(board.begin(), board.end(), [](int n) { return n > 1; }));
+        EXPECT_EQ(s.isGameOver(), board.empty());
+    };
+    check(state);
+    EXPECT_EQ(state.nimSum(), 1 ^ 2 ^ 3 ^ 9);
+    EXPECT_EQ(state.nonEmptyHeaps(), 4);
+    EXPECT_EQ(state.significantHeaps(), 3);
+
+    std::vector<NimState::Undo> undos;
+    for (auto [i, n] : {std::pair{4, 8}, {2, 1}, {3, 3}, {1, 1}, {2, 1}, {4, 1}})
+    {
+        undos.push_back(state.move(i, n));
+        check(state);
+    }
+    EXPECT_TRUE(state.isGameOver());
+    EXPECT_EQ(state.nonEmptyHeaps(), 0);
+    while (!undos.empty())
+    {
+        state.undo(undos.back());
+        undos.pop_back();
+        check(state);
+    }
+    EXPECT_EQ(state.significantHeaps(), 3);
+}
+
+TEST(NimState, Undo)
+{
+    Rules    rules(Rules::Variation::NORMAL);
+    NimState state(Board({3, 5, 7}), rules, NimState::PlayerId::FIRST);
+    NimState state0 = state;
+
+    NimState::Undo undo1 = state.move(1, 4);
+    NimState       state1 = state;
+    NimState::Undo undo2  = state.move(2, 7);
+    EXPECT_EQ(undo2.move.i, 2);
+    EXPECT_EQ(undo2.move.n, 7);
+
+    // Undoing the second move restores everything to the way it was after the first move
+    state.undo(undo2);
+    EXPECT_EQ(state.board(), state1.board());
+    EXPECT_EQ(state.fingerprint(), state1.fingerprint());
+    EXPECT_EQ(state.whoseTurn(), state1.whoseTurn());
+    ASSERT_TRUE(state.lastMove().has_value());
+    EXPECT_EQ(state.lastMove()->i, 1);
+    EXPECT_EQ(state.lastMove()->n, 4);
+
+    // Undoing the first move restores the initial state
+    state.undo(undo1);
+    EXPECT_EQ(state.board(), state0.board());
+    EXPECT_EQ(state.fingerprint(), state0.fingerprint());
+    EXPECT_EQ(state.whoseTurn(), state0.whoseTurn());
+    EXPECT_FALSE(state.lastMove().has_value());
+
+    // Only the last move can be undone
+    state.move(0, 1);
+    EXPECT_DEATH(state.undo(undo2), "Assertion failed: .*");
+}
+
+TEST(NimState, Move_Split)
+{
+    // In Dawson's chess (0.137), removing 3 objects from a heap may split the rest into two heaps
+    Rules    rules(Rules::Variation::OCTAL, "0.137");
+    NimState state(Board({8, 2}), rules, NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL);
+    NimState state0 = state;
+
+    NimState::Undo undo = state.move(0, 3, 2); // {3, 2, 2}
+    EXPECT_EQ(undo.move.split, 2);
+    EXPECT_EQ(state.board(), Board({3, 2, 2}));
+    EXPECT_EQ(state.nonEmptyHeaps(), 3);
+    EXPECT_EQ(state.nimSum(), 3);
+    NimState state1(Board({2, 3, 2}), rules, NimState::PlayerId::SECOND, ZHash::Mode::CANONICAL);
+    EXPECT_EQ(state.fingerprint(), state1.fingerprint()); // The new heap is like any other heap
+
+    // Undoing the move removes the new heap
+    state.undo(undo);
+    EXPECT_EQ(state.board(), state0.board());
+    EXPECT_EQ(state.fingerprint(), state0.fingerprint());
+    EXPECT_EQ(state.nonEmptyHeaps(), 2);
+
+    // A heap of 2 has no move in 0.022, so the game is over when every heap has 2 objects or fewer
+    Rules    rules022(Rules::Variation::OCTAL, "0.022");
+    NimState game(Board({5}), rules022);
+    EXPECT_FALSE(game.isGameOver());
+    game.move(0, 3); // {2}
+    EXPECT_TRUE(game.isGameOver());
+    EXPECT_EQ(game.winner(), NimState::PlayerId::FIRST); // Octal games are played with the normal play rule
+}
+
+TEST(NimState, Move_canonical)
+{
+    // With canonical hashing, states reached by moves on different heaps have the same fingerprint if their boards are
+    // permutations of each other.
+    Rules    rules(Rules::Variation::NORMAL);
+    NimState state0(Board({3, 5, 7}), rules, NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL);
+    NimState state1 = state0;
+    state0.move(0, 2); // {1, 5, 7}
+    state0.move(2, 2); // {1, 5, 5}
+    state1.move(1, 4); // {3, 1, 7}
+    state1.move(0, 1); // {2, 1, 7}
+    state1.move(2, 2); // {2, 1, 5}
+    state1.move(0, 2); // {0, 1, 5}
+    EXPECT_NE(state0.fingerprint(), state1.fingerprint()); // {1, 5, 5} and {0, 1, 5} are different games
+    NimState state2(Board({5, 1, 5}), rules, NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL);
+    EXPECT_EQ(state0.fingerprint(), state2.fingerprint()); // {1, 5, 5} and {5, 1, 5} are the same game
+}
+
+TEST(NimState, New)
+{
+    Rules    rules;
+    NimState state(Board({1, 2, 3}), rules);
+
+    // Allocate enough states to grow the pool, then free them all
+    std::vector<NimState *> states;
+    for (int i = 0; i < 5000; ++i)
+    {
+        states.push_back(new NimState(state));
+    }
+    for (auto * p : states)
+    {
+        delete p;
+    }
+
+    // States allocated from now on should reuse the freed blocks. Since the board is stored inline, copying and changing a state
+    // should not allocate anything from the heap.
+    allocations = 0;
+    for (int i = 0; i < 5000; ++i)
+    {
+        NimState * p = new NimState(state);
+        p->move(2, 1);
+        states[i] = p;
+    }
+    EXPECT_EQ(allocations, 0);
+    for (auto * p : states)
+    {
+        EXPECT_EQ(p->board().heap(2), 2);
+        delete static_cast<GamePlayer::GameState *>(p); // The search deletes states through the base class
+    }
+    EXPECT_EQ(allocations, 0);
+}
+
 } // namespace Nim
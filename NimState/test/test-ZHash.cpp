@@ -93,6 +93,77 @@ TEST(ZHash, Constructor_board_player)
     }
 }
 
+TEST(ZHash, Constructor_canonical)
+{
+    // Permutations of a board have the same canonical value, but different positional values
+    ZHash z0(Board({3, 5, 7}), NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL);
+    ZHash z1(Board({7, 5, 3}), NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL);
+    ZHash z2(Board({5, 0, 7, 3}), NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL); // Empty heaps don't matter either
+    EXPECT_EQ(z0.mode(), ZHash::Mode::CANONICAL);
+    EXPECT_EQ(z0.value(), z1.value());
+    EXPECT_NE(ZHash(Board({3, 5, 7}), NimState::PlayerId::FIRST).value(), ZHash(Board({7, 5, 3}), NimState::PlayerId::FIRST).value());
+    EXPECT_NE(z0.value(), ZHash(Board({3, 5, 7}), NimState::PlayerId::SECOND, ZHash::Mode::CANONICAL).value());
+
+    // Heaps of the same size must not cancel each other out
+    EXPECT_EQ(ZHash(Board({0, 0}), NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL).value(), ZHash::EMPTY);
+    EXPECT_NE(ZHash(Board({4, 4}), NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL).value(), ZHash::EMPTY);
+    EXPECT_NE(ZHash(Board({4, 4}), NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL).value(),
+              ZHash(Board({4, 4, 4, 4}), NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL).value());
+
+    // Boards with different sizes of heaps have different values
+    std::vector<ZHash> hashes;
+    for (int a = 0; a <= 4; ++a)
+    {
+        for (int b = a; b <= 4; ++b)
+        {
+            for (int c = b; c <= 4; ++c)
+            {
+                hashes.emplace_back(Board({int8_t(a), int8_t(b), int8_t(c)}), NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL);
+            }
+        }
+    }
+    EXPECT_FALSE(containsDuplicates(hashes));
+}
+
+TEST(ZHash, Constructor_compact)
+{
+    // Like the positional values, the compact values depend on the positions of the heaps
+    ZHash z0(Board({3, 5, 7}), NimState::PlayerId::FIRST, ZHash::Mode::COMPACT);
+    ZHash z1(Board({7, 5, 3}), NimState::PlayerId::FIRST, ZHash::Mode::COMPACT);
+    EXPECT_EQ(z0.mode(), ZHash::Mode::COMPACT);
+    EXPECT_NE(z0.value(), z1.value());
+    EXPECT_NE(z0.value(), ZHash(Board({3, 5, 7}), NimState::PlayerId::FIRST).value());
+    EXPECT_NE(z0.value(), ZHash(Board({3, 5, 7}), NimState::PlayerId::SECOND, ZHash::Mode::COMPACT).value());
+
+    // Heaps of the same size don't cancel each other out
+    EXPECT_EQ(ZHash(Board({0, 0}), NimState::PlayerId::FIRST, ZHash::Mode::COMPACT).value(), ZHash::EMPTY);
+    EXPECT_NE(ZHash(Board({4, 4}), NimState::PlayerId::FIRST, ZHash::Mode::COMPACT).value(), ZHash::EMPTY);
+
+    // Every board with 3 heaps of up to 6 objects, and every board with a single non-empty heap, has a different value
+    std::vector<ZHash> hashes;
+    for (int a = 0; a <= 6; ++a)
+    {
+        for (int b = 0; b <= 6; ++b)
+        {
+            for (int c = 0; c <= 6; ++c)
+            {
+                Board board({int8_t(a), int8_t(b), int8_t(c)});
+                hashes.emplace_back(board, NimState::PlayerId::FIRST, ZHash::Mode::COMPACT);
+            }
+        }
+    }
+    for (int i = 3; i < Board::MAX_HEAPS; ++i)
+    {
+        for (int n = 1; n <= Board::MAX_OBJECTS; ++n)
+        {
+            std::vector<int8_t> heaps(i + 1, 0);
+            heaps[i] = int8_t(n);
+            hashes.emplace_back(Board(heaps), NimState::PlayerId::FIRST, ZHash::Mode::COMPACT);
+        }
+    }
+    EXPECT_FALSE(containsDuplicates(hashes));
+}
+
 TEST(ZHash, Value)
 {
     // I'll think of a way to test this later. ZHash::value() is used everywhere, so it will be tested indirectly.
@@ -144,6 +215,31 @@ TEST(ZHash, ChangeHeap)
                              { return hash.value() == z0.value(); })); // None of the hashes should be the same as the initial one
 }
 
+TEST(ZHash, ChangeHeap_canonical)
+{
+    // Changing the heaps incrementally gives the same value as computing it from the board
+    ZHash z(Board({3, 5, 7}), NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL);
+    z.changeHeap(0, 3, 1);
+    z.changeHeap(2, 7, 5);
+    EXPECT_EQ(z.value(), ZHash(Board({1, 5, 5}), NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL).value());
+    EXPECT_EQ(z.value(), ZHash(Board({5, 1, 5}), NimState::PlayerId::FIRST, ZHash::Mode::CANONICAL).value());
+
+    // Changing the next player toggles the value
+    z.changeNextPlayer();
+    EXPECT_EQ(z.value(), ZHash(Board({5, 5, 1}), NimState::PlayerId::SECOND, ZHash::Mode::CANONICAL).value());
+}
+
+TEST(ZHash, ChangeHeap_compact)
+{
+    // Changing the heaps incrementally gives the same value as computing it from the board
+    ZHash z(Board({3, 5, 7}), NimState::PlayerId::FIRST, ZHash::Mode::COMPACT);
+    z.changeHeap(0, 3, 1);
+    z.changeHeap(2, 7, 0);
+    EXPECT_EQ(z.value(), ZHash(Board({1, 5, 0}), NimState::PlayerId::FIRST, ZHash::Mode::COMPACT).value());
+    z.changeNextPlayer();
+    EXPECT_EQ(z.value(), ZHash(Board({1, 5, 0}), NimState::PlayerId::SECOND, ZHash::Mode::COMPACT).value());
+}
+
 TEST(ZHash, ChangeNextPlayer)
 {
     // Since values are random, they cannot be compared to predetermined values.
@@ -156,4 +252,17 @@ TEST(ZHash, ChangeNextPlayer)
     EXPECT_EQ(z0.value(), z2.value()); // two changes should return to the original state
 }
 
+TEST(ZHash, Signature)
+{
+    // The values are generated from the seed by splitmix64, so the first one is known
+    uint64_t z = ZHash::SEED + 0x9e3779b97f4a7c15;
+    z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z          = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    EXPECT_EQ(ZHash(Board({1}), GamePlayer::GameState::PlayerId::FIRST).value(), z ^ (z >> 31));
+
+    // The signature doesn't change from call to call
+    EXPECT_EQ(ZHash::signature(), ZHash::signature());
+    EXPECT_NE(ZHash::signature(), ZHash::EMPTY);
+}
+
 } // namespace Nim
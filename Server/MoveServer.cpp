@@ -0,0 +1,575 @@
+#include "MoveServer.h"
+
+#include "ComputerPlayer/NimSearch.h"
+#include "ComputerPlayer/Position.h"
+#include "ComputerPlayer/SharedTranspositionTable.h"
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "NimState/NimState.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static uint64_t const LISTENER_ID   = 0;         // epoll data of the listening socket
+static uint64_t const WAKEUP_ID     = 1;         // epoll data of the eventfd
+static int const      MAX_EVENTS    = 64;        // Number of events handled per call to epoll_wait
+static size_t const   READ_SIZE     = 16384;     // Number of bytes read from a socket at a time
+static size_t const   MAX_LINE_SIZE = 4096;      // Longest request accepted
+static size_t const   MAX_INPUT     = 65536;     // Most input held for a connection whose requests are waiting
+static int const      BACKLOG       = SOMAXCONN; // Number of connections waiting to be accepted
+static uint64_t const GAMES_PER_AGE = 64;        // Number of games started between agings of the shared tables
+
+// A client connection
+struct MoveServer::Connection
+{
+    int         fd;      // Socket
+    uint64_t    id;      // Id, which is also its epoll data
+    uint32_t    events;  // Events watched by epoll
+    std::string input;   // Received but not yet handled
+    std::string output;  // Not yet sent
+    bool        waiting; // True if a MOVE request is being searched
+    bool        closing; // True if the client has stopped sending, so the connection is closed once the output is sent
+};
+
+// The data used by a worker thread. A search is created for each variation the first time it is seen, and kept until room is
+// needed for another variation.
+class MoveServer::Worker
+{
+public:
+    // Constructor
+    explicit Worker(MoveServer & server)
+        : server_(server)
+        , uses_(0)
+    {
+    }
+
+    // Returns the best move in a job's state.
+    NimState::Move findBestMove(Job const & job)
+    {
+        std::string key = Position::rulesName(job.rules);
+        auto        it  = searches_.find(key);
+        if (it == searches_.end())
+        {
+            // The search used least recently is dropped first, so that its table is freed before another one is allocated
+            if (searches_.size() >= server_.settings_.maxVariations)
+            {
+                auto oldest = std::min_element(searches_.begin(),
+                                               searches_.end(),
+                                               [](auto const & a, auto const & b) { return a.second.used < b.second.used; });
+                searches_.erase(oldest);
+            }
+            NimSearch::Settings settings = server_.settings_.search;
+            if (server_.settings_.sharedTables)
+                settings.sharedTable = server_.sharedTable(job.rules);
+            it = searches_.emplace(key, Search{std::make_unique<NimSearch>(job.rules, settings), 0}).first;
+        }
+        it->second.used = ++uses_;
+        return it->second.search->findBestMove(job.state);
+    }
+
+private:
+    // The search of a variation
+    struct Search
+    {
+        std::unique_ptr<NimSearch> search; // The search
+        uint64_t                   used;   // Value of uses_ when it was last used
+    };
+
+    MoveServer &                  server_;   // The server, which holds the settings and the shared tables
+    std::map<std::string, Search> searches_; // The searches of the variations used most recently, by rules
+    uint64_t                      uses_;     // Number of searches made
+};
+
+// Returns the name of a player.
+static char const * playerName(NimState::PlayerId player)
+{
+    return (player == NimState::PlayerId::FIRST) ? "first" : "second";
+}
+
+// Returns the response for a game that is over.
+static std::string over(NimState const & state)
+{
+    assert(state.isGameOver());
+    return std::string("OVER ") + playerName(state.winner().value());
+}
+
+MoveServer::MoveServer(Settings const & settings)
+    : settings_(settings)
+    , listener_(-1)
+    , epoll_(-1)
+    , wakeup_(-1)
+    , port_(0)
+    , nextConnection_(WAKEUP_ID + 1)
+    , nextGame_(1)
+    , stopping_(false)
+{
+    assert(settings_.workers > 0);
+    assert(settings_.maxGames > 0 && settings_.maxVariations > 0);
+    for (int i = 0; i < settings_.workers; ++i)
+    {
+        workers_.push_back(std::make_unique<Worker>(*this));
+    }
+}
+
+MoveServer::~MoveServer()
+{
+    stop();
+    for (std::thread & thread : threads_)
+    {
+        thread.join();
+    }
+    for (auto & entry : connections_)
+    {
+        ::close(entry.second->fd);
+    }
+    if (listener_ >= 0)
+        ::close(listener_);
+    if (wakeup_ >= 0)
+        ::close(wakeup_);
+    if (epoll_ >= 0)
+        ::close(epoll_);
+    if (!settings_.unixPath.empty() && listener_ >= 0)
+        ::unlink(settings_.unixPath.c_str());
+}
+
+std::string MoveServer::listen()
+{
+    assert(listener_ < 0);
+
+    // Listen on a Unix socket or on the loopback address
+    if (!settings_.unixPath.empty())
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (settings_.unixPath.size() >= sizeof(address.sun_path))
+            return "The path of the socket is too long.";
+        std::strcpy(address.sun_path, settings_.unixPath.c_str());
+        ::unlink(address.sun_path);
+        listener_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listener_ < 0 || ::bind(listener_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+            return std::string("Unable to bind the socket: ") + std::strerror(errno);
+    }
+    else
+    {
+        sockaddr_in address{};
+        address.sin_family      = AF_INET;
+        address.sin_port        = htons(settings_.port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        listener_               = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int reuse               = 1;
+        if (listener_ < 0 || ::setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0 ||
+            ::bind(listener_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+            return std::string("Unable to bind the socket: ") + std::strerror(errno);
+
+        // The port is chosen by the system if it is 0
+        socklen_t length = sizeof(address);
+        ::getsockname(listener_, reinterpret_cast<sockaddr *>(&address), &length);
+        port_ = ntohs(address.sin_port);
+    }
+    if (::listen(listener_, BACKLOG) < 0)
+        return std::string("Unable to listen: ") + std::strerror(errno);
+
+    epoll_  = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeup_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_ < 0 || wakeup_ < 0)
+        return std::string("Unable to create the event loop: ") + std::strerror(errno);
+    epoll_event event{};
+    event.events   = EPOLLIN;
+    event.data.u64 = LISTENER_ID;
+    ::epoll_ctl(epoll_, EPOLL_CTL_ADD, listener_, &event);
+    event.data.u64 = WAKEUP_ID;
+    ::epoll_ctl(epoll_, EPOLL_CTL_ADD, wakeup_, &event);
+
+    for (auto & worker : workers_)
+    {
+        threads_.emplace_back(&MoveServer::work, this, std::ref(*worker));
+    }
+    return std::string();
+}
+
+void MoveServer::run()
+{
+    assert(listener_ >= 0);
+    epoll_event events[MAX_EVENTS];
+    while (!stopping_)
+    {
+        int count = ::epoll_wait(epoll_, events, MAX_EVENTS, -1);
+        if (count < 0 && errno != EINTR)
+            break;
+        for (int i = 0; i < count; ++i)
+        {
+            uint64_t id = events[i].data.u64;
+            if (id == LISTENER_ID)
+            {
+                accept();
+                continue;
+            }
+            if (id == WAKEUP_ID)
+            {
+                uint64_t signals;
+                while (::read(wakeup_, &signals, sizeof(signals)) > 0)
+                {
+                }
+                finishMoves();
+                continue;
+            }
+
+            // The connection may have been closed by an earlier event
+            auto it = connections_.find(id);
+            if (it == connections_.end())
+                continue;
+            Connection & connection = *it->second;
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+                close(connection);
+            else if (events[i].events & (EPOLLIN | EPOLLRDHUP))
+                receive(connection); // This also sends
+            else if (events[i].events & EPOLLOUT)
+                send(connection);
+        }
+    }
+}
+
+void MoveServer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_all();
+    wake();
+}
+
+void MoveServer::accept()
+{
+    while (true)
+    {
+        int fd = ::accept4(listener_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        // Responses are small and must not wait for more to be written
+        int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        uint64_t    id = nextConnection_++;
+        epoll_event event{};
+        event.events   = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = id;
+        ::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event);
+        connections_.emplace(id, std::make_unique<Connection>(Connection{fd, id, event.events, {}, {}, false, false}));
+    }
+}
+
+void MoveServer::receive(Connection & connection)
+{
+    char buffer[READ_SIZE];
+    while (true)
+    {
+        ssize_t count = ::read(connection.fd, buffer, sizeof(buffer));
+        if (count > 0)
+        {
+            connection.input.append(buffer, static_cast<size_t>(count));
+
+            // The requests received so far are handled before more is read. Only a client that keeps sending while its MOVE
+            // request is being searched can still have too much waiting, and it is cut off before it fills the server's memory.
+            if (connection.input.size() > MAX_INPUT)
+            {
+                handleRequests(connection);
+                if (connection.input.size() > MAX_INPUT)
+                {
+                    close(connection);
+                    return;
+                }
+            }
+            continue;
+        }
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (count < 0 && errno == EINTR)
+            continue;
+
+        // The client has closed the connection. The requests already received are still answered.
+        connection.closing = true;
+        break;
+    }
+
+    handleRequests(connection);
+    send(connection);
+}
+
+void MoveServer::handleRequests(Connection & connection)
+{
+    size_t start = 0;
+    while (!connection.waiting)
+    {
+        size_t end = connection.input.find('\n', start);
+        if (end == std::string::npos)
+            break;
+        std::string request = connection.input.substr(start, end - start);
+        start               = end + 1;
+        if (!request.empty() && request.back() == '\r')
+            request.pop_back();
+
+        std::optional<std::string> response = handle(connection, request);
+        if (response.has_value())
+        {
+            connection.output += *response;
+            connection.output += '\n';
+        }
+    }
+    connection.input.erase(0, start);
+
+    // A request that is too long is never going to end
+    if (connection.input.size() > MAX_LINE_SIZE && connection.input.find('\n') == std::string::npos)
+    {
+        connection.output += "ERR The request is too long.\n";
+        connection.input.clear();
+        connection.closing = true;
+    }
+}
+
+std::optional<std::string> MoveServer::handle(Connection & connection, std::string const & request)
+{
+    std::istringstream words(request);
+    std::string        command;
+    words >> command;
+
+    if (command == "NEW")
+    {
+        Position    position;
+        std::string error = Position::parse(words, position);
+        if (!error.empty())
+            return "ERR " + error;
+        if (games_.size() >= settings_.maxGames)
+            return std::string("ERR Too many games are open.");
+        NimState state(Board(position.heaps), position.rules, position.player, ZHash::Mode::CANONICAL);
+        uint64_t id = nextGame_++;
+        games_.emplace(id, Game{position.rules, state, 0});
+
+        // The entries of older games stay in the shared tables, but are replaced before the entries of newer ones
+        if (settings_.sharedTables && id % GAMES_PER_AGE == 0)
+        {
+            std::lock_guard<std::mutex> lock(tablesMutex_);
+            for (auto & table : sharedTables_)
+            {
+                table.second->age();
+            }
+        }
+        return "OK " + std::to_string(id);
+    }
+
+    // Every other request names a game
+    uint64_t id;
+    if (!(words >> id))
+        return "ERR " + (command.empty() ? std::string("The request is empty.") : "Unknown request " + command + ".");
+    auto it = games_.find(id);
+    if (it == games_.end())
+        return "ERR There is no game " + std::to_string(id) + ".";
+    Game & game = it->second;
+
+    if (command == "PLAY")
+    {
+        int heap;
+        int n;
+        if (!(words >> heap >> n))
+            return "ERR The move must be a heap and a number of objects.";
+        Board const & board = game.state.board();
+        if (game.state.isGameOver())
+            return "ERR The game is over.";
+        if (heap < 0 || heap >= static_cast<int>(board.size()))
+            return "ERR There is no heap " + std::to_string(heap) + ".";
+        if (n > board.heap(heap) || !game.rules.allows(n))
+            return "ERR Unable to remove " + std::to_string(n) + " from heap " + std::to_string(heap) + ".";
+        game.state.move(heap, n);
+        ++game.version;
+        return std::string("OK");
+    }
+    if (command == "MOVE")
+    {
+        if (game.state.isGameOver())
+            return "ERR The game is over.";
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(Job{connection.id, id, game.version, game.rules, game.state});
+        }
+        ready_.notify_one();
+        connection.waiting = true;
+        return std::nullopt;
+    }
+    if (command == "STATE")
+    {
+        if (game.state.isGameOver())
+            return over(game.state);
+        std::string response = std::string("STATE ") + playerName(game.state.whoseTurn());
+        for (int n : game.state.board())
+        {
+            response += ' ';
+            response += std::to_string(n);
+        }
+        return response;
+    }
+    if (command == "END")
+    {
+        games_.erase(it);
+        return std::string("OK");
+    }
+    return "ERR Unknown request " + command + ".";
+}
+
+void MoveServer::send(Connection & connection)
+{
+    size_t sent = 0;
+    while (sent < connection.output.size())
+    {
+        ssize_t count = ::send(connection.fd, connection.output.data() + sent, connection.output.size() - sent, MSG_NOSIGNAL);
+        if (count > 0)
+        {
+            sent += static_cast<size_t>(count);
+            continue;
+        }
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        close(connection);
+        return;
+    }
+    connection.output.erase(0, sent);
+
+    if (connection.output.empty() && connection.closing && !connection.waiting)
+    {
+        close(connection);
+        return;
+    }
+
+    // Watch for input until the client stops sending, and for the socket to become writable only while there is output waiting
+    uint32_t events = connection.closing ? 0u : uint32_t(EPOLLIN | EPOLLRDHUP);
+    if (!connection.output.empty())
+        events |= EPOLLOUT;
+    if (events != connection.events)
+    {
+        epoll_event event{};
+        event.events   = events;
+        event.data.u64 = connection.id;
+        ::epoll_ctl(epoll_, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.events = events;
+    }
+}
+
+void MoveServer::close(Connection & connection)
+{
+    // A MOVE request that is being searched is still applied to its game, but the response is dropped
+    ::epoll_ctl(epoll_, EPOLL_CTL_DEL, connection.fd, nullptr);
+    ::close(connection.fd);
+    connections_.erase(connection.id);
+}
+
+void MoveServer::finishMoves()
+{
+    std::vector<Result> results;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results.swap(results_);
+    }
+
+    for (Result const & result : results)
+    {
+        // The move is only made if the game hasn't changed since it was searched
+        std::string response;
+        auto        game = games_.find(result.game);
+        if (game == games_.end())
+        {
+            response = "ERR The game has ended.";
+        }
+        else if (game->second.version != result.version)
+        {
+            response = "ERR The game has changed.";
+        }
+        else
+        {
+            NimState & state = game->second.state;
+            state.move(result.move.i, result.move.n);
+            ++game->second.version;
+            response = "MOVE " + std::to_string(result.move.i) + " " + std::to_string(result.move.n);
+            if (state.isGameOver())
+                response += " " + over(state);
+        }
+
+        auto connection = connections_.find(result.connection);
+        if (connection == connections_.end())
+            continue;
+        Connection & c = *connection->second;
+        c.output += response;
+        c.output += '\n';
+        c.waiting = false;
+        handleRequests(c);
+        send(c);
+    }
+}
+
+void MoveServer::work(Worker & worker)
+{
+    while (true)
+    {
+        std::optional<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (stopping_)
+                return;
+            job.emplace(std::move(jobs_.front()));
+            jobs_.pop_front();
+        }
+
+        NimState::Move move = worker.findBestMove(*job);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            results_.push_back(Result{job->connection, job->game, job->version, move});
+        }
+        wake();
+    }
+}
+
+std::shared_ptr<SharedTranspositionTable> MoveServer::sharedTable(Rules const & rules)
+{
+    std::lock_guard<std::mutex>                 lock(tablesMutex_);
+    std::shared_ptr<SharedTranspositionTable> & table = sharedTables_[Position::rulesName(rules)];
+    if (!table)
+    {
+        // Tables that no search uses any more are only kept while there are few of them
+        for (auto it = sharedTables_.begin(); it != sharedTables_.end() && sharedTables_.size() > settings_.maxVariations;)
+        {
+            if (it->second.use_count() == 1)
+                it = sharedTables_.erase(it);
+            else
+                ++it;
+        }
+        size_t bytes = settings_.search.transpositionTableMegabytes * 1024 * 1024 * settings_.workers;
+        table        = std::make_shared<SharedTranspositionTable>(bytes, settings_.search.hugePages);
+    }
+    return table;
+}
+
+void MoveServer::wake()
+{
+    if (wakeup_ < 0)
+        return;
+    uint64_t one     = 1;
+    ssize_t  written = ::write(wakeup_, &one, sizeof(one));
+    (void)written;
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "ComputerPlayer/NimSearch.h"
+#include "ComputerPlayer/Position.h"
+#include "ComputerPlayer/SharedTranspositionTable.h"
+#include "NimState/NimState.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// A server that holds many games at once and makes the computer's moves in them, for clients connected over a local socket.
+//
+// The server listens on a TCP port or a Unix socket. A client sends requests, one per line, and receives one response line for
+// each request, in the same order. Any connection can use any game.
+//
+//   NEW <position>           Starts a game from a Position, e.g. "NEW normal first 1 3 5 7". Response: OK <game>
+//   PLAY <game> <heap> <n>   Removes n objects from a heap for the player to move. Response: OK
+//   MOVE <game>              Makes the computer's move for the player to move. Response: MOVE <heap> <n>, followed by
+//                            OVER <winner> if the move ends the game
+//   STATE <game>             Response: STATE <player to move> <heaps...>, or OVER <winner> if the game is over
+//   END <game>               Ends a game. Response: OK
+//
+// Any request that fails gets the response ERR <message>. Heaps are numbered from 0. NEW fails if the maximum number of games
+// are open.
+//
+// A single thread handles all the connections with epoll, and every request except MOVE is answered immediately. MOVE requests
+// are searched by a pool of worker threads. Each worker keeps an in-place search for each variation, so its transposition table
+// is allocated once and not once per game. With shared tables, the workers' searches of a variation all use one
+// SharedTranspositionTable instead, as large as all their own tables would be, which is aged every 64 games. While a
+// connection's MOVE request is being searched, its later requests wait, and a connection that sends more than 64 KB of
+// requests in that time is closed.
+//
+// The memory used doesn't grow with the number of variations that clients ask for. A worker keeps searches for a limited number
+// of variations, and drops the one used least recently to make room for another. Shared tables that no search uses are dropped
+// once there are too many.
+class MoveServer
+{
+public:
+    // Settings for the server
+    struct Settings
+    {
+        std::string         unixPath;    // Path of the Unix socket to listen on, or empty to listen on TCP
+        uint16_t            port         = 0;     // TCP port to listen on, on the loopback address (0 means any free port)
+        int                 workers       = 1;      // Number of threads searching for moves
+        bool                sharedTables  = false;  // The workers share one transposition table for each variation
+        size_t              maxGames      = 100000; // Most games open at once
+        size_t              maxVariations = 16;     // Most variations a worker keeps a search for, or kept with an idle table
+        NimSearch::Settings search;                 // Settings for each search
+    };
+
+    // Constructor
+    explicit MoveServer(Settings const & settings);
+
+    // Destructor
+    ~MoveServer();
+
+    // Starts listening. Returns an error message, or an empty string if the server is listening.
+    std::string listen();
+
+    // Handles connections until stop() is called. listen() must have succeeded.
+    void run();
+
+    // Makes run() return. May be called from any thread.
+    void stop();
+
+    // Returns the TCP port the server is listening on (0 if it is listening on a Unix socket).
+    uint16_t port() const { return port_; }
+
+private:
+    struct Connection; // A client connection
+    class Worker;      // The data used by a worker thread
+
+    // A game in progress
+    struct Game
+    {
+        Rules    rules;   // Rules of the game
+        NimState state;   // Current state
+        uint64_t version; // Number of moves made, used to detect a move made while the computer was searching
+    };
+
+    // A MOVE request waiting for a worker
+    struct Job
+    {
+        uint64_t connection; // Id of the connection that made the request
+        uint64_t game;       // Id of the game
+        uint64_t version;    // Version of the game searched
+        Rules    rules;      // Rules of the game
+        NimState state;      // State to search
+    };
+
+    // The move found by a worker
+    struct Result
+    {
+        uint64_t       connection; // Id of the connection that made the request
+        uint64_t       game;       // Id of the game
+        uint64_t       version;    // Version of the game searched
+        NimState::Move move;       // Move found
+    };
+
+    // Accepts every pending connection.
+    void accept();
+
+    // Reads what a client has sent and handles the complete requests.
+    void receive(Connection & connection);
+
+    // Handles the requests of a connection until there are none left or it waits for a move.
+    void handleRequests(Connection & connection);
+
+    // Handles a request. Returns the response, or std::nullopt if the request was given to a worker.
+    std::optional<std::string> handle(Connection & connection, std::string const & request);
+
+    // Writes as much of the pending output of a connection as the socket accepts.
+    void send(Connection & connection);
+
+    // Closes a connection.
+    void close(Connection & connection);
+
+    // Applies the moves found by the workers and answers the requests.
+    void finishMoves();
+
+    // Searches for moves until the server stops.
+    void work(Worker & worker);
+
+    // Wakes up the thread running the event loop.
+    void wake();
+
+    // Returns the table shared by the searches of a variation, creating it if needed. May be called from any thread.
+    std::shared_ptr<SharedTranspositionTable> sharedTable(Rules const & rules);
+
+    Settings                                                  settings_;       // Settings for the server
+    int                                                       listener_;       // Listening socket
+    int                                                       epoll_;          // epoll instance
+    int                                                       wakeup_;         // eventfd used to wake up the event loop
+    uint16_t                                                  port_;           // TCP port, if listening on TCP
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections_;    // Open connections, by id
+    std::unordered_map<uint64_t, Game>                        games_;          // Games in progress, by id
+    uint64_t                                                  nextConnection_; // Id of the next connection
+    uint64_t                                                  nextGame_;       // Id of the next game
+    std::atomic<bool>                                         stopping_;       // True if the server is stopping
+
+    std::vector<std::thread>             threads_; // Worker threads
+    std::vector<std::unique_ptr<Worker>> workers_; // Data for each worker thread
+    std::mutex                           mutex_;   // Guards jobs_ and results_
+    std::condition_variable              ready_;   // Signaled when a job is queued or the server stops
+    std::deque<Job>                      jobs_;    // MOVE requests waiting for a worker
+    std::vector<Result>                  results_; // Moves found by the workers and not yet applied
+
+    std::mutex                                                       tablesMutex_;  // Guards sharedTables_
+    std::map<std::string, std::shared_ptr<SharedTranspositionTable>> sharedTables_; // Tables shared by the workers, by rules
+};
@@ -0,0 +1,370 @@
+#include "gtest/gtest.h"
+
+#include "ComputerPlayer/NimSearch.h"
+#include "Server/MoveServer.h"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+
+// A server running on its own thread, stopped when this goes out of scope
+class RunningServer
+{
+public:
+    // Constructor
+    explicit RunningServer(MoveServer::Settings const & settings)
+        : server_(settings)
+    {
+        error_ = server_.listen();
+        if (error_.empty())
+            thread_ = std::thread(&MoveServer::run, &server_);
+    }
+
+    // Destructor
+    ~RunningServer()
+    {
+        server_.stop();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    std::string const & error() const { return error_; }
+    uint16_t            port() const { return server_.port(); }
+
+private:
+    MoveServer  server_;
+    std::string error_;
+    std::thread thread_;
+};
+
+// A blocking connection to a server
+class Client
+{
+public:
+    // Constructor, connecting over TCP
+    explicit Client(uint16_t port)
+    {
+        sockaddr_in address{};
+        address.sin_family      = AF_INET;
+        address.sin_port        = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd_                     = ::socket(AF_INET, SOCK_STREAM, 0);
+        connected_              = ::connect(fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+    }
+
+    // Constructor, connecting to a Unix socket
+    explicit Client(std::string const & path)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        fd_        = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        connected_ = ::connect(fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+    }
+
+    // Destructor
+    ~Client() { ::close(fd_); }
+
+    bool connected() const { return connected_; }
+
+    // Sends text without waiting for a response.
+    void write(std::string const & text) { ASSERT_EQ(::send(fd_, text.data(), text.size(), 0), text.size()); }
+
+    // Sends text until it has all been sent or the server closes the connection.
+    void flood(std::string const & text)
+    {
+        size_t  sent  = 0;
+        ssize_t count = 0;
+        while (sent < text.size() && (count = ::send(fd_, text.data() + sent, text.size() - sent, MSG_NOSIGNAL)) > 0)
+        {
+            sent += static_cast<size_t>(count);
+        }
+    }
+
+    // Returns the next line received, or an empty string if the connection was closed.
+    std::string readLine()
+    {
+        size_t end;
+        while ((end = input_.find('\n')) == std::string::npos)
+        {
+            char    buffer[1024];
+            ssize_t count = ::read(fd_, buffer, sizeof(buffer));
+            if (count <= 0)
+                return std::string();
+            input_.append(buffer, static_cast<size_t>(count));
+        }
+        std::string line = input_.substr(0, end);
+        input_.erase(0, end + 1);
+        return line;
+    }
+
+    // Sends a request and returns its response.
+    std::string request(std::string const & line)
+    {
+        write(line + '\n');
+        return readLine();
+    }
+
+private:
+    int         fd_;        // Socket
+    bool        connected_; // True if the connection succeeded
+    std::string input_;     // Received but not yet returned
+};
+
+// Returns the settings of a test server, listening on any free port
+MoveServer::Settings testSettings(int workers)
+{
+    MoveServer::Settings settings;
+    settings.workers = workers;
+    settings.search  = NimSearch::Settings{2};
+    return settings;
+}
+
+} // anonymous namespace
+
+namespace Nim
+{
+
+TEST(MoveServer, Constructor)
+{
+    // Nothing to test here, just make sure the constructor and destructor execute without error
+    ASSERT_NO_THROW(MoveServer(testSettings(1)));
+    ASSERT_NO_THROW(MoveServer(testSettings(4)));
+}
+
+TEST(MoveServer, Listen)
+{
+    MoveServer server(testSettings(1));
+    EXPECT_EQ(server.listen(), "");
+    EXPECT_NE(server.port(), 0);
+}
+
+TEST(MoveServer, Requests)
+{
+    RunningServer server(testSettings(1));
+    ASSERT_EQ(server.error(), "");
+    Client client(server.port());
+    ASSERT_TRUE(client.connected());
+
+    // The only winning move takes 1 from the heap of 4
+    EXPECT_EQ(client.request("NEW normal second 1 2 4"), "OK 1");
+    EXPECT_EQ(client.request("STATE 1"), "STATE second 1 2 4");
+    EXPECT_EQ(client.request("MOVE 1"), "MOVE 2 1");
+    EXPECT_EQ(client.request("STATE 1"), "STATE first 1 2 3");
+    EXPECT_EQ(client.request("PLAY 1 0 1"), "OK");
+    EXPECT_EQ(client.request("STATE 1"), "STATE second 0 2 3");
+
+    // Finish the game. The first player takes the last object.
+    EXPECT_EQ(client.request("PLAY 1 1 2"), "OK");
+    EXPECT_EQ(client.request("PLAY 1 2 3"), "OK");
+    EXPECT_EQ(client.request("STATE 1"), "OVER first");
+    EXPECT_EQ(client.request("END 1"), "OK");
+    EXPECT_EQ(client.request("STATE 1"), "ERR There is no game 1.");
+
+    // Each game gets its own id
+    EXPECT_EQ(client.request("NEW misere first 1"), "OK 2");
+    EXPECT_EQ(client.request("MOVE 2"), "MOVE 0 1 OVER second");
+}
+
+TEST(MoveServer, Requests_Errors)
+{
+    RunningServer server(testSettings(1));
+    ASSERT_EQ(server.error(), "");
+    Client client(server.port());
+    ASSERT_TRUE(client.connected());
+
+    EXPECT_EQ(client.request(""), "ERR The request is empty.");
+    EXPECT_EQ(client.request("JUMP"), "ERR Unknown request JUMP.");
+    EXPECT_EQ(client.request("MOVE 7"), "ERR There is no game 7.");
+    EXPECT_EQ(client.request("NEW chess first 1 2").compare(0, 4, "ERR "), 0);
+    EXPECT_EQ(client.request("NEW normal first 3 3"), "OK 1");
+    EXPECT_EQ(client.request("JUMP 1"), "ERR Unknown request JUMP.");
+    EXPECT_EQ(client.request("PLAY 1"), "ERR The move must be a heap and a number of objects.");
+    EXPECT_EQ(client.request("PLAY 1 2 1"), "ERR There is no heap 2.");
+    EXPECT_EQ(client.request("PLAY 1 0 4"), "ERR Unable to remove 4 from heap 0.");
+    EXPECT_EQ(client.request("PLAY 1 0 3"), "OK");
+    EXPECT_EQ(client.request("PLAY 1 1 3"), "OK");
+    EXPECT_EQ(client.request("MOVE 1"), "ERR The game is over.");
+    EXPECT_EQ(client.request("PLAY 1 0 1"), "ERR The game is over.");
+
+    // Only the numbers in the subtraction set can be removed
+    EXPECT_EQ(client.request("NEW subtraction:{2,5,7} first 12"), "OK 2");
+    EXPECT_EQ(client.request("PLAY 2 0 1"), "ERR Unable to remove 1 from heap 0.");
+    EXPECT_EQ(client.request("PLAY 2 0 3"), "ERR Unable to remove 3 from heap 0.");
+    EXPECT_EQ(client.request("PLAY 2 0 5"), "OK");
+
+    // A request that never ends is rejected and the connection is closed
+    client.write(std::string(5000, 'x'));
+    EXPECT_EQ(client.readLine(), "ERR The request is too long.");
+    EXPECT_EQ(client.readLine(), "");
+}
+
+TEST(MoveServer, Requests_Pipelined)
+{
+    // Requests sent all at once are answered in order, even when they wait for a move
+    RunningServer server(testSettings(2));
+    ASSERT_EQ(server.error(), "");
+    Client client(server.port());
+    ASSERT_TRUE(client.connected());
+
+    client.write("NEW subtraction:3 first 21\nMOVE 1\nSTATE 1\nMOVE 1\nSTATE 1\n");
+    EXPECT_EQ(client.readLine(), "OK 1");
+    EXPECT_EQ(client.readLine(), "MOVE 0 1");
+    EXPECT_EQ(client.readLine(), "STATE second 20");
+    std::string move = client.readLine();
+    EXPECT_EQ(move.compare(0, 6, "MOVE 0"), 0) << move;
+    EXPECT_EQ(client.readLine().compare(0, 12, "STATE first "), 0);
+}
+
+TEST(MoveServer, Requests_Flood)
+{
+    // A client that keeps sending while its MOVE request is searched is cut off. The search runs for a second, which is much
+    // longer than sending a megabyte takes.
+    MoveServer::Settings settings = testSettings(1);
+    settings.search               = NimSearch::Settings{NimSearch::MAX_DEPTH};
+    settings.search.timeLimit     = std::chrono::milliseconds(1000);
+    RunningServer server(settings);
+    ASSERT_EQ(server.error(), "");
+    Client client(server.port());
+    ASSERT_TRUE(client.connected());
+
+    EXPECT_EQ(client.request("NEW normal first 20 21 22 23 24 25 26 27"), "OK 1");
+    std::string requests = "MOVE 1\n";
+    while (requests.size() < 1024 * 1024)
+    {
+        requests += "STATE 1\n";
+    }
+    client.flood(requests);
+
+    // The connection is closed without the response to the MOVE request
+    EXPECT_EQ(client.readLine(), "");
+}
+
+TEST(MoveServer, Connections)
+{
+    // Many clients play their own games at the same time, and any connection can use any game
+    RunningServer server(testSettings(3));
+    ASSERT_EQ(server.error(), "");
+
+    size_t constexpr         COUNT = 8;
+    std::vector<std::thread> clients;
+    std::vector<int>         games(COUNT, 0);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        clients.emplace_back(
+            [&, i]()
+            {
+                Client client(server.port());
+                if (!client.connected())
+                    return;
+                for (int g = 0; g < 10; ++g)
+                {
+                    std::string response = client.request("NEW misere first 1 3 5 7 9");
+                    if (response.compare(0, 3, "OK ") != 0)
+                        return;
+                    std::string id = response.substr(3);
+                    do
+                    {
+                        response = client.request("MOVE " + id);
+                    } while (response.compare(0, 5, "MOVE ") == 0 && response.find(" OVER ") == std::string::npos);
+                    if (response.find(" OVER first") == std::string::npos || client.request("END " + id) != "OK")
+                        return;
+                    ++games[i];
+                }
+            });
+    }
+    for (std::thread & client : clients)
+    {
+        client.join();
+    }
+
+    // The first player has a winning position, and the computer plays perfectly for both players
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        EXPECT_EQ(games[i], 10) << i;
+    }
+
+    Client first(server.port());
+    Client second(server.port());
+    std::string id = first.request("NEW normal first 1 2").substr(3);
+    EXPECT_EQ(second.request("STATE " + id), "STATE first 1 2");
+}
+
+TEST(MoveServer, SharedTables)
+{
+    // With shared tables, each variation gets its own table, so the moves are the same
+    MoveServer::Settings settings = testSettings(2);
+    settings.sharedTables         = true;
+    RunningServer server(settings);
+    ASSERT_EQ(server.error(), "");
+    Client client(server.port());
+    ASSERT_TRUE(client.connected());
+
+    EXPECT_EQ(client.request("NEW normal second 1 2 4"), "OK 1");
+    EXPECT_EQ(client.request("NEW subtraction:3 first 21"), "OK 2");
+    EXPECT_EQ(client.request("NEW misere first 2 1 1"), "OK 3");
+    EXPECT_EQ(client.request("NEW normal first 1 2 4"), "OK 4");
+    EXPECT_EQ(client.request("MOVE 1"), "MOVE 2 1");
+    EXPECT_EQ(client.request("MOVE 2"), "MOVE 0 1");
+    EXPECT_EQ(client.request("MOVE 3"), "MOVE 0 1");
+    EXPECT_EQ(client.request("MOVE 4"), "MOVE 2 1");
+}
+
+TEST(MoveServer, Limits)
+{
+    // Many variations are played with a few searches and tables at a time, and NEW fails while too many games are open
+    MoveServer::Settings settings = testSettings(2);
+    settings.sharedTables         = true;
+    settings.maxGames             = 40;
+    settings.maxVariations        = 2;
+    RunningServer server(settings);
+    ASSERT_EQ(server.error(), "");
+    Client client(server.port());
+    ASSERT_TRUE(client.connected());
+
+    for (int k = 2; k < 34; ++k)
+    {
+        std::string id = std::to_string(k - 1);
+        EXPECT_EQ(client.request("NEW subtraction:{1," + std::to_string(k) + "} first 20"), "OK " + id);
+        std::string move = client.request("MOVE " + id);
+        EXPECT_EQ(move.compare(0, 7, "MOVE 0 "), 0) << move;
+    }
+    for (int g = 33; g <= 40; ++g)
+    {
+        EXPECT_EQ(client.request("NEW normal first 1 2"), "OK " + std::to_string(g));
+    }
+    EXPECT_EQ(client.request("NEW normal first 1 2"), "ERR Too many games are open.");
+    EXPECT_EQ(client.request("END 1"), "OK");
+    EXPECT_EQ(client.request("NEW normal first 1 2"), "OK 41");
+}
+
+TEST(MoveServer, UnixSocket)
+{
+    MoveServer::Settings settings = testSettings(1);
+    settings.unixPath             = "/tmp/test-MoveServer-" + std::to_string(::getpid()) + ".sock";
+    {
+        RunningServer server(settings);
+        ASSERT_EQ(server.error(), "");
+        EXPECT_EQ(server.port(), 0);
+        Client client(settings.unixPath);
+        ASSERT_TRUE(client.connected());
+        EXPECT_EQ(client.request("NEW normal second 1 2 4"), "OK 1");
+        EXPECT_EQ(client.request("MOVE 1"), "MOVE 2 1");
+    }
+
+    // The socket is removed when the server is destroyed
+    EXPECT_NE(::access(settings.unixPath.c_str(), F_OK), 0);
+}
+
+} // namespace Nim
@@ -0,0 +1,236 @@
+#include <CLI/CLI.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+
+// Where the server is listening
+struct Address
+{
+    std::string unixPath; // Path of the server's Unix socket, or empty if it is listening on TCP
+    uint16_t    port;     // TCP port of the server, on the loopback address
+};
+
+// Results of the games played over one connection
+struct Results
+{
+    int                   games    = 0; // Number of games played
+    uint64_t              requests = 0; // Number of requests made
+    int                   errors   = 0; // Number of error responses and failed connections
+    std::vector<uint32_t> latencies;    // Time taken by each request, in microseconds
+};
+
+// A blocking connection to the server that sends a request and waits for its response
+class Client
+{
+public:
+    // Constructor
+    explicit Client(Address const & address)
+        : fd_(-1)
+    {
+        if (!address.unixPath.empty())
+        {
+            sockaddr_un a{};
+            a.sun_family = AF_UNIX;
+            std::strncpy(a.sun_path, address.unixPath.c_str(), sizeof(a.sun_path) - 1);
+            fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd_ >= 0 && ::connect(fd_, reinterpret_cast<sockaddr *>(&a), sizeof(a)) < 0)
+                disconnect();
+        }
+        else
+        {
+            sockaddr_in a{};
+            a.sin_family      = AF_INET;
+            a.sin_port        = htons(address.port);
+            a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            fd_               = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd_ >= 0 && ::connect(fd_, reinterpret_cast<sockaddr *>(&a), sizeof(a)) < 0)
+                disconnect();
+            int noDelay = 1;
+            if (fd_ >= 0)
+                ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+    }
+
+    // Destructor
+    ~Client() { disconnect(); }
+
+    Client(Client const &)             = delete;
+    Client & operator=(Client const &) = delete;
+
+    // Returns true if the connection is open.
+    bool connected() const { return fd_ >= 0; }
+
+    // Sends a request and returns the response, or an empty string if the connection failed.
+    std::string request(std::string const & line)
+    {
+        std::string out = line + '\n';
+        for (size_t sent = 0; sent < out.size();)
+        {
+            ssize_t count = ::send(fd_, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+            if (count <= 0)
+                return std::string();
+            sent += static_cast<size_t>(count);
+        }
+
+        size_t end;
+        while ((end = input_.find('\n')) == std::string::npos)
+        {
+            char    buffer[4096];
+            ssize_t count = ::read(fd_, buffer, sizeof(buffer));
+            if (count <= 0)
+                return std::string();
+            input_.append(buffer, static_cast<size_t>(count));
+        }
+        std::string response = input_.substr(0, end);
+        input_.erase(0, end + 1);
+        return response;
+    }
+
+private:
+    // Closes the connection.
+    void disconnect()
+    {
+        if (fd_ >= 0)
+            ::close(fd_);
+        fd_ = -1;
+    }
+
+    int         fd_;    // Socket, or -1 if not connected
+    std::string input_; // Received but not yet returned
+};
+
+// Plays games until there are none left, taking the next unplayed one each time. The server makes the moves of both players.
+void playGames(Address const & address, std::string const & position, std::atomic<int> & remaining, Results & results)
+{
+    Client client(address);
+    if (!client.connected())
+    {
+        ++results.errors;
+        return;
+    }
+
+    // Sends a request, recording its latency. Returns the response, or an empty string if it is an error.
+    auto request = [&](std::string const & line)
+    {
+        auto        start    = std::chrono::steady_clock::now();
+        std::string response = client.request(line);
+        auto        elapsed  = std::chrono::steady_clock::now() - start;
+        results.latencies.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+        ++results.requests;
+        if (response.empty() || response.compare(0, 4, "ERR ") == 0)
+        {
+            ++results.errors;
+            return std::string();
+        }
+        return response;
+    };
+
+    while (remaining-- > 0)
+    {
+        std::string response = request("NEW " + position);
+        if (response.empty())
+            return;
+        std::string game = response.substr(3); // "OK <game>"
+
+        do
+        {
+            response = request("MOVE " + game);
+        } while (!response.empty() && response.find(" OVER ") == std::string::npos);
+        if (response.empty() || request("END " + game).empty())
+            return;
+        ++results.games;
+    }
+}
+
+// Returns the given percentile of a sorted list of values
+uint32_t percentile(std::vector<uint32_t> const & sorted, double p)
+{
+    assert(!sorted.empty());
+    size_t i = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+} // anonymous namespace
+
+int main(int argc, char * argv[])
+{
+    Address     address{std::string(), 7777};
+    int         connections = 16;   // Number of connections, each playing one game at a time
+    int         games       = 1000; // Number of games to play
+    std::string position    = "misere first 1 3 5 7 9";
+
+    {
+        CLI::App cli;
+        cli.add_option("--port, -p", address.port, "TCP port of the server, on the loopback address (default 7777)");
+        cli.add_option("--unix", address.unixPath, "Connect to the server's Unix socket at this path instead of a TCP port");
+        cli.add_option("--connections, -c", connections, "Number of connections to the server (default 16)")
+            ->check(CLI::Range(1, 65536));
+        cli.add_option("--games, -n", games, "Number of games to play (default 1000)")->check(CLI::Range(1, 100000000));
+        cli.add_option("--position", position, "Starting position of each game (default \"misere first 1 3 5 7 9\")");
+
+        cli.description("Play games of Nim on a move server over many connections and report the throughput and latency.");
+        CLI11_PARSE(cli, argc, argv);
+    }
+
+    std::atomic<int>     remaining(games);
+    std::vector<Results> results(std::min(connections, games));
+
+    auto                     start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(results.size());
+    for (auto & r : results)
+    {
+        threads.emplace_back(playGames, std::cref(address), std::cref(position), std::ref(remaining), std::ref(r));
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Combine the results of all the connections
+    Results total;
+    for (auto const & r : results)
+    {
+        total.games += r.games;
+        total.requests += r.requests;
+        total.errors += r.errors;
+        total.latencies.insert(total.latencies.end(), r.latencies.begin(), r.latencies.end());
+    }
+    std::sort(total.latencies.begin(), total.latencies.end());
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Games:                " << total.games << std::endl;
+    std::cout << "Requests:             " << total.requests << std::endl;
+    std::cout << "Errors:               " << total.errors << std::endl;
+    std::cout << "Connections:          " << results.size() << std::endl;
+    std::cout << "Elapsed:              " << std::setprecision(3) << seconds << " s" << std::setprecision(1) << std::endl;
+    std::cout << "Requests/second:      " << total.requests / seconds << std::endl;
+    if (!total.latencies.empty())
+    {
+        std::cout << "Request latency (us): p50 " << percentile(total.latencies, 50) << ", p90 "
+                  << percentile(total.latencies, 90) << ", p99 " << percentile(total.latencies, 99) << ", p99.9 "
+                  << percentile(total.latencies, 99.9) << ", max " << total.latencies.back() << std::endl;
+    }
+
+    return (total.errors == 0) ? 0 : 1;
+}
@@ -1,23 +1,49 @@
+#include "Components/BigBoard.h"
 #include "Components/Board.h"
+#include "Components/OctalGame.h"
 #include "Components/Rules.h"
+#include "ComputerPlayer/BatchAnalyzer.h"
+#include "ComputerPlayer/BigNimSolver.h"
 #include "ComputerPlayer/ComputerPlayer.h"
+#include "ComputerPlayer/Tablebase.h"
 #include "HumanPlayer/HumanPlayer.h"
 #include "NimState/NimState.h"
 
 #include <CLI/CLI.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
 
 using namespace GamePlayer;
 
 static void displayBoard(const Board & board, Rules const & rules);
+static int  analyzeBigBoard(std::string const & path, Rules const & rules);
+static int  analyzeBatch(std::string const & path, NimSearch::Settings const & settings, int jobs);
 
 int main(int argc, char * argv[])
 {
     bool                humanGoesFirst = true; // Human player goes first by default
     std::vector<int8_t> initialConfiguration;
     Rules               rules;
+    bool                useSolver = false; // The computer searches the game tree by default
+    int                 threads   = 0;     // The computer uses the game tree instead of the in-place search by default
+    int                 timeLimit = 0;     // The computer's moves have no time limit by default
+    int                 tableSize = 0;     // The transposition table has the default size by default
+    bool                hugePages = false; // The transposition table uses ordinary pages by default
+    std::string         telemetry;         // No telemetry is written by default
+    std::string         tablebase;         // The computer doesn't use a tablebase by default
+    std::string         snapshot;          // The computer's transposition table starts empty and is not saved by default
+    std::string         big;               // A game is played by default, instead of analyzing a Big Nim board
+    std::string         batch;             // A game is played by default, instead of analyzing a list of positions
+    int                 jobs  = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    int                 depth = 2; // Depth of the search of each position analyzed in a batch
 
     {
         CLI::App            cli;
@@ -27,6 +53,9 @@ int main(int argc, char * argv[])
         bool                normal      = false;
         bool                subtraction = false;
         std::vector<int8_t> initial;
+        std::vector<int>    subtractionSet;
+        std::vector<int>    limits;
+        std::string         octal;
 
         auto * order = cli.add_option_group("Order of play", "Choose who goes first");
         order->add_flag("--first, -f", first, "You go first. (default)");
@@ -41,23 +70,116 @@ int main(int argc, char * argv[])
         variations->add_flag("--normal", normal, "")
             ->description("In the normal variation, you win by taking the last object. The default setup for this variation is "
                           "1 3 5 7 9.");
-        variations->add_flag("--subtraction", subtraction, "")
-            ->description("In the subtraction variation, you can remove a limited number of objects from a single heap on your "
-                          "turn. The player who removes the last object wins. The default setup is 21 4 and can be changed with "
-                          "--initial.");
+        auto * subtractionFlag = variations->add_flag("--subtraction", subtraction, "");
+        subtractionFlag
+            ->description("In the subtraction variation, you can remove a limited number of objects from one heap on your "
+                          "turn. The player who removes the last object wins. The default setup is a single heap, 21 4, and can "
+                          "be changed with --initial.");
+        variations->add_option("--octal", octal, "")
+            ->description("In an octal game, given by a code such as 0.77 (Kayles) or 0.137 (Dawson's chess), digit k of the code "
+                          "says whether a move that removes k objects from a heap may leave nothing (1), one heap (2), or two "
+                          "heaps (4), or any sum of these. You split a heap by also entering the number of objects to move to a "
+                          "new heap. The player who makes the last move wins. The default setup is a single heap of 20, and can "
+                          "be changed with --initial.");
 
         variations->require_option(0, 1);
 
+        auto * subtractionSetOption = cli.add_option("--subtraction-set", subtractionSet, "");
+        subtractionSetOption
+            ->description("In the subtraction variation, the numbers of objects that can be removed on a turn, such as 1 3 4, "
+                          "instead of 1 through a maximum. The setup is then a list of heap sizes.")
+            ->needs(subtractionFlag);
+
+        cli.add_option("--limits", limits, "")
+            ->description("In the subtraction variation, the maximum number of objects that can be removed from each heap. A "
+                          "single number applies to every heap, and otherwise there is one for each heap, such as 4 3 7. The "
+                          "setup is then a list of heap sizes.")
+            ->needs(subtractionFlag)
+            ->excludes(subtractionSetOption);
+
         cli.add_option("--initial, -i", initial, "Initial configuration")
             ->description("For the misre and normal variations, a list of 1 to 5 numbers with values between 1 and 9 is "
                           "provided. These values describe the number of objects in each heap. For the subtraction variation, "
-                          "the size of the heap followed the maximum number of objects that can be removed is provided.");
+                          "the size of the heap followed the maximum number of objects that can be removed is provided, unless "
+                          "--subtraction-set or --limits is given. For octal games, a list of heap sizes is provided.");
+
+        auto * solver = cli.add_flag("--solver", useSolver, "");
+        solver
+            ->description("The computer computes its moves directly from the nim-sum instead of searching the game tree. It plays "
+                          "perfectly and responds instantly.");
+
+        cli.add_option("--threads", threads, "")
+            ->description("The computer searches with the in-place search engine, using the given number of threads.")
+            ->check(CLI::Range(1, 64))
+            ->excludes(solver);
+
+        cli.add_option("--time", timeLimit, "")
+            ->description("The computer searches with the in-place search engine, deepening the search until the given number of "
+                          "milliseconds has passed.")
+            ->check(CLI::Range(1, 3600000))
+            ->excludes(solver);
+
+        cli.add_option("--table-size", tableSize, "")
+            ->description("The computer's transposition table uses at most the given number of megabytes.")
+            ->check(CLI::Range(1, 65536))
+            ->excludes(solver);
+
+        cli.add_flag("--huge-pages", hugePages, "")
+            ->description("The in-place search engine's transposition table is backed by huge pages, if the system has them.")
+            ->excludes(solver);
+
+        cli.add_option("--snapshot", snapshot, "")
+            ->description("The computer searches with the in-place search engine. Its transposition table is loaded from the given "
+                          "file, if it exists, and saved to it when the game is over.")
+            ->excludes(solver);
+
+        cli.add_option("--big", big, "")
+            ->description("Instead of playing a game, read a Big Nim board from the given file (or '-' for the standard input) "
+                          "and print the winning move. The board is a list of heap sizes separated by white space. There can be "
+                          "any number of heaps, and each one can have up to 18446744073709551615 objects.")
+            ->excludes(solver);
+
+        auto * batchOption = cli.add_option("--batch", batch, "");
+        batchOption
+            ->description("Instead of playing a game, analyze the positions listed in the given file (or '-' for the standard "
+                          "input), one per line, and write the results as JSON lines. Each position is the variation (misere, "
+                          "normal, subtraction:<k> for removing 1 to k objects, or subtraction:{<a>,<b>,...} for removing a, b, "
+                          "... objects), the player to move (first or second), and the sizes of the heaps.")
+            ->excludes(solver);
+
+        cli.add_option("--jobs, -j", jobs, "")
+            ->description("Number of positions analyzed at the same time by --batch. (default: number of cores)")
+            ->check(CLI::Range(1, 1024))
+            ->needs(batchOption);
+
+        cli.add_option("--depth", depth, "")
+            ->description("Maximum depth of the search of each position analyzed by --batch. (default 2)")
+            ->check(CLI::Range(1, NimSearch::MAX_DEPTH))
+            ->needs(batchOption);
+
+        cli.add_option("--telemetry", telemetry, "")
+            ->description("The statistics of each of the computer's moves are appended to the given file as one line of JSON.");
+
+        cli.add_option("--tablebase", tablebase, "")
+            ->description("The computer plays the winning moves stored in the given tablebase file, which is created by "
+                          "nim-tablebase, instead of searching for them.");
 
         cli.description("Play a game of Nim against the computer.");
         cli.callback(
             [&]()
             {
-                if (subtraction)
+                if (!octal.empty() && !OctalGame::isCode(octal))
+                {
+                    std::string message = "An octal code is 0. followed by 1 to " + std::to_string(OctalGame::MAX_DIGITS) +
+                                          " digits from 0 to 7, such as 0.77.";
+                    throw CLI::ValidationError(message);
+                }
+                if ((subtraction || !octal.empty()) && batch.empty() && (threads > 0 || timeLimit > 0 || !snapshot.empty()))
+                {
+                    throw CLI::ValidationError("The in-place search engine doesn't play the subtraction variation or octal "
+                                               "games, so --threads, --time and --snapshot can't be used with them.");
+                }
+                if (subtraction && subtractionSet.empty() && limits.empty())
                 {
                     if (!initial.empty() && initial.size() != 2)
                     {
@@ -81,6 +203,29 @@ int main(int argc, char * argv[])
                 }
                 else
                 {
+                    // With a subtraction set or limits, the setup is a list of heap sizes, as in the other variations
+                    for (int n : subtractionSet)
+                    {
+                        if (n < 1 || n > Board::MAX_OBJECTS)
+                        {
+                            std::string message = "The numbers of objects that can be removed must be between 1 and " +
+                                                  std::to_string(Board::MAX_OBJECTS) + ".";
+                            throw CLI::ValidationError(message);
+                        }
+                    }
+                    for (int n : limits)
+                    {
+                        if (n < 1 || n > Board::MAX_OBJECTS)
+                        {
+                            std::string message = "The maximum number of objects that can be removed must be between 1 and " +
+                                                  std::to_string(Board::MAX_OBJECTS) + ".";
+                            throw CLI::ValidationError(message);
+                        }
+                    }
+                    if (limits.size() > 1 && initial.size() != limits.size())
+                    {
+                        throw CLI::ValidationError("There must be a heap in the setup for each limit.");
+                    }
                     if (initial.size() > Board::MAX_HEAPS)
                     {
                         std::string message = "The maximum number of heaps is " + std::to_string(Board::MAX_HEAPS) + ".";
@@ -113,11 +258,33 @@ int main(int argc, char * argv[])
             rules                = Rules(Rules::Variation::NORMAL);
             initialConfiguration = initial.empty() ? std::vector<int8_t>{1, 3, 5, 7, 9} : initial;
         }
+        else if (subtraction && !subtractionSet.empty())
+        {
+            rules                = Rules(subtractionSet);
+            initialConfiguration = initial.empty() ? std::vector<int8_t>{21} : initial;
+        }
+        else if (subtraction && limits.size() > 1)
+        {
+            rules                = Rules(Rules::Variation::SUBTRACT, limits);
+            initialConfiguration = initial;
+        }
+        else if (subtraction && !limits.empty())
+        {
+            rules                = Rules(Rules::Variation::SUBTRACT, limits[0]);
+            initialConfiguration = initial.empty() ? std::vector<int8_t>{21} : initial;
+        }
         else if (subtraction)
         {
             rules                = Rules(Rules::Variation::SUBTRACT, initial.empty() ? 4 : initial[1]);
             initialConfiguration = initial.empty() ? std::vector<int8_t>{21} : std::vector<int8_t>{initial[0]};
         }
+        else if (!octal.empty())
+        {
+            // A Big Nim board can have heaps of any size, so more values are computed for it
+            uint64_t limit       = big.empty() ? Board::MAX_OBJECTS + 1 : OctalGame::DEFAULT_LIMIT;
+            rules                = Rules(Rules::Variation::OCTAL, octal, limit);
+            initialConfiguration = initial.empty() ? std::vector<int8_t>{20} : initial;
+        }
         else // if (misere)
         {
             rules                = Rules(Rules::Variation::MISERE);
@@ -125,12 +292,85 @@ int main(int argc, char * argv[])
         }
     }
 
+    if (!big.empty())
+        return analyzeBigBoard(big, rules);
+
+    if (!batch.empty())
+    {
+        // The positions list their own variations, and each one is searched in place
+        NimSearch::Settings settings;
+        settings.maxDepth = depth;
+        if (tableSize > 0)
+            settings.transpositionTableMegabytes = tableSize;
+        settings.hugePages = hugePages;
+        if (threads > 0)
+            settings.threads = threads;
+        if (timeLimit > 0)
+            settings.timeLimit = std::chrono::milliseconds(timeLimit);
+        return analyzeBatch(batch, settings, jobs);
+    }
+
+    // Every heap split off during the game must fit on the board
+    if (rules.octalGame() && rules.octalGame()->maxHeaps(Board(initialConfiguration)) > Board::MAX_HEAPS)
+    {
+        std::cerr << "The heaps can be split into more than " << Board::MAX_HEAPS << " heaps. Choose smaller heaps." << std::endl;
+        return 1;
+    }
+
     std::cout << std::endl;
 
     Board          initialBoard(initialConfiguration);
     NimState       state(initialBoard, rules);
     HumanPlayer    human(humanGoesFirst ? GameState::PlayerId::FIRST : GameState::PlayerId::SECOND, rules);
-    ComputerPlayer computer(humanGoesFirst ? GameState::PlayerId::SECOND : GameState::PlayerId::FIRST, rules);
+    ComputerPlayer::Engine engine = ComputerPlayer::Engine::SEARCH;
+    NimSearch::Settings    settings;
+    if (tableSize > 0)
+        settings.transpositionTableMegabytes = tableSize;
+    settings.hugePages = hugePages;
+    if (useSolver)
+    {
+        engine = ComputerPlayer::Engine::SOLVER;
+    }
+    else if (threads > 0 || timeLimit > 0 || !snapshot.empty())
+    {
+        engine = ComputerPlayer::Engine::IN_PLACE;
+        if (threads > 0)
+            settings.threads = threads;
+        if (timeLimit > 0)
+        {
+            settings.maxDepth  = NimSearch::MAX_DEPTH;
+            settings.timeLimit = std::chrono::milliseconds(timeLimit);
+        }
+    }
+    ComputerPlayer computer(humanGoesFirst ? GameState::PlayerId::SECOND : GameState::PlayerId::FIRST, rules, engine, settings);
+
+    if (!snapshot.empty() && std::ifstream(snapshot) && !computer.loadTranspositionTable(snapshot))
+        std::cerr << "The snapshot " << snapshot << " is not compatible and is ignored." << std::endl;
+
+    std::ofstream telemetryFile;
+    if (!telemetry.empty())
+    {
+        telemetryFile.open(telemetry, std::ios::app);
+        if (!telemetryFile)
+        {
+            std::cerr << "Unable to open " << telemetry << " for writing." << std::endl;
+            return 1;
+        }
+        computer.setTelemetry(&telemetryFile);
+    }
+
+    if (!tablebase.empty())
+    {
+        std::shared_ptr<Tablebase const> table = Tablebase::open(tablebase);
+        if (!table)
+        {
+            std::cerr << "Unable to open the tablebase " << tablebase << "." << std::endl;
+            return 1;
+        }
+        if (table->variation() != rules.variation())
+            std::cerr << "The tablebase " << tablebase << " is for a different variation and is ignored." << std::endl;
+        computer.setTablebase(table);
+    }
 
     while (!state.isGameOver())
     {
@@ -144,10 +384,15 @@ int main(int argc, char * argv[])
             computer.move(&state);
             assert(state.lastMove().has_value());
             NimState::Move move = state.lastMove().value();
-            if (rules.variation() == Rules::Variation::SUBTRACT)
+            if (state.board().size() == 1)
             {
                 std::cout << "The computer removed " << static_cast<int>(move.n) << std::endl;
             }
+            else if (move.split > 0)
+            {
+                std::cout << "The computer removed " << static_cast<int>(move.n) << " from heap " << char('A' + move.i)
+                          << " and split off " << static_cast<int>(move.split) << "." << std::endl;
+            }
             else
             {
                 std::cout << "The computer removed " << static_cast<int>(move.n) << " from heap " << char('A' + move.i) << "."
@@ -158,6 +403,9 @@ int main(int argc, char * argv[])
     // Game is over, display the final board state
     displayBoard(state.board(), rules);
 
+    if (!snapshot.empty() && !computer.saveTranspositionTable(snapshot))
+        std::cerr << "Unable to save the snapshot " << snapshot << "." << std::endl;
+
     assert(state.winner().has_value());
     if (state.winner().value() == human.playerId())
     {
@@ -173,7 +421,7 @@ int main(int argc, char * argv[])
 
 static void displayBoard(const Board & board, Rules const & rules)
 {
-    if (rules.variation() == Rules::Variation::SUBTRACT)
+    if (rules.variation() == Rules::Variation::SUBTRACT && board.size() == 1)
     {
         std::cout << "Remaining: " << board.heap(0) << std::endl;
     }
@@ -196,6 +444,94 @@ static void displayBoard(const Board & board, Rules const & rules)
             std::cout << " " << char('A' + i) << "  ";
         }
         std::cout << std::endl;
+
+        // Each heap's limit is shown under it, if the heaps have limits of their own
+        if (!rules.heapLimits().empty())
+        {
+            for (size_t i = 0; i < board.size(); ++i)
+            {
+                std::cout << std::setw(2) << rules.removalLimit(static_cast<int>(i)) << "  ";
+            }
+            std::cout << std::endl;
+        }
     }
     std::cout << std::endl;
 }
+
+static int analyzeBigBoard(std::string const & path, Rules const & rules)
+{
+    std::optional<BigBoard> board;
+    if (path == "-")
+    {
+        board = BigBoard::read(std::cin);
+    }
+    else
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            std::cerr << "Unable to open " << path << "." << std::endl;
+            return 1;
+        }
+        board = BigBoard::read(in);
+    }
+    if (!board)
+    {
+        std::cerr << "The board in " << path << " must be a list of heap sizes separated by white space." << std::endl;
+        return 1;
+    }
+
+    if (!rules.heapLimits().empty() && rules.heapLimits().size() != board->size())
+    {
+        std::cerr << "The board in " << path << " must have a heap for each limit." << std::endl;
+        return 1;
+    }
+
+    // The Grundy values of an octal game that is not known to be periodic are only known for smaller heaps
+    if (OctalGame const * octal = rules.octalGame())
+    {
+        auto unknown = std::find_if(board->begin(), board->end(), [octal](uint64_t n) { return !octal->isKnown(n); });
+        if (unknown != board->end())
+        {
+            std::cerr << "The Grundy values of " << octal->code() << " are not known for heaps of " << *unknown << " objects."
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    // Heaps are numbered from 1 in the output
+    std::optional<BigNimSolver::Move> move = BigNimSolver(rules).winningMove(*board);
+    if (move.has_value() && move->split > 0)
+        std::cout << "Win: remove " << move->n << " from heap " << move->i + 1 << " of " << board->size() << " and split off "
+                  << move->split << " into a new heap.\n";
+    else if (move.has_value())
+        std::cout << "Win: remove " << move->n << " from heap " << move->i + 1 << " of " << board->size() << ".\n";
+    else if (board->empty())
+        std::cout << "The game is over.\n";
+    else
+        std::cout << "Loss: every move loses against perfect play.\n";
+    return 0;
+}
+
+static int analyzeBatch(std::string const & path, NimSearch::Settings const & settings, int jobs)
+{
+    // The output is written in blocks, so it doesn't need to be synchronized with C I/O
+    std::ios::sync_with_stdio(false);
+
+    BatchAnalyzer analyzer(settings, jobs);
+    if (path == "-")
+    {
+        analyzer.run(std::cin, std::cout);
+    }
+    else
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            std::cerr << "Unable to open " << path << "." << std::endl;
+            return 1;
+        }
+        analyzer.run(in, std::cout);
+    }
+    return std::cout ? 0 : 1;
+}
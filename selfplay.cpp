@@ -0,0 +1,247 @@
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "ComputerPlayer/ComputerPlayer.h"
+#include "ComputerPlayer/SharedTranspositionTable.h"
+#include "NimState/NimState.h"
+
+#include <CLI/CLI.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace GamePlayer;
+
+namespace
+{
+
+// Results of the games played by one thread
+struct Results
+{
+    int                   games      = 0; // Number of games played
+    int                   firstWins  = 0; // Number of games won by the first player
+    uint64_t              moves      = 0; // Number of moves made
+    uint64_t              nodes      = 0; // Number of nodes searched
+    std::vector<uint32_t> latencies;      // Time taken by each move, in microseconds
+};
+
+// Plays games until there are none left, taking the next unplayed one each time
+void playGames(Rules const &               rules,
+               Board const &               board,
+               ComputerPlayer::Engine      engine,
+               NimSearch::Settings const & settings,
+               std::atomic<int> &          remaining,
+               Results &                   results)
+{
+    // The players are reused from game to game, as they would be by a server
+    ComputerPlayer first(NimState::PlayerId::FIRST, rules, engine, settings);
+    ComputerPlayer second(NimState::PlayerId::SECOND, rules, engine, settings);
+
+    while (remaining-- > 0)
+    {
+        // Each game starts from scratch, as a new game against a new opponent would. A shared table is kept, but its entries
+        // from earlier games are replaced first.
+        first.clearTranspositionTable();
+        second.clearTranspositionTable();
+        if (settings.sharedTable)
+            settings.sharedTable->age();
+
+        NimState state(board, rules);
+        while (!state.isGameOver())
+        {
+            ComputerPlayer & player = (state.whoseTurn() == NimState::PlayerId::FIRST) ? first : second;
+            auto             start  = std::chrono::steady_clock::now();
+            player.move(&state);
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            results.latencies.push_back(
+                static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+            results.nodes += player.nodesSearched();
+            ++results.moves;
+        }
+        assert(state.winner().has_value());
+        if (state.winner().value() == NimState::PlayerId::FIRST)
+            ++results.firstWins;
+        ++results.games;
+    }
+}
+
+// Returns the given percentile of a sorted list of values
+uint32_t percentile(std::vector<uint32_t> const & sorted, double p)
+{
+    assert(!sorted.empty());
+    size_t i = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+} // anonymous namespace
+
+int main(int argc, char * argv[])
+{
+    int                    games    = 100; // Number of games to play
+    int                    jobs     = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int8_t>    initialConfiguration;
+    Rules                  rules;
+    ComputerPlayer::Engine engine = ComputerPlayer::Engine::SEARCH;
+    NimSearch::Settings    settings;
+
+    {
+        CLI::App            cli;
+        bool                misere      = true;
+        bool                normal      = false;
+        bool                subtraction = false;
+        bool                search      = true;
+        bool                inPlace     = false;
+        bool                solver      = false;
+        int                 timeLimit   = 0;
+        int                 tableSize   = 0;
+        bool                sharedTable = false;
+        std::vector<int8_t> initial;
+
+        cli.add_option("--games, -n", games, "Number of games to play (default 100)")->check(CLI::Range(1, 100000000));
+        cli.add_option("--jobs, -j", jobs, "Number of games played at the same time (default: number of cores)")
+            ->check(CLI::Range(1, 1024));
+
+        auto * variations = cli.add_option_group("Game variation", "Choose the variation of Nim to play");
+        variations->add_flag("--misere", misere, "")
+            ->description("(default) Play the misre variation. The default setup is 1 3 5 7 9.");
+        variations->add_flag("--normal", normal, "")->description("Play the normal variation. The default setup is 1 3 5 7 9.");
+        variations->add_flag("--subtraction", subtraction, "")
+            ->description("Play the subtraction variation. The default setup is 21 4.");
+        variations->require_option(0, 1);
+
+        cli.add_option("--initial, -i", initial, "Initial configuration")
+            ->description("For the misre and normal variations, a list of heap sizes. For the subtraction variation, the size "
+                          "of the heap followed by the maximum number of objects that can be removed.");
+
+        auto * engines = cli.add_option_group("Engine", "Choose how the computer players choose their moves");
+        engines->add_flag("--search", search, "(default) Search the game tree.");
+        engines->add_flag("--in-place", inPlace, "Search the game tree in place.");
+        engines->add_flag("--solver", solver, "Compute the moves directly from the nim-sum.");
+        engines->require_option(0, 1);
+
+        cli.add_option("--depth", settings.maxDepth, "Maximum search depth (default 10)")
+            ->check(CLI::Range(1, NimSearch::MAX_DEPTH));
+        auto * threads =
+            cli.add_option("--threads", settings.threads, "Number of threads used by each in-place search (default 1)");
+        threads->check(CLI::Range(1, 64));
+        cli.add_option("--time", timeLimit, "Time budget for each move of an in-place search, in milliseconds")
+            ->check(CLI::Range(1, 3600000));
+        cli.add_option("--table-size", tableSize, "Memory budget for each player's transposition table, in megabytes (default 2)")
+            ->check(CLI::Range(1, 65536));
+        cli.add_flag("--huge-pages", settings.hugePages, "Back the in-place search's transposition tables with huge pages.");
+        cli.add_option("--seed", settings.seed, "Seed of the solver's moves in lost positions, so that a run can be repeated");
+        cli.add_flag("--shared-table", sharedTable, "")
+            ->description("Give every player one shared transposition table of the table size, kept from game to game. Implies "
+                          "--in-place.");
+
+        cli.description("Play games of Nim between two computer players and report the throughput and latency.");
+        cli.callback(
+            [&]()
+            {
+                if (subtraction && (inPlace || threads->count() > 0 || timeLimit > 0 || sharedTable))
+                {
+                    throw CLI::ValidationError("The subtraction variation is played by the solver, so --in-place, --threads, "
+                                               "--time and --shared-table can't be used with it.");
+                }
+                if (subtraction && !initial.empty() && initial.size() != 2)
+                    throw CLI::ValidationError("The correct setup for the subtraction variation is '--initial N k'.");
+                if (initial.size() > Board::MAX_HEAPS)
+                    throw CLI::ValidationError("The maximum number of heaps is " + std::to_string(Board::MAX_HEAPS) + ".");
+                for (auto n : initial)
+                {
+                    if (n < 1 || n > Board::MAX_OBJECTS)
+                    {
+                        throw CLI::ValidationError("The number of objects in each heap must be between 1 and " +
+                                                   std::to_string(Board::MAX_OBJECTS) + ".");
+                    }
+                }
+            });
+        CLI11_PARSE(cli, argc, argv);
+
+        if (normal)
+        {
+            rules                = Rules(Rules::Variation::NORMAL);
+            initialConfiguration = initial.empty() ? std::vector<int8_t>{1, 3, 5, 7, 9} : initial;
+        }
+        else if (subtraction)
+        {
+            rules                = Rules(Rules::Variation::SUBTRACT, initial.empty() ? 4 : initial[1]);
+            initialConfiguration = initial.empty() ? std::vector<int8_t>{21} : std::vector<int8_t>{initial[0]};
+        }
+        else // if (misere)
+        {
+            rules                = Rules(Rules::Variation::MISERE);
+            initialConfiguration = initial.empty() ? std::vector<int8_t>{1, 3, 5, 7, 9} : initial;
+        }
+
+        if (solver)
+            engine = ComputerPlayer::Engine::SOLVER;
+        else if (inPlace || timeLimit > 0 || sharedTable)
+            engine = ComputerPlayer::Engine::IN_PLACE;
+
+        if (timeLimit > 0)
+            settings.timeLimit = std::chrono::milliseconds(timeLimit);
+        if (tableSize > 0)
+            settings.transpositionTableMegabytes = tableSize;
+        if (sharedTable)
+        {
+            settings.sharedTable = std::make_shared<SharedTranspositionTable>(settings.transpositionTableMegabytes * 1024 * 1024,
+                                                                              settings.hugePages);
+        }
+    }
+
+    Board                board(initialConfiguration);
+    std::atomic<int>     remaining(games);
+    std::vector<Results> results(std::min(jobs, games));
+
+    auto                     start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(results.size());
+    for (auto & r : results)
+    {
+        threads.emplace_back(playGames, std::cref(rules), std::cref(board), engine, std::cref(settings), std::ref(remaining),
+                             std::ref(r));
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Combine the results of all the threads
+    Results total;
+    for (auto const & r : results)
+    {
+        total.games += r.games;
+        total.firstWins += r.firstWins;
+        total.moves += r.moves;
+        total.nodes += r.nodes;
+        total.latencies.insert(total.latencies.end(), r.latencies.begin(), r.latencies.end());
+    }
+    std::sort(total.latencies.begin(), total.latencies.end());
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Games:              " << total.games << std::endl;
+    std::cout << "Moves:              " << total.moves << std::endl;
+    std::cout << "Threads:            " << results.size() << std::endl;
+    std::cout << "Elapsed:            " << std::setprecision(3) << seconds << " s" << std::setprecision(1) << std::endl;
+    std::cout << "Games/second:       " << total.games / seconds << std::endl;
+    // The subtraction variation is always played by the solver, which doesn't search
+    if (engine != ComputerPlayer::Engine::SOLVER && rules.variation() != Rules::Variation::SUBTRACT)
+        std::cout << "Nodes/second:       " << total.nodes / seconds << std::endl;
+    std::cout << "First player wins:  " << total.firstWins << " (" << 100.0 * total.firstWins / total.games << "%)" << std::endl;
+    if (!total.latencies.empty())
+    {
+        std::cout << "Move latency (us):  p50 " << percentile(total.latencies, 50) << ", p90 " << percentile(total.latencies, 90)
+                  << ", p99 " << percentile(total.latencies, 99) << ", max " << total.latencies.back() << std::endl;
+    }
+
+    return 0;
+}
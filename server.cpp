@@ -0,0 +1,55 @@
+#include "ComputerPlayer/NimSearch.h"
+#include "Server/MoveServer.h"
+
+#include <CLI/CLI.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+int main(int argc, char * argv[])
+{
+    MoveServer::Settings settings;
+    settings.port            = 7777;
+    settings.search.maxDepth = 2; // Shallow searches keep each move fast when many games are played at once
+
+    {
+        CLI::App cli;
+        int      timeLimit = 0;
+        int      tableSize = 0;
+
+        cli.add_option("--port, -p", settings.port, "TCP port to listen on, on the loopback address (default 7777)");
+        cli.add_option("--unix", settings.unixPath, "Listen on a Unix socket at this path instead of a TCP port");
+        cli.add_option("--workers, -w", settings.workers, "Number of threads searching for moves (default 1)")
+            ->check(CLI::Range(1, 1024));
+        cli.add_option("--depth", settings.search.maxDepth, "Maximum search depth (default 2)")->check(CLI::Range(1, 64));
+        cli.add_option("--time", timeLimit, "Time budget for each move, in milliseconds")->check(CLI::Range(1, 3600000));
+        cli.add_option("--table-size", tableSize, "Memory budget for each worker's transposition tables, in megabytes (default 2)")
+            ->check(CLI::Range(1, 65536));
+        cli.add_flag("--shared-tables", settings.sharedTables, "")
+            ->description("The workers share one transposition table for each variation, as large as all of theirs would be.");
+
+        cli.description("Serve the computer's moves in many games of Nim at once to clients on this machine.");
+        CLI11_PARSE(cli, argc, argv);
+
+        if (timeLimit > 0)
+            settings.search.timeLimit = std::chrono::milliseconds(timeLimit);
+        if (tableSize > 0)
+            settings.search.transpositionTableMegabytes = tableSize;
+    }
+
+    MoveServer  server(settings);
+    std::string error = server.listen();
+    if (!error.empty())
+    {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    if (settings.unixPath.empty())
+        std::cout << "Listening on 127.0.0.1:" << server.port() << std::endl;
+    else
+        std::cout << "Listening on " << settings.unixPath << std::endl;
+
+    server.run();
+    return 0;
+}
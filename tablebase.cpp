@@ -0,0 +1,57 @@
+#include "Components/Board.h"
+#include "Components/Rules.h"
+#include "ComputerPlayer/Tablebase.h"
+
+#include <CLI/CLI.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+int main(int argc, char * argv[])
+{
+    Rules       rules;
+    int         maxHeaps   = 5; // Covers the default setup, 1 3 5 7 9
+    int         maxObjects = 9;
+    std::string output;
+
+    {
+        CLI::App cli;
+        bool     misere = true;
+        bool     normal = false;
+
+        auto * variations = cli.add_option_group("Game variation", "Choose the variation of Nim to solve");
+        variations->add_flag("--misere", misere, "(default) Solve the misre variation.");
+        variations->add_flag("--normal", normal, "Solve the normal variation.");
+        variations->require_option(0, 1);
+
+        cli.add_option("--heaps", maxHeaps, "Maximum number of non-empty heaps in a covered position (default 5)")
+            ->check(CLI::Range(1, Board::MAX_HEAPS));
+        cli.add_option("--objects", maxObjects, "Maximum number of objects in a heap in a covered position (default 9)")
+            ->check(CLI::Range(1, Board::MAX_OBJECTS));
+        cli.add_option("--output, -o", output, "Tablebase file to write")->required();
+
+        cli.description("Solve every position up to a given size and write the results to a tablebase file.");
+        CLI11_PARSE(cli, argc, argv);
+
+        rules = Rules(normal ? Rules::Variation::NORMAL : Rules::Variation::MISERE);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!Tablebase::generate(output, rules, maxHeaps, maxObjects))
+    {
+        std::cerr << "Unable to generate " << output << "." << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto tablebase = Tablebase::open(output);
+    if (!tablebase)
+    {
+        std::cerr << "Unable to open " << output << " after writing it." << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << output << " (" << maxHeaps << " heaps of up to " << maxObjects << " objects) in " << seconds
+              << " seconds." << std::endl;
+    return 0;
+}